@@ -0,0 +1,304 @@
+"""This module contains NumPy views of genes. Views share memory with the C
+structures (and with the mmap'd pool file, if the pool was read from it), so
+no gene is copied or decoded one by one through ctypes.
+"""
+
+import math
+import ctypes
+import typing
+import collections
+
+import numpy
+
+from . import definitions
+from . import errors
+
+
+DecodedGenes = collections.namedtuple(
+    "DecodedGenes",
+    [
+        "outcome_node_id",
+        "income_node_id",
+        "connection_type",
+        "weight_unnormalized",
+        "weight"
+    ]
+)
+"""Genes decoded into separate arrays (one per member of C struct gene). All
+the arrays have the shape of the given gene bytes without the last axis.
+"""
+
+
+def _address_of(pointer) -> int:
+    return ctypes.cast(pointer, ctypes.c_void_p).value
+
+
+def _view_memory(
+    address: int, size: int, owner: typing.Any, writeable: bool
+) -> numpy.ndarray:
+    """Returns one-dimensional uint8 array for `size` bytes at `address`.
+
+    Arguments:
+        owner: any; An object which keeps the memory alive. It won't be
+            collected while any view of the memory exists.
+        writeable: bool; Whether the array may be changed.
+    """
+    if size == 0:
+        return numpy.empty((0, ), dtype=numpy.uint8)
+
+    buffer = (definitions.c_uint8 * size).from_address(address)
+    buffer._owner = owner
+
+    # the buffer becomes the base of the array
+    array = numpy.frombuffer(buffer, dtype=numpy.uint8)
+    array.flags.writeable = writeable
+
+    return array
+
+
+def genome_genes(genome, writeable: bool = False) -> numpy.ndarray:
+    """Returns view of genome genes with the shape (length, gene_bytes_size).
+
+    Arguments:
+        genome: pool.Genome
+        writeable: bool, default = False; If True, changes of the array will
+            change the genome. Don't set it for the pool which was read from
+            the file opened for reading only.
+    """
+    struct = genome.struct
+    gene_bytes_size = genome.pool.gene_bytes_size
+
+    array = _view_memory(
+        _address_of(struct.genes),
+        struct.length * gene_bytes_size,
+        owner=genome,
+        writeable=writeable)
+
+    return array.reshape((struct.length, gene_bytes_size))
+
+
+def pool_genes(pool, writeable: bool = False) -> numpy.ndarray:
+    """Returns view of genes of all the genomes with the shape
+    (organisms_number, length, gene_bytes_size).
+
+    Such view is possible only when genomes have the same length and lie in
+    memory with the same step (see get_genes_stride in pickler.h), which is the
+    case for pools generated with the same genome size.
+
+    Arguments:
+        pool: pool.GenePool
+        writeable: bool, default = False; Same as for `genome_genes`.
+
+    Raises:
+        ValueError if genes of the pool do not form a dense block.
+    """
+    organisms_number = len(pool)
+    gene_bytes_size = pool.gene_bytes_size
+
+    if not organisms_number:
+        return numpy.empty((0, 0, gene_bytes_size), dtype=numpy.uint8)
+
+    genomes = ctypes.cast(
+        pool.genome_structs_vector, definitions.libc.genome_p_p)
+
+    stride = definitions.libc.get_genes_stride(
+        pool.struct_ref, genomes, organisms_number)
+    errors.check_errors()
+
+    if stride == 0:
+        raise ValueError(
+            "genomes have different lengths or are not evenly spaced, use "
+            "`genome_genes` for every genome instead")
+
+    first = pool.genomes[0].struct
+    length = first.length
+
+    block = _view_memory(
+        _address_of(first.genes),
+        stride * (organisms_number - 1) + length * gene_bytes_size,
+        owner=pool,
+        writeable=writeable)
+
+    return numpy.lib.stride_tricks.as_strided(
+        block,
+        shape=(organisms_number, length, gene_bytes_size),
+        strides=(stride, gene_bytes_size, 1),
+        writeable=writeable)
+
+
+def weight_dtype(pool) -> numpy.dtype:
+    """Returns float32 if it keeps normalized weights of the pool as precise
+    as float64 does (the weight part has no more than 24 bits), and float64
+    otherwise.
+    """
+    if definitions.libc.float_weights_are_lossless(pool.struct_ref):
+        return numpy.dtype(numpy.float32)
+    return numpy.dtype(numpy.float64)
+
+
+def decode_genes(
+    pool, genes: numpy.ndarray,
+    dtype: typing.Optional[numpy.dtype] = None
+) -> DecodedGenes:
+    """Decodes gene bytes into separate arrays in one C call.
+
+    Arguments:
+        pool: pool.GenePool
+        genes: numpy.ndarray; Array of uint8 with the last axis of
+            pool.gene_bytes_size, i.e. any array returned by `genome_genes` or
+            `pool_genes`. Non-contiguous arrays will be copied first.
+        dtype: numpy.float32 or numpy.float64; Type of normalized weights.
+            None means `weight_dtype(pool)`.
+    """
+    dtype = weight_dtype(pool) if dtype is None else numpy.dtype(dtype)
+    if dtype not in (numpy.float32, numpy.float64):
+        raise ValueError("`dtype` should be float32 or float64")
+
+    gene_bytes_size = pool.gene_bytes_size
+
+    if genes.shape[-1:] != (gene_bytes_size, ):
+        raise ValueError(
+            f"last axis of `genes` should have size {gene_bytes_size}")
+
+    genes = numpy.ascontiguousarray(genes, dtype=numpy.uint8)
+    shape = genes.shape[:-1]
+    genes_number = math.prod(shape)
+
+    decoded = DecodedGenes(
+        outcome_node_id=numpy.empty(shape, dtype=numpy.uint64),
+        income_node_id=numpy.empty(shape, dtype=numpy.uint64),
+        connection_type=numpy.empty(shape, dtype=numpy.uint8),
+        weight_unnormalized=numpy.empty(shape, dtype=numpy.int64),
+        weight=numpy.empty(shape, dtype=dtype)
+    )
+
+    if genes_number == 0:
+        return decoded
+
+    if dtype == numpy.float32:
+        decode, weight_type = (
+            definitions.libc.decode_genes_float, ctypes.c_float)
+    else:
+        decode, weight_type = (
+            definitions.libc.decode_genes, ctypes.c_double)
+
+    decode(
+        pool.struct_ref,
+        genes.ctypes.data_as(definitions.c_uint8_p),
+        genes_number,
+        decoded.outcome_node_id.ctypes.data_as(
+            ctypes.POINTER(definitions.c_uint64)),
+        decoded.income_node_id.ctypes.data_as(
+            ctypes.POINTER(definitions.c_uint64)),
+        decoded.connection_type.ctypes.data_as(definitions.c_uint8_p),
+        decoded.weight_unnormalized.ctypes.data_as(
+            ctypes.POINTER(ctypes.c_int64)),
+        decoded.weight.ctypes.data_as(ctypes.POINTER(weight_type)))
+    errors.check_errors()
+
+    return decoded
+
+
+def _encoder_arguments(
+    outcome_node_id: numpy.ndarray,
+    income_node_id: numpy.ndarray,
+    weight_unnormalized: numpy.ndarray,
+    connection_type: typing.Optional[numpy.ndarray]
+) -> typing.Tuple[typing.Tuple[int, ...], list, list]:
+    """Returns the common shape of the arrays, contiguous copies of them (to be
+    kept alive during the call) and ctypes pointers for encode_genes.
+    """
+    shape = outcome_node_id.shape
+
+    arrays = [
+        numpy.ascontiguousarray(outcome_node_id, dtype=numpy.uint64),
+        numpy.ascontiguousarray(income_node_id, dtype=numpy.uint64),
+        None if connection_type is None
+        else numpy.ascontiguousarray(connection_type, dtype=numpy.uint8),
+        numpy.ascontiguousarray(weight_unnormalized, dtype=numpy.int64)
+    ]
+
+    for array in arrays:
+        if array is not None and array.shape != shape:
+            raise ValueError("all the arrays should have the same shape")
+
+    pointers = [
+        arrays[0].ctypes.data_as(ctypes.POINTER(definitions.c_uint64)),
+        arrays[1].ctypes.data_as(ctypes.POINTER(definitions.c_uint64)),
+        None if arrays[2] is None
+        else arrays[2].ctypes.data_as(definitions.c_uint8_p),
+        arrays[3].ctypes.data_as(ctypes.POINTER(ctypes.c_int64)),
+        None
+    ]
+
+    return shape, arrays, pointers
+
+
+def encode_genes(
+    pool,
+    outcome_node_id: numpy.ndarray,
+    income_node_id: numpy.ndarray,
+    weight_unnormalized: numpy.ndarray,
+    connection_type: typing.Optional[numpy.ndarray] = None
+) -> numpy.ndarray:
+    """Encodes genes from separate arrays in one C call, the opposite of
+    `decode_genes`.
+
+    Arguments:
+        pool: pool.GenePool
+        outcome_node_id, income_node_id, weight_unnormalized: numpy.ndarray;
+            Arrays of the same shape, as returned by `decode_genes`.
+        connection_type: optional numpy.ndarray; If given, node ids are
+            relative to the ranges of their types (as `decode_genes` returns
+            them), otherwise they are written as they are.
+
+    Returns:
+        numpy.ndarray; Array of uint8 with the shape of the arguments and the
+            last axis of pool.gene_bytes_size.
+    """
+    shape, arrays, pointers = _encoder_arguments(
+        outcome_node_id, income_node_id, weight_unnormalized, connection_type)
+    genes_number = math.prod(shape)
+
+    genes = numpy.zeros(shape + (pool.gene_bytes_size, ), dtype=numpy.uint8)
+
+    if genes_number == 0:
+        return genes
+
+    definitions.libc.encode_genes(
+        pool.struct_ref,
+        genes.ctypes.data_as(definitions.c_uint8_p),
+        genes_number,
+        *pointers)
+    errors.check_errors()
+
+    return genes
+
+
+def write_genome_genes(
+    genome,
+    first_gene: int,
+    outcome_node_id: numpy.ndarray,
+    income_node_id: numpy.ndarray,
+    weight_unnormalized: numpy.ndarray,
+    connection_type: typing.Optional[numpy.ndarray] = None
+):
+    """Encodes genes straight into the genome starting from `first_gene`. The
+    genome is marked as changed, so it is written by the next save of the pool
+    with dirty data only.
+
+    Arguments:
+        genome: pool.Genome
+        first_gene: int; Index of the first gene to overwrite.
+        Others are the same as for `encode_genes`.
+    """
+    shape, arrays, pointers = _encoder_arguments(
+        outcome_node_id, income_node_id, weight_unnormalized, connection_type)
+
+    definitions.libc.encode_genome_genes(
+        genome.pool.struct_ref,
+        genome.struct_ref,
+        first_gene,
+        math.prod(shape),
+        *pointers)
+    errors.check_errors()
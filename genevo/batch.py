@@ -0,0 +1,423 @@
+"""This module contains functions processing the whole population with a single
+call into the C library. ctypes releases the GIL while the call runs, so a
+Python driver can run generations in one thread while other threads do I/O or
+logging.
+"""
+
+import ctypes
+import typing
+
+import numpy
+
+from . import definitions
+from . import errors
+from . import arrays
+
+
+def _genomes_vector(pool) -> definitions.libc.genome_p_p:
+    return ctypes.cast(pool.genome_structs_vector, definitions.libc.genome_p_p)
+
+
+def _as_pointer(array: numpy.ndarray, ctype):
+    return array.ctypes.data_as(ctypes.POINTER(ctype))
+
+
+def decode_population(
+    pool, threads_number: int = 0,
+    dtype: typing.Optional[numpy.dtype] = None
+) -> typing.Tuple[numpy.ndarray, arrays.DecodedGenes]:
+    """Decodes genes of all the genomes with `threads_number` threads (0 means
+    the number of CPUs). Normalized weights have type `dtype` (see
+    arrays.decode_genes).
+
+    Returns:
+        offsets: numpy.ndarray of uint64 with len(pool) + 1 items; Genes of
+            genome `i` are items [offsets[i]; offsets[i + 1]) of decoded
+            arrays.
+        decoded: arrays.DecodedGenes; Genes of all the genomes one after
+            another.
+    """
+    dtype = arrays.weight_dtype(pool) if dtype is None else numpy.dtype(dtype)
+    if dtype not in (numpy.float32, numpy.float64):
+        raise ValueError("`dtype` should be float32 or float64")
+
+    organisms_number = len(pool)
+    genomes = _genomes_vector(pool)
+
+    offsets = numpy.empty((organisms_number + 1, ), dtype=numpy.uint64)
+    genes_number = definitions.libc.count_population_genes(
+        genomes, organisms_number, _as_pointer(offsets, ctypes.c_uint64))
+
+    decoded = arrays.DecodedGenes(
+        outcome_node_id=numpy.empty((genes_number, ), dtype=numpy.uint64),
+        income_node_id=numpy.empty((genes_number, ), dtype=numpy.uint64),
+        connection_type=numpy.empty((genes_number, ), dtype=numpy.uint8),
+        weight_unnormalized=numpy.empty((genes_number, ), dtype=numpy.int64),
+        weight=numpy.empty((genes_number, ), dtype=dtype)
+    )
+
+    if dtype == numpy.float32:
+        decode, weight_type = (
+            definitions.libc.decode_population_float, ctypes.c_float)
+    else:
+        decode, weight_type = (
+            definitions.libc.decode_population, ctypes.c_double)
+
+    decode(
+        pool.struct_ref, genomes, organisms_number,
+        _as_pointer(offsets, ctypes.c_uint64),
+        _as_pointer(decoded.outcome_node_id, ctypes.c_uint64),
+        _as_pointer(decoded.income_node_id, ctypes.c_uint64),
+        _as_pointer(decoded.connection_type, ctypes.c_uint8),
+        _as_pointer(decoded.weight_unnormalized, ctypes.c_int64),
+        _as_pointer(decoded.weight, weight_type),
+        threads_number)
+    errors.check_errors()
+
+    return offsets, decoded
+
+
+def mutate_population(
+    pool,
+    change_genes_prob: float,
+    mutation_mode: "definitions.libc.gene_mutation_mode",
+    flip_bits_prob: float
+):
+    """Mutates every genome of the pool in place.
+    """
+    definitions.libc.mutate_population(
+        pool.struct_ref, _genomes_vector(pool), len(pool),
+        change_genes_prob, mutation_mode, flip_bits_prob)
+    errors.check_errors()
+
+
+def run_generation(
+    parents,
+    children,
+    fitness: numpy.ndarray,
+    survivors_number: int,
+    replication_type: int,
+    blend_coefficient: float,
+    change_genes_prob: float,
+    mutation_mode: "definitions.libc.gene_mutation_mode",
+    flip_bits_prob: float,
+    redraws_number: int = 0
+):
+    """Writes the next generation of `parents` into genomes of `children`.
+
+    `survivors_number` fittest parents are crossed over (by
+    `replication_type` parents per child) and their children are mutated.
+    Both pools should have the same number of genomes, so they can be swapped
+    after every generation.
+
+    Children identical to another child are bred again at most
+    `redraws_number` times, so fewer evaluations are wasted on duplicates.
+
+    Arguments:
+        fitness: numpy.ndarray; Fitness of every parent, bigger is better.
+    """
+    organisms_number = len(parents)
+
+    if len(children) != organisms_number:
+        raise ValueError("`parents` and `children` should have the same size")
+
+    fitness = numpy.ascontiguousarray(fitness, dtype=numpy.float64)
+
+    if fitness.shape != (organisms_number, ):
+        raise ValueError("`fitness` should have a value for every parent")
+
+    definitions.libc.run_generation(
+        parents.struct_ref,
+        _genomes_vector(parents), _genomes_vector(children),
+        organisms_number,
+        _as_pointer(fitness, ctypes.c_double),
+        survivors_number,
+        replication_type, blend_coefficient,
+        change_genes_prob, mutation_mode, flip_bits_prob, redraws_number)
+    errors.check_errors()
+
+
+def find_duplicates(pool, threads_number: int = 0) -> numpy.ndarray:
+    """Finds identical genomes by their genes and residue.
+
+    Returns:
+        numpy.ndarray of uint64 with len(pool) items; Index of the first genome
+            identical to the given one, so unique genomes refer to themselves.
+    """
+    groups = numpy.empty((len(pool), ), dtype=numpy.uint64)
+
+    definitions.libc.find_duplicates(
+        pool.struct_ref, _genomes_vector(pool), len(pool),
+        _as_pointer(groups, ctypes.c_uint64), threads_number)
+    errors.check_errors()
+
+    return groups
+
+
+def distance_matrix(pool, threads_number: int = 0) -> numpy.ndarray:
+    """Returns matrix of Hamming distances between genes of every two genomes
+    with the shape (len(pool), len(pool)).
+    """
+    organisms_number = len(pool)
+    matrix = numpy.empty(
+        (organisms_number, organisms_number), dtype=numpy.uint64)
+
+    definitions.libc.distance_matrix(
+        pool.struct_ref, _genomes_vector(pool), organisms_number,
+        _as_pointer(matrix, ctypes.c_uint64), threads_number)
+    errors.check_errors()
+
+    return matrix
+
+
+def sample_diversity(
+    pool, samples_number: int, threads_number: int = 0
+) -> typing.Tuple[float, float]:
+    """Estimates the mean share of different bits between two genomes of the
+    pool from `samples_number` random pairs.
+
+    Returns:
+        mean: float
+        standard_error: float
+    """
+    standard_error = ctypes.c_double()
+
+    mean = definitions.libc.sample_diversity(
+        pool.struct_ref, _genomes_vector(pool), len(pool), samples_number,
+        ctypes.byref(standard_error), threads_number)
+    errors.check_errors()
+
+    return mean, standard_error.value
+
+
+def similar_pairs(
+    pool,
+    threshold: float,
+    signature_size: int = 128,
+    bands_number: int = 32,
+    threads_number: int = 0
+) -> numpy.ndarray:
+    """Finds pairs of genomes with similar sets of edges using MinHash
+    signatures and the LSH index (see similarity.h), without comparing all the
+    pairs.
+
+    Arguments:
+        threshold: float; Minimum estimated Jaccard index of edge sets.
+        signature_size: int, default = 128; Bigger signatures give more precise
+            estimates.
+        bands_number: int, default = 32; More bands find less similar pairs.
+
+    Returns:
+        numpy.ndarray of uint64 with the shape (pairs_number, 2).
+    """
+    index = definitions.libc.build_lsh_index(
+        pool.struct_ref, _genomes_vector(pool), len(pool),
+        signature_size, bands_number, threads_number)
+    errors.check_errors()
+
+    try:
+        pairs = numpy.empty((len(pool), 2), dtype=numpy.uint64)
+        while True:
+            pairs_number = definitions.libc.lsh_similar_pairs(
+                index, threshold,
+                _as_pointer(pairs, ctypes.c_uint64), len(pairs))
+            errors.check_errors()
+            if pairs_number <= len(pairs):
+                return pairs[:pairs_number]
+            pairs = numpy.empty((pairs_number, 2), dtype=numpy.uint64)
+    finally:
+        definitions.libc.destroy_lsh_index(index)
+
+
+def allele_frequencies(
+    pool, threads_number: int = 0
+) -> typing.Tuple[numpy.ndarray, numpy.ndarray]:
+    """Counts, for every bit position of the gene area, the share of genomes
+    having the bit set (see alleles.h). Genomes shorter than the position are
+    not counted.
+
+    Returns:
+        frequencies: numpy.ndarray of float64
+        entropies: numpy.ndarray of float64; Binary entropy of every
+            frequency, entropies close to 0 mean the bit has converged.
+    """
+    genomes = _genomes_vector(pool)
+    positions_number = definitions.libc.count_allele_positions(
+        pool.struct_ref, genomes, len(pool))
+
+    frequencies = numpy.zeros((positions_number, ), dtype=numpy.float64)
+    entropies = numpy.zeros((positions_number, ), dtype=numpy.float64)
+
+    definitions.libc.allele_frequencies(
+        pool.struct_ref, genomes, len(pool), None,
+        _as_pointer(frequencies, ctypes.c_double),
+        _as_pointer(entropies, ctypes.c_double),
+        threads_number)
+    errors.check_errors()
+
+    return frequencies, entropies
+
+
+class Speciation:
+    """Species of the population kept across generations (see speciation.h).
+    Organisms are split into species by the share of different bits of their
+    genes, and every species breeds its children from its own members.
+
+    Arguments:
+        compatibility_threshold: float; Maximum share of different bits of an
+            organism and the representative of its species.
+        stagnation_limit: int, default = 0; Species not improving for this
+            number of generations get no children, 0 means no limit.
+    """
+
+    def __init__(
+        self, compatibility_threshold: float, stagnation_limit: int = 0
+    ):
+        self._struct_ref = definitions.libc.create_speciation(
+            compatibility_threshold, stagnation_limit)
+        errors.check_errors()
+
+    def __del__(self):
+        if getattr(self, "_struct_ref", None):
+            definitions.libc.destroy_speciation(self._struct_ref)
+
+    def __len__(self):
+        return self._struct_ref.contents.species_number
+
+    def __repr__(self):
+        return f"<Speciation with {len(self)} species>"
+
+    def speciate(self, pool, threads_number: int = 0):
+        """Assigns genomes of the pool to species without breeding them.
+        """
+        definitions.libc.speciate_population(
+            self._struct_ref, pool.struct_ref, _genomes_vector(pool),
+            len(pool), threads_number)
+        errors.check_errors()
+
+    def run_generation(
+        self,
+        parents,
+        children,
+        fitness: numpy.ndarray,
+        survival_rate: float,
+        replication_type: int,
+        blend_coefficient: float,
+        change_genes_prob: float,
+        mutation_mode: "definitions.libc.gene_mutation_mode",
+        flip_bits_prob: float,
+        threads_number: int = 0
+    ):
+        """Writes the next generation of `parents` into genomes of `children`
+        like batch.run_generation does, but children are bred inside species.
+
+        Arguments:
+            fitness: numpy.ndarray; Fitness of every parent, bigger is better.
+            survival_rate: float; Share of the fittest members of every
+                species used as parents.
+        """
+        organisms_number = len(parents)
+
+        if len(children) != organisms_number:
+            raise ValueError(
+                "`parents` and `children` should have the same size")
+
+        fitness = numpy.ascontiguousarray(fitness, dtype=numpy.float64)
+
+        if fitness.shape != (organisms_number, ):
+            raise ValueError("`fitness` should have a value for every parent")
+
+        definitions.libc.speciation_generation(
+            self._struct_ref, parents.struct_ref,
+            _genomes_vector(parents), _genomes_vector(children),
+            organisms_number,
+            _as_pointer(fitness, ctypes.c_double),
+            survival_rate, replication_type, blend_coefficient,
+            change_genes_prob, mutation_mode, flip_bits_prob, threads_number)
+        errors.check_errors()
+
+    @property
+    def organisms_species(self) -> numpy.ndarray:
+        """Id of the species of every genome of the last speciated pool.
+        """
+        ids = numpy.empty(
+            (self._struct_ref.contents.organisms_number, ), dtype=numpy.uint32)
+        definitions.libc.get_organisms_species(
+            self._struct_ref, _as_pointer(ids, ctypes.c_uint32))
+        return ids
+
+    def statistics(self) -> typing.Dict[str, numpy.ndarray]:
+        """Returns arrays with an item for every species: "id",
+        "members_number", "offspring_number" and "mean_fitness".
+        """
+        species_number = len(self)
+        statistics = {
+            "id": numpy.empty((species_number, ), dtype=numpy.uint32),
+            "members_number": numpy.empty(
+                (species_number, ), dtype=numpy.uint64),
+            "offspring_number": numpy.empty(
+                (species_number, ), dtype=numpy.uint64),
+            "mean_fitness": numpy.empty(
+                (species_number, ), dtype=numpy.float64)
+        }
+        definitions.libc.get_species_statistics(
+            self._struct_ref,
+            _as_pointer(statistics["id"], ctypes.c_uint32),
+            _as_pointer(statistics["members_number"], ctypes.c_uint64),
+            _as_pointer(statistics["offspring_number"], ctypes.c_uint64),
+            _as_pointer(statistics["mean_fitness"], ctypes.c_double))
+        return statistics
+
+
+def population_statistics(pool, threads_number: int = 0) -> dict:
+    """Gathers statistics of all the genomes in one pass (see statistics.h).
+
+    Returns:
+        dict with items:
+            "genes_number", "length_min", "length_max", "length_mean",
+            "length_deviation", "weight_min", "weight_max", "weight_mean",
+            "weight_deviation": numbers;
+            "connection_types": numpy.ndarray of shape (3, 3); Number of
+                genes by types of outcome (rows) and income (columns) nodes:
+                input, intermediate, output;
+            "out_degrees", "in_degrees": numpy.ndarray; Number of nodes by
+                their degree, the last item counts this and bigger degrees;
+            "bit_frequencies", "bit_entropies": numpy.ndarray; Share of genes
+                having every bit set and the entropy of the bit.
+    """
+    statistics = definitions.libc.create_population_statistics(
+        pool.struct_ref)
+    errors.check_errors()
+
+    try:
+        definitions.libc.collect_population_statistics(
+            statistics, pool.struct_ref, _genomes_vector(pool), len(pool),
+            threads_number)
+        errors.check_errors()
+
+        contents = statistics.contents
+        degrees_number = contents.degrees_number
+
+        result = {
+            name: getattr(contents, name)
+            for name in (
+                "genes_number", "length_min", "length_max", "length_mean",
+                "length_deviation", "weight_min", "weight_max",
+                "weight_mean", "weight_deviation")
+        }
+        result["connection_types"] = numpy.ctypeslib.as_array(
+            contents.connection_types, shape=(3, 3)).copy()
+        result["out_degrees"] = numpy.ctypeslib.as_array(
+            contents.out_degrees, shape=(degrees_number, )).copy()
+        result["in_degrees"] = numpy.ctypeslib.as_array(
+            contents.in_degrees, shape=(degrees_number, )).copy()
+        result["bit_frequencies"] = numpy.ctypeslib.as_array(
+            contents.bit_frequencies,
+            shape=(contents.gene_bits_size, )).copy()
+        result["bit_entropies"] = numpy.ctypeslib.as_array(
+            contents.bit_entropies,
+            shape=(contents.gene_bits_size, )).copy()
+
+        return result
+    finally:
+        definitions.libc.destroy_population_statistics(statistics)
@@ -0,0 +1,327 @@
+/*
+
+This module contains counting of bits of the gene area by positions.
+
+ */
+
+#include "alleles.h"
+
+// Byte counters of a block are moved into `counts` before they can overflow
+#define ALLELE_FLUSH_PERIOD 255
+
+typedef void (*allele_block_kernel_t)(
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const pool_gene_byte_size_t gene_bytes_size,
+    const uint64_t block_start, uint64_t * const counts);
+
+pthread_once_t alleles_init_once = PTHREAD_ONCE_INIT;
+
+// Byte `k` of item `v` (counting from the least significant one) equals to
+// the bit `k` of `v` counting from the most significant one.
+uint64_t allele_spread_table[256];
+
+void count_allele_block_swar(
+    genome_t * const * const, const pool_organisms_num_t,
+    const pool_gene_byte_size_t, const uint64_t, uint64_t * const);
+allele_block_kernel_t allele_block_kernel = count_allele_block_swar;
+
+/*
+
+Pointer to ALLELE_BLOCK_SIZE bytes of the genes of `genome` starting from
+`block_start`. If the genome ends inside the block, its bytes are copied into
+`buffer` and the missing ones are zeroed.
+
+ */
+const byte_t * get_allele_block(
+    const genome_t * const genome,
+    const pool_gene_byte_size_t gene_bytes_size,
+    const uint64_t block_start, byte_t * const buffer
+) {
+
+    const uint64_t genes_size = (uint64_t)genome->length * gene_bytes_size;
+
+    if (genes_size >= block_start + ALLELE_BLOCK_SIZE)
+        return genome->genes + block_start;
+
+    memset(buffer, 0, ALLELE_BLOCK_SIZE);
+    if (genes_size > block_start)
+        memcpy(buffer, genome->genes + block_start, genes_size - block_start);
+
+    return buffer;
+
+}
+
+void count_allele_block_swar(
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const pool_gene_byte_size_t gene_bytes_size,
+    const uint64_t block_start, uint64_t * const counts
+) {
+
+    uint64_t counters[ALLELE_BLOCK_SIZE] = {0};
+    byte_t buffer[ALLELE_BLOCK_SIZE];
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    ) {
+
+        const byte_t * const block = get_allele_block(
+            genomes[genome_i], gene_bytes_size, block_start, buffer);
+
+        for (uint32_t byte_i = 0; byte_i < ALLELE_BLOCK_SIZE; byte_i++)
+            counters[byte_i] += allele_spread_table[block[byte_i]];
+
+        if ((genome_i + 1) % ALLELE_FLUSH_PERIOD != 0 &&
+            genome_i + 1 != organisms_number)
+            continue;
+
+        for (uint32_t byte_i = 0; byte_i < ALLELE_BLOCK_SIZE; byte_i++) {
+            for (uint8_t bit = 0; bit < 8; bit++)
+                counts[byte_i * 8 + bit] += (counters[byte_i] >> (bit * 8)) & 0xff;
+            counters[byte_i] = 0;
+        }
+
+    }
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/*
+
+Every bit of 32 bytes is tested by comparing the masked bytes with the mask.
+Equal bytes become 0xff, that is -1, so subtracting them increments byte
+counters of the bit.
+
+ */
+__attribute__((target("avx2")))
+void count_allele_block_avx2(
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const pool_gene_byte_size_t gene_bytes_size,
+    const uint64_t block_start, uint64_t * const counts
+) {
+
+    #define ALLELE_VECTORS_NUMBER (ALLELE_BLOCK_SIZE / 32)
+
+    __m256i counters[ALLELE_VECTORS_NUMBER][8];
+    byte_t buffer[ALLELE_BLOCK_SIZE];
+    uint8_t flushed[32];
+
+    __m256i masks[8];
+    for (uint8_t bit = 0; bit < 8; bit++)
+        masks[bit] = _mm256_set1_epi8((char)(0x80 >> bit));
+
+    for (uint32_t vector_i = 0; vector_i < ALLELE_VECTORS_NUMBER; vector_i++)
+        for (uint8_t bit = 0; bit < 8; bit++)
+            counters[vector_i][bit] = _mm256_setzero_si256();
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    ) {
+
+        const byte_t * const block = get_allele_block(
+            genomes[genome_i], gene_bytes_size, block_start, buffer);
+
+        for (uint32_t vector_i = 0; vector_i < ALLELE_VECTORS_NUMBER; vector_i++) {
+            const __m256i bytes =
+                _mm256_loadu_si256((const __m256i *)(block + vector_i * 32));
+            for (uint8_t bit = 0; bit < 8; bit++)
+                counters[vector_i][bit] = _mm256_sub_epi8(
+                    counters[vector_i][bit],
+                    _mm256_cmpeq_epi8(
+                        _mm256_and_si256(bytes, masks[bit]), masks[bit]));
+        }
+
+        if ((genome_i + 1) % ALLELE_FLUSH_PERIOD != 0 &&
+            genome_i + 1 != organisms_number)
+            continue;
+
+        for (uint32_t vector_i = 0; vector_i < ALLELE_VECTORS_NUMBER; vector_i++)
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                _mm256_storeu_si256(
+                    (__m256i *)flushed, counters[vector_i][bit]);
+                for (uint32_t byte_i = 0; byte_i < 32; byte_i++)
+                    counts[(vector_i * 32 + byte_i) * 8 + bit] += flushed[byte_i];
+                counters[vector_i][bit] = _mm256_setzero_si256();
+            }
+
+    }
+
+    #undef ALLELE_VECTORS_NUMBER
+
+}
+
+#endif
+
+void alleles_init() {
+
+    for (uint32_t value = 0; value < 256; value++) {
+        allele_spread_table[value] = 0;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            allele_spread_table[value] |=
+                (uint64_t)((value >> (7 - bit)) & 1) << (bit * 8);
+    }
+
+    #if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        allele_block_kernel = count_allele_block_avx2;
+    #endif
+
+}
+
+double binary_entropy(const double probability) {
+
+    if (probability <= 0 || probability >= 1) return 0;
+
+    return
+        -probability * log2(probability) -
+        (1 - probability) * log2(1 - probability);
+
+}
+
+/*
+
+Number of bits of the gene area of the longest genome, which is the size of
+outputs of allele_frequencies.
+
+ */
+uint64_t count_allele_positions(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number
+) {
+
+    genome_length_t longest_length = 0;
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    )
+        if (genomes[genome_i]->length > longest_length)
+            longest_length = genomes[genome_i]->length;
+
+    return BYTES_TO_BITS((uint64_t)longest_length * pool->gene_bytes_size);
+
+}
+
+typedef struct alleles_job_s {
+    const pool_t       *pool;
+    genome_t * const   *genomes;
+    uint64_t            organisms_number;
+    // ALLELE_BLOCK_SIZE * 8 items for every block
+    uint64_t           *counts;
+} alleles_job_t;
+
+void allele_frequencies_body(
+    void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+    const alleles_job_t * const job = job_void;
+
+    for (uint64_t block_i = start; block_i < end; block_i++)
+        allele_block_kernel(
+            job->genomes, job->organisms_number, job->pool->gene_bytes_size,
+            block_i * ALLELE_BLOCK_SIZE,
+            job->counts + block_i * BYTES_TO_BITS(ALLELE_BLOCK_SIZE));
+
+}
+
+/*
+
+Count genomes having every bit of the gene area set (see
+count_allele_positions for the size of the outputs) with `threads_number`
+threads (0 means the number of CPUs). Frequency of a bit is the share of
+genomes having it among genomes long enough to have the bit at all. Any of
+the outputs may be NULL.
+
+ */
+void allele_frequencies(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    uint64_t * const counts,
+    double * const frequencies,
+    double * const entropies,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    pthread_once(&alleles_init_once, alleles_init);
+
+    const uint64_t positions_number =
+        count_allele_positions(pool, genomes, organisms_number);
+    if (positions_number == 0) return;
+
+    const uint64_t blocks_number =
+        (positions_number / 8 + ALLELE_BLOCK_SIZE - 1) / ALLELE_BLOCK_SIZE;
+
+    DECLARE_CONST_CALLOC_ARRAY(
+        uint64_t, block_counts,
+        blocks_number * BYTES_TO_BITS(ALLELE_BLOCK_SIZE), RETURN_VOID_ON_ERR);
+
+    alleles_job_t job = {
+        .pool = pool,
+        .genomes = genomes,
+        .organisms_number = organisms_number,
+        .counts = block_counts
+    };
+
+    parallel_for(
+        blocks_number, threads_number,
+        allele_frequencies_body, &job);
+
+    if (counts != NULL)
+        memcpy(counts, block_counts, sizeof(uint64_t) * positions_number);
+
+    if (frequencies != NULL || entropies != NULL) {
+
+        // covering[i] is the number of genomes of `i` or more genes
+        const genome_length_t longest_length =
+            positions_number / BYTES_TO_BITS(pool->gene_bytes_size);
+
+        DECLARE_CONST_CALLOC_ARRAY(
+            uint64_t, covering, (uint64_t)longest_length + 1,
+            free(block_counts); RETURN_VOID_ON_ERR);
+
+        for (
+            pool_organisms_num_t genome_i = 0;
+            genome_i < organisms_number;
+            genome_i++
+        )
+            covering[genomes[genome_i]->length]++;
+
+        for (genome_length_t gene_i = longest_length; gene_i > 0; gene_i--)
+            covering[gene_i - 1] += covering[gene_i];
+
+        for (uint64_t position = 0; position < positions_number; position++) {
+
+            const genome_length_t gene_i =
+                position / BYTES_TO_BITS(pool->gene_bytes_size);
+            const uint64_t genomes_number = covering[gene_i + 1];
+
+            const double frequency = genomes_number > 0
+                ? (double)block_counts[position] / genomes_number : 0;
+
+            if (frequencies != NULL) frequencies[position] = frequency;
+            if (entropies != NULL) entropies[position] = binary_entropy(frequency);
+
+        }
+
+        free(covering);
+
+    }
+
+    free(block_counts);
+
+}
+
+#undef ALLELE_FLUSH_PERIOD
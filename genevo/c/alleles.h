@@ -0,0 +1,77 @@
+/*
+
+This module contains frequencies of alleles: for every bit position of the
+gene area, the share of genomes having the bit set. They are used to detect
+convergence of the population, which is reached when most of the bits have
+frequencies close to 0 or 1 (entropies close to 0).
+
+Bits are counted column-wise: the gene area is split into blocks of
+ALLELE_BLOCK_SIZE bytes, and every thread takes whole blocks and goes through
+all the genomes, keeping small counters of every bit of the block in the
+registers. Genes are read straight from the pool file mapping. The kernel uses
+AVX2 instructions if the processor supports them, and SWAR (8 byte-sized
+counters in a 64-bit word) otherwise.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <immintrin.h>
+#endif
+
+#include "pool.h"
+#include "error.h"
+#include "memory.h"
+#include "bit_manipulations.h"
+#include "parallel.h"
+
+// Number of bytes of the gene area counted by a thread at once. Should be a
+// multiple of 32.
+#ifndef ALLELE_BLOCK_SIZE
+#   define ALLELE_BLOCK_SIZE 64
+#endif
+
+/* @function binary_entropy
+ * @return double
+ * @argument double
+ */
+double binary_entropy(const double probability);
+
+/* @function count_allele_positions
+ * @return uint64
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ */
+uint64_t count_allele_positions(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number);
+
+/* @function allele_frequencies
+ * @return void
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint64*
+ * @argument double*
+ * @argument double*
+ * @argument uint16
+ */
+void allele_frequencies(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    uint64_t * const counts,
+    double * const frequencies,
+    double * const entropies,
+    const uint16_t threads_number);
@@ -0,0 +1,1003 @@
+/*
+
+This module contains methods for writing and reading multi-generation archives.
+
+ */
+
+#include "archive.h"
+
+#define ARCHIVE_ENTRY_SIZE(_PAYLOAD_SIZE)                                      \
+    (sizeof(archive_file_entry_preamble_t) +                                   \
+     (_PAYLOAD_SIZE) +                                                         \
+     sizeof(ARCHIVE_ENTRY_TERMINAL_BYTE))
+
+#define ARCHIVE_LITERAL_CHILD_SIZE(_GENOME, _GENE_BYTE_SIZE)                   \
+    ((size_t)(_GENOME)->length * (_GENE_BYTE_SIZE))
+
+#define ARCHIVE_DERIVED_CHILD_SIZE(                                            \
+    _PARENTS_NUMBER, _SEGMENTS_NUMBER, _PATCHES_NUMBER, _GENE_BYTE_SIZE)       \
+    (sizeof(uint8_t) +                                                         \
+     (size_t)(_PARENTS_NUMBER) * sizeof(uint64_t) +                            \
+     sizeof(uint32_t) +                                                        \
+     (size_t)(_SEGMENTS_NUMBER) * sizeof(archive_file_segment_t) +             \
+     sizeof(uint32_t) +                                                        \
+     (size_t)(_PATCHES_NUMBER) * (sizeof(uint32_t) + (_GENE_BYTE_SIZE)))
+
+// Value of patches number which marks the child to be written literally
+#define ARCHIVE_LITERAL_CHILD UINT32_MAX
+
+/*
+
+Allocate genome which owns its metadata, genes and residue.
+
+ */
+genome_t * allocate_archived_genome(
+    const genome_length_t length,
+    const genome_metadata_size_t metadata_byte_size,
+    const genome_residue_size_t residue_size_bits,
+    const pool_gene_byte_size_t gene_byte_size
+) {
+
+    DECLARE_CONST_MALLOC_OBJECT(genome_t, genome, RETURN_NULL_ON_ERR);
+
+    genome->length = length;
+    genome->metadata_byte_size = metadata_byte_size;
+    genome->residue_size_bits = residue_size_bits;
+    genome->flags = GENOME_DIRTY;
+
+    // malloc(0) may return NULL, so 1 byte is always requested
+    genome->metadata = malloc(metadata_byte_size + 1);
+    genome->genes = malloc((size_t)length * gene_byte_size + 1);
+    genome->residue = malloc(BITS_TO_BYTES(residue_size_bits) + 1);
+
+    if (
+        genome->metadata == NULL || genome->genes == NULL ||
+        genome->residue == NULL
+    ) {
+        destroy_genome(genome, true);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    return genome;
+
+}
+
+/*
+
+Allocate population with `organisms_number` empty genome slots and the pool
+having the same description as `sample`. Pool metadata is not copied.
+
+ */
+population_t * allocate_archived_population(
+    const pool_t * const sample, const pool_organisms_num_t organisms_number,
+    const pool_metadata_size_t metadata_byte_size
+) {
+
+    DECLARE_CONST_MALLOC_OBJECT(
+        population_t, population, RETURN_NULL_ON_ERR);
+
+    population->pool = allocate_pool();
+    population->genomes = calloc(organisms_number + 1, sizeof(genome_t *));
+
+    if (population->pool == NULL || population->genomes == NULL) {
+        if (population->pool != NULL) destroy_pool(population->pool, false);
+        FREE_NOT_NULL(population->genomes);
+        free(population);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    pool_t * const pool = population->pool;
+    pool->organisms_number = organisms_number;
+    pool->input_neurons_number = sample->input_neurons_number;
+    pool->output_neurons_number = sample->output_neurons_number;
+    pool->node_id_part_bit_size = sample->node_id_part_bit_size;
+    pool->weight_part_bit_size = sample->weight_part_bit_size;
+    pool->gene_bytes_size = sample->gene_bytes_size;
+    pool->first_genome_start_position = NULL;
+    pool->cursor = NULL;
+    pool->metadata_byte_size = metadata_byte_size;
+    pool->metadata = malloc(metadata_byte_size + 1);
+
+    if (pool->metadata == NULL) {
+        destroy_pool(pool, false);
+        free(population->genomes);
+        free(population);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    return population;
+
+}
+
+/*
+
+Destroy population created by allocate_archived_population. Genome slots may
+be left NULL.
+
+ */
+void destroy_archived_population(population_t * const population) {
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < population->pool->organisms_number;
+        genome_i++
+    )
+        if (population->genomes[genome_i] != NULL)
+            destroy_genome(population->genomes[genome_i], true);
+
+    free(population->genomes);
+    destroy_pool(population->pool, false);
+    free(population);
+
+}
+
+population_t * clone_population(
+    const pool_t * const pool, const genome_t * const * const genomes
+) {
+
+    population_t * const population = allocate_archived_population(
+        pool, pool->organisms_number, pool->metadata_byte_size);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    memcpy(
+        population->pool->metadata, pool->metadata, pool->metadata_byte_size);
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < pool->organisms_number;
+        genome_i++
+    ) {
+
+        const genome_t * const src = genomes[genome_i];
+        genome_t * const dst = allocate_archived_genome(
+            src->length, src->metadata_byte_size, src->residue_size_bits,
+            pool->gene_bytes_size);
+
+        if (ERROR_LEVEL != ERR_OK) {
+            destroy_archived_population(population);
+            RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+        }
+
+        memcpy(dst->metadata, src->metadata, src->metadata_byte_size);
+        memcpy(
+            dst->genes, src->genes,
+            (size_t)src->length * pool->gene_bytes_size);
+        memcpy(
+            dst->residue, src->residue, BITS_TO_BYTES(src->residue_size_bits));
+
+        population->genomes[genome_i] = dst;
+
+    }
+
+    return population;
+
+}
+
+/*
+
+Copy genes of the child from its parents as the segments say. Genes not
+covered by any segment are set to zero. Returns false if some segment is out
+of the child or parent bounds.
+
+ */
+bool reconstruct_child_genes(
+    gene_byte_t * const destination, const genome_length_t length,
+    const crossover_segment_t * const segments, const uint32_t segments_number,
+    const genome_t * const * const parents, const uint8_t parents_number,
+    const pool_gene_byte_size_t gene_byte_size
+) {
+
+    memset(destination, 0, (size_t)length * gene_byte_size);
+
+    for (uint32_t segment_i = 0; segment_i < segments_number; segment_i++) {
+
+        const crossover_segment_t * const segment = &segments[segment_i];
+
+        if (
+            segment->parent >= parents_number ||
+            (uint64_t)segment->start + segment->length > length ||
+            (uint64_t)segment->start + segment->length >
+                parents[segment->parent]->length
+        )
+            return false;
+
+        memcpy(
+            destination + (size_t)segment->start * gene_byte_size,
+            parents[segment->parent]->genes +
+                (size_t)segment->start * gene_byte_size,
+            (size_t)segment->length * gene_byte_size);
+
+    }
+
+    return true;
+
+}
+
+/*
+
+Find parents of the child in the previous generation. Returns false if any of
+them is not there.
+
+ */
+bool resolve_child_parents(
+    const child_lineage_t * const lineage,
+    const pool_organisms_num_t * const parents_indices,
+    const population_t * const previous,
+    const genome_t ** const parents
+) {
+
+    for (uint8_t parent_i = 0; parent_i < lineage->parents_number; parent_i++) {
+
+        const pool_organisms_num_t index = parents_indices != NULL
+            ? parents_indices[lineage->parents[parent_i]]
+            : lineage->parents[parent_i];
+
+        if (index >= previous->pool->organisms_number) return false;
+        parents[parent_i] = previous->genomes[index];
+
+    }
+
+    return true;
+
+}
+
+/*
+
+Count genes of the child which differ from its reconstruction, or return
+ARCHIVE_LITERAL_CHILD if storing the child literally is not larger.
+
+ */
+uint32_t count_child_patches(
+    const genome_t * const child, const child_lineage_t * const lineage,
+    const genome_t * const * const parents,
+    gene_byte_t * const scratch,
+    const pool_gene_byte_size_t gene_byte_size
+) {
+
+    if (!reconstruct_child_genes(
+        scratch, child->length, lineage->segments, lineage->segments_number,
+        parents, lineage->parents_number, gene_byte_size)
+    )
+        return ARCHIVE_LITERAL_CHILD;
+
+    uint32_t patches_number = 0;
+    for (genome_length_t gene_i = 0; gene_i < child->length; gene_i++)
+        if (memcmp(
+            scratch + (size_t)gene_i * gene_byte_size,
+            child->genes + (size_t)gene_i * gene_byte_size,
+            gene_byte_size) != 0
+        )
+            patches_number++;
+
+    if (
+        ARCHIVE_DERIVED_CHILD_SIZE(
+            lineage->parents_number, lineage->segments_number,
+            patches_number, gene_byte_size) >=
+        ARCHIVE_LITERAL_CHILD_SIZE(child, gene_byte_size)
+    )
+        return ARCHIVE_LITERAL_CHILD;
+
+    return patches_number;
+
+}
+
+void archive_push_entry(
+    archive_t * const archive, const uint64_t generation,
+    const size_t offset, const archive_entry_type_t type
+) {
+
+    if (archive->entries_number == archive->entries_capacity) {
+        const uint64_t new_capacity =
+            archive->entries_capacity ? archive->entries_capacity * 2 : 16;
+        archive_entry_t * const entries = realloc(
+            archive->entries, sizeof(archive_entry_t) * new_capacity);
+        if (entries == NULL) RAISE_MALLOC_ERR(RETURN_VOID_ON_ERR);
+        archive->entries = entries;
+        archive->entries_capacity = new_capacity;
+    }
+
+    archive->entries[archive->entries_number].generation = generation;
+    archive->entries[archive->entries_number].offset = offset;
+    archive->entries[archive->entries_number].type = type;
+    archive->entries_number++;
+
+}
+
+archive_t * allocate_archive(file_map_t * const mapping) {
+
+    archive_t * const archive = malloc(sizeof(archive_t));
+    if (archive == NULL) {
+        close_file(mapping);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    archive->file_mapping = mapping;
+    archive->entries_number = 0;
+    archive->entries_capacity = 0;
+    archive->entries = NULL;
+    archive->last = NULL;
+    archive->deltas_since_keyframe = 0;
+
+    return archive;
+
+}
+
+/*
+
+Create new empty archive. Existing file will be truncated. If
+`keyframe_interval` is 0, ARCHIVE_DEFAULT_KEYFRAME_INTERVAL is used.
+
+ */
+archive_t * create_archive(
+    const char *address, const uint32_t keyframe_interval
+) {
+
+    // open_file maps one byte less than it writes into the stretched file
+    file_map_t * const mapping = open_file(
+        address, OPEN_MODE_WRITE, sizeof(archive_file_preamble_t) - 1);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    resize_file(mapping, sizeof(archive_file_preamble_t));
+    if (ERROR_LEVEL != ERR_OK) {
+        close_file(mapping);
+        return NULL;
+    }
+
+    archive_t * const archive = allocate_archive(mapping);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    archive->keyframe_interval = keyframe_interval > 0
+        ? keyframe_interval : ARCHIVE_DEFAULT_KEYFRAME_INTERVAL;
+
+    archive_file_preamble_t * const preamble = mapping->data;
+    preamble->initial_byte = ARCHIVE_INITIAL_BYTE;
+    preamble->version = ARCHIVE_FORMAT_VERSION;
+    preamble->keyframe_interval = HTON(archive->keyframe_interval);
+
+    return archive;
+
+}
+
+#define ARCHIVE_FAIL_CONDITION(_CONDITION, _ERR_CONST)                         \
+    if (_CONDITION) {                                                          \
+        ERROR_LEVEL = (_ERR_CONST); close_archive(archive); return NULL; }
+
+/*
+
+Open existing archive for reading and appending. Nothing is known about the
+last stored generation, so the first appended generation will be a keyframe.
+
+ */
+archive_t * open_archive(const char *address) {
+
+    file_map_t * const mapping =
+        open_file(address, OPEN_MODE_READ_WRITE, 0);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    archive_t * const archive = allocate_archive(mapping);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    ARCHIVE_FAIL_CONDITION(
+        mapping->size < sizeof(archive_file_preamble_t),
+        ERR_ARCHIVE_CORRUPT_START);
+
+    const archive_file_preamble_t * const preamble = mapping->data;
+
+    ARCHIVE_FAIL_CONDITION(
+        preamble->initial_byte != ARCHIVE_INITIAL_BYTE,
+        ERR_ARCHIVE_CORRUPT_START);
+
+    ARCHIVE_FAIL_CONDITION(
+        preamble->version != ARCHIVE_FORMAT_VERSION,
+        ERR_ARCHIVE_WRONG_VERSION);
+
+    archive->keyframe_interval = NTOH(preamble->keyframe_interval);
+
+    size_t offset = sizeof(archive_file_preamble_t);
+    while (offset < mapping->size) {
+
+        const archive_file_entry_preamble_t * const entry =
+            (void *)((byte_t *)mapping->data + offset);
+
+        ARCHIVE_FAIL_CONDITION(
+            mapping->size - offset < ARCHIVE_ENTRY_SIZE(0) ||
+            entry->initial_byte != ARCHIVE_ENTRY_INITIAL_BYTE ||
+            (entry->type != ARCHIVE_ENTRY_FULL &&
+             entry->type != ARCHIVE_ENTRY_DELTA),
+            ERR_ARCHIVE_CORRUPT_ENTRY);
+
+        const uint64_t payload_byte_size = NTOH(entry->payload_byte_size);
+
+        ARCHIVE_FAIL_CONDITION(
+            payload_byte_size > mapping->size - offset - ARCHIVE_ENTRY_SIZE(0),
+            ERR_ARCHIVE_CORRUPT_ENTRY);
+
+        const size_t entry_size = ARCHIVE_ENTRY_SIZE(payload_byte_size);
+
+        ARCHIVE_FAIL_CONDITION(
+            *((file_control_byte_t *)mapping->data + offset + entry_size - 1) !=
+                ARCHIVE_ENTRY_TERMINAL_BYTE,
+            ERR_ARCHIVE_CORRUPT_ENTRY);
+
+        archive_push_entry(
+            archive, NTOH(entry->generation), offset, entry->type);
+        if (ERROR_LEVEL != ERR_OK) {
+            close_archive(archive);
+            return NULL;
+        }
+
+        offset += entry_size;
+
+    }
+
+    return archive;
+
+}
+
+#undef ARCHIVE_FAIL_CONDITION
+
+/*
+
+Compute size of the delta payload and decide how every child will be written.
+`patches_numbers` receives number of patches of each child or
+ARCHIVE_LITERAL_CHILD. Returns 0 if the delta can't be built at all.
+
+ */
+size_t get_delta_size(
+    const archive_t * const archive,
+    const pool_t * const pool, genome_t ** const genomes,
+    const generation_lineage_t * const lineage,
+    const pool_organisms_num_t * const parents_indices,
+    uint32_t * const patches_numbers, gene_byte_t * const scratch
+) {
+
+    const pool_gene_byte_size_t gene_byte_size = pool->gene_bytes_size;
+
+    size_t size =
+        sizeof(archive_file_delta_preamble_t) + pool->metadata_byte_size;
+
+    const genome_t * parents[UINT8_MAX + 1];
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < pool->organisms_number;
+        genome_i++
+    ) {
+
+        const genome_t * const child = genomes[genome_i];
+        const child_lineage_t * const child_lineage =
+            &lineage->children[genome_i];
+
+        size += sizeof(archive_file_child_preamble_t) +
+            child->metadata_byte_size +
+            BITS_TO_BYTES(child->residue_size_bits);
+
+        patches_numbers[genome_i] =
+            resolve_child_parents(
+                child_lineage, parents_indices, archive->last, parents)
+            ? count_child_patches(
+                child, child_lineage, parents, scratch, gene_byte_size)
+            : ARCHIVE_LITERAL_CHILD;
+
+        size += patches_numbers[genome_i] == ARCHIVE_LITERAL_CHILD
+            ? ARCHIVE_LITERAL_CHILD_SIZE(child, gene_byte_size)
+            : ARCHIVE_DERIVED_CHILD_SIZE(
+                child_lineage->parents_number, child_lineage->segments_number,
+                patches_numbers[genome_i], gene_byte_size);
+
+    }
+
+    return size;
+
+}
+
+void write_delta(
+    const archive_t * const archive,
+    const pool_t * const pool, genome_t ** const genomes,
+    const generation_lineage_t * const lineage,
+    const pool_organisms_num_t * const parents_indices,
+    const uint32_t * const patches_numbers, gene_byte_t * const scratch,
+    byte_t *position
+) {
+
+    const pool_gene_byte_size_t gene_byte_size = pool->gene_bytes_size;
+
+    archive_file_delta_preamble_t * const preamble = (void *)position;
+    COPY_MEMBER_HTON(organisms_number,   pool, preamble);
+    COPY_MEMBER_HTON(metadata_byte_size, pool, preamble);
+    position += sizeof(archive_file_delta_preamble_t);
+
+    memcpy(position, pool->metadata, pool->metadata_byte_size);
+    position += pool->metadata_byte_size;
+
+    const genome_t * parents[UINT8_MAX + 1];
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < pool->organisms_number;
+        genome_i++
+    ) {
+
+        const genome_t * const child = genomes[genome_i];
+        const child_lineage_t * const child_lineage =
+            &lineage->children[genome_i];
+        const bool literal = patches_numbers[genome_i] == ARCHIVE_LITERAL_CHILD;
+
+        archive_file_child_preamble_t * const child_preamble =
+            (void *)position;
+        child_preamble->kind =
+            literal ? ARCHIVE_CHILD_LITERAL : ARCHIVE_CHILD_DERIVED;
+        COPY_MEMBER_HTON(length,             child, child_preamble);
+        COPY_MEMBER_HTON(metadata_byte_size, child, child_preamble);
+        COPY_MEMBER_HTON(residue_size_bits,  child, child_preamble);
+        position += sizeof(archive_file_child_preamble_t);
+
+        memcpy(position, child->metadata, child->metadata_byte_size);
+        position += child->metadata_byte_size;
+
+        memcpy(
+            position, child->residue, BITS_TO_BYTES(child->residue_size_bits));
+        position += BITS_TO_BYTES(child->residue_size_bits);
+
+        if (literal) {
+            memcpy(
+                position, child->genes,
+                ARCHIVE_LITERAL_CHILD_SIZE(child, gene_byte_size));
+            position += ARCHIVE_LITERAL_CHILD_SIZE(child, gene_byte_size);
+            continue;
+        }
+
+        *position++ = child_lineage->parents_number;
+        for (
+            uint8_t parent_i = 0;
+            parent_i < child_lineage->parents_number;
+            parent_i++
+        ) {
+            const uint64_t index = HTON((uint64_t)(parents_indices != NULL
+                ? parents_indices[child_lineage->parents[parent_i]]
+                : child_lineage->parents[parent_i]));
+            memcpy(position, &index, sizeof(index));
+            position += sizeof(index);
+        }
+
+        const uint32_t segments_number = HTON(child_lineage->segments_number);
+        memcpy(position, &segments_number, sizeof(segments_number));
+        position += sizeof(segments_number);
+
+        for (
+            uint32_t segment_i = 0;
+            segment_i < child_lineage->segments_number;
+            segment_i++
+        ) {
+            const crossover_segment_t * const segment =
+                &child_lineage->segments[segment_i];
+            archive_file_segment_t * const file_segment = (void *)position;
+            COPY_MEMBER_HTON(start,  segment, file_segment);
+            COPY_MEMBER_HTON(length, segment, file_segment);
+            COPY_MEMBER     (parent, segment, file_segment);
+            position += sizeof(archive_file_segment_t);
+        }
+
+        const uint32_t patches_number = HTON(patches_numbers[genome_i]);
+        memcpy(position, &patches_number, sizeof(patches_number));
+        position += sizeof(patches_number);
+
+        resolve_child_parents(
+            child_lineage, parents_indices, archive->last, parents);
+        reconstruct_child_genes(
+            scratch, child->length,
+            child_lineage->segments, child_lineage->segments_number,
+            parents, child_lineage->parents_number, gene_byte_size);
+
+        for (genome_length_t gene_i = 0; gene_i < child->length; gene_i++) {
+
+            const gene_byte_t * const gene =
+                child->genes + (size_t)gene_i * gene_byte_size;
+
+            if (memcmp(
+                scratch + (size_t)gene_i * gene_byte_size,
+                gene, gene_byte_size) == 0
+            )
+                continue;
+
+            const uint32_t index = HTON(gene_i);
+            memcpy(position, &index, sizeof(index));
+            position += sizeof(index);
+            memcpy(position, gene, gene_byte_size);
+            position += gene_byte_size;
+
+        }
+
+    }
+
+}
+
+/*
+
+Append the generation to the archive. If lineage of the generation is known
+and the previous generation was appended through the same archive object, only
+the delta is written, otherwise the whole pool is dumped. Parents in the
+lineage should refer to genomes of the previously appended generation, or
+`parents_indices` should map them there (it may be NULL). Writeback of the
+entry is started in the background.
+
+ */
+void archive_append_generation(
+    archive_t * const archive, const uint64_t generation,
+    pool_t * const pool, genome_t ** const genomes,
+    const generation_lineage_t * const lineage,
+    const pool_organisms_num_t * const parents_indices
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    bool write_delta_entry =
+        lineage != NULL && archive->last != NULL &&
+        archive->deltas_since_keyframe + 1 < archive->keyframe_interval &&
+        lineage->children_number == pool->organisms_number &&
+        archive->last->pool->gene_bytes_size == pool->gene_bytes_size;
+
+    uint32_t *patches_numbers = NULL;
+    gene_byte_t *scratch = NULL;
+    size_t payload_byte_size = 0;
+
+    if (write_delta_entry) {
+
+        genome_length_t max_length = 0;
+        for (
+            pool_organisms_num_t genome_i = 0;
+            genome_i < pool->organisms_number;
+            genome_i++
+        )
+            if (genomes[genome_i]->length > max_length)
+                max_length = genomes[genome_i]->length;
+
+        patches_numbers = malloc(sizeof(uint32_t) * pool->organisms_number);
+        scratch = malloc((size_t)max_length * pool->gene_bytes_size + 1);
+
+        // patches_numbers of an empty pool may be NULL
+        if ((patches_numbers == NULL && pool->organisms_number > 0) ||
+            scratch == NULL) {
+            FREE_NOT_NULL(patches_numbers);
+            FREE_NOT_NULL(scratch);
+            RAISE_MALLOC_ERR(RETURN_VOID_ON_ERR);
+        }
+
+        payload_byte_size = get_delta_size(
+            archive, pool, genomes, lineage, parents_indices,
+            patches_numbers, scratch);
+
+    } else {
+
+        payload_byte_size = get_pool_file_size(pool, genomes);
+
+    }
+
+    file_map_t * const mapping = archive->file_mapping;
+    const size_t offset = mapping->size;
+    const size_t entry_size = ARCHIVE_ENTRY_SIZE(payload_byte_size);
+
+    resize_file(mapping, offset + entry_size);
+    if (ERROR_LEVEL != ERR_OK) {
+        FREE_NOT_NULL(patches_numbers);
+        FREE_NOT_NULL(scratch);
+        return;
+    }
+
+    archive_file_entry_preamble_t * const entry =
+        (void *)((byte_t *)mapping->data + offset);
+    entry->initial_byte = ARCHIVE_ENTRY_INITIAL_BYTE;
+    entry->type = write_delta_entry ? ARCHIVE_ENTRY_DELTA : ARCHIVE_ENTRY_FULL;
+    entry->generation = HTON(generation);
+    entry->payload_byte_size = HTON((uint64_t)payload_byte_size);
+
+    byte_t * const payload = (void *)(entry + 1);
+
+    if (write_delta_entry) {
+
+        write_delta(
+            archive, pool, genomes, lineage, parents_indices,
+            patches_numbers, scratch, payload);
+
+        free(patches_numbers);
+        free(scratch);
+
+    } else {
+
+        save_pool_to_memory(
+            pool, genomes,
+            POOL_COPY_DATA | POOL_COPY_METADATA | POOL_REWRITE_DESCRIPTION,
+            payload);
+
+    }
+
+    *(payload + payload_byte_size) = ARCHIVE_ENTRY_TERMINAL_BYTE;
+
+    archive_push_entry(
+        archive, generation, offset,
+        write_delta_entry ? ARCHIVE_ENTRY_DELTA : ARCHIVE_ENTRY_FULL);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    archive->deltas_since_keyframe =
+        write_delta_entry ? archive->deltas_since_keyframe + 1 : 0;
+
+    if (archive->last != NULL) destroy_archived_population(archive->last);
+    archive->last = clone_population(
+        pool, (const genome_t * const *)genomes);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    flush_file_range(mapping, offset, entry_size, false);
+
+}
+
+population_t * read_full_entry(
+    const byte_t * const payload, const size_t payload_byte_size
+) {
+
+    pool_t * const pool =
+        read_pool_from_memory((void *)payload, payload_byte_size);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    genome_t ** const genomes = read_genomes(pool);
+    if (ERROR_LEVEL != ERR_OK) {
+        close_pool(pool);
+        return NULL;
+    }
+
+    population_t * const population =
+        clone_population(pool, (const genome_t * const *)genomes);
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < pool->organisms_number;
+        genome_i++
+    )
+        free(genomes[genome_i]);
+    free_genomes_ptrs(genomes);
+    close_pool(pool);
+
+    return population;
+
+}
+
+#define DELTA_FAIL {                                                           \
+    FREE_NOT_NULL(segments);                                                   \
+    if (population != NULL) destroy_archived_population(population);          \
+    ERROR_LEVEL = ERR_ARCHIVE_CORRUPT_DELTA;                                   \
+    return NULL; }
+
+// Point _DESTINATION at the next _SIZE bytes of the payload
+#define DELTA_TAKE(_DESTINATION, _SIZE)                                        \
+    if ((size_t)(end - position) < (size_t)(_SIZE)) DELTA_FAIL;                \
+    _DESTINATION = (void *)position;                                           \
+    position += (_SIZE);
+
+/*
+
+Build the next generation from the previous one and the delta payload.
+
+ */
+population_t * read_delta_entry(
+    const population_t * const previous,
+    const byte_t * const payload, const size_t payload_byte_size
+) {
+
+    const byte_t *position = payload;
+    const byte_t * const end = payload + payload_byte_size;
+    population_t *population = NULL;
+    crossover_segment_t *segments = NULL;
+    uint32_t segments_capacity = 0;
+
+    const archive_file_delta_preamble_t *preamble;
+    DELTA_TAKE(preamble, sizeof(archive_file_delta_preamble_t));
+
+    const pool_organisms_num_t organisms_number =
+        NTOH(preamble->organisms_number);
+    const pool_metadata_size_t metadata_byte_size =
+        NTOH(preamble->metadata_byte_size);
+
+    // every child takes at least its preamble
+    if (
+        organisms_number >
+        (size_t)(end - position) / sizeof(archive_file_child_preamble_t)
+    )
+        DELTA_FAIL;
+
+    population = allocate_archived_population(
+        previous->pool, organisms_number, metadata_byte_size);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    const pool_gene_byte_size_t gene_byte_size =
+        population->pool->gene_bytes_size;
+
+    const byte_t *pool_metadata;
+    DELTA_TAKE(pool_metadata, metadata_byte_size);
+    memcpy(population->pool->metadata, pool_metadata, metadata_byte_size);
+
+    const genome_t * parents[UINT8_MAX + 1];
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    ) {
+
+        const archive_file_child_preamble_t *child_preamble;
+        DELTA_TAKE(child_preamble, sizeof(archive_file_child_preamble_t));
+
+        genome_t * const child = allocate_archived_genome(
+            NTOH(child_preamble->length),
+            NTOH(child_preamble->metadata_byte_size),
+            NTOH(child_preamble->residue_size_bits),
+            gene_byte_size);
+        if (ERROR_LEVEL != ERR_OK) {
+            FREE_NOT_NULL(segments);
+            destroy_archived_population(population);
+            return NULL;
+        }
+        population->genomes[genome_i] = child;
+
+        const byte_t *source;
+
+        DELTA_TAKE(source, child->metadata_byte_size);
+        memcpy(child->metadata, source, child->metadata_byte_size);
+
+        DELTA_TAKE(source, BITS_TO_BYTES(child->residue_size_bits));
+        memcpy(child->residue, source, BITS_TO_BYTES(child->residue_size_bits));
+
+        const size_t genes_byte_size = (size_t)child->length * gene_byte_size;
+
+        if (child_preamble->kind == ARCHIVE_CHILD_LITERAL) {
+            DELTA_TAKE(source, genes_byte_size);
+            memcpy(child->genes, source, genes_byte_size);
+            continue;
+        }
+
+        if (child_preamble->kind != ARCHIVE_CHILD_DERIVED) DELTA_FAIL;
+
+        const uint8_t *parents_number;
+        DELTA_TAKE(parents_number, sizeof(uint8_t));
+
+        for (uint8_t parent_i = 0; parent_i < *parents_number; parent_i++) {
+            uint64_t index;
+            DELTA_TAKE(source, sizeof(index));
+            memcpy(&index, source, sizeof(index));
+            index = NTOH(index);
+            if (index >= previous->pool->organisms_number) DELTA_FAIL;
+            parents[parent_i] = previous->genomes[index];
+        }
+
+        uint32_t segments_number;
+        DELTA_TAKE(source, sizeof(segments_number));
+        memcpy(&segments_number, source, sizeof(segments_number));
+        segments_number = NTOH(segments_number);
+
+        if (
+            segments_number >
+            (size_t)(end - position) / sizeof(archive_file_segment_t)
+        )
+            DELTA_FAIL;
+
+        if (segments_number > segments_capacity) {
+            FREE_NOT_NULL(segments);
+            segments = malloc(sizeof(crossover_segment_t) * segments_number);
+            segments_capacity = segments_number;
+            if (segments == NULL) {
+                destroy_archived_population(population);
+                RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+            }
+        }
+
+        for (uint32_t segment_i = 0; segment_i < segments_number; segment_i++) {
+            const archive_file_segment_t *file_segment;
+            DELTA_TAKE(file_segment, sizeof(archive_file_segment_t));
+            crossover_segment_t * const segment = &segments[segment_i];
+            COPY_MEMBER_NTOH(start,  file_segment, segment);
+            COPY_MEMBER_NTOH(length, file_segment, segment);
+            COPY_MEMBER     (parent, file_segment, segment);
+        }
+
+        if (!reconstruct_child_genes(
+            child->genes, child->length, segments, segments_number,
+            parents, *parents_number, gene_byte_size)
+        )
+            DELTA_FAIL;
+
+        uint32_t patches_number;
+        DELTA_TAKE(source, sizeof(patches_number));
+        memcpy(&patches_number, source, sizeof(patches_number));
+        patches_number = NTOH(patches_number);
+
+        for (uint32_t patch_i = 0; patch_i < patches_number; patch_i++) {
+            uint32_t gene_i;
+            DELTA_TAKE(source, sizeof(gene_i) + gene_byte_size);
+            memcpy(&gene_i, source, sizeof(gene_i));
+            gene_i = NTOH(gene_i);
+            if (gene_i >= child->length) DELTA_FAIL;
+            memcpy(
+                child->genes + (size_t)gene_i * gene_byte_size,
+                source + sizeof(gene_i), gene_byte_size);
+        }
+
+    }
+
+    FREE_NOT_NULL(segments);
+
+    return population;
+
+}
+
+#undef DELTA_TAKE
+#undef DELTA_FAIL
+
+/*
+
+Restore the generation from the archive. The nearest keyframe is decoded and
+all deltas after it are applied. Returned population owns all its data and
+should be destroyed with destroy_population(population, true, true, false).
+
+ */
+population_t * archive_read_generation(
+    const archive_t * const archive, const uint64_t generation
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    uint64_t target = archive->entries_number;
+    for (uint64_t entry_i = archive->entries_number; entry_i > 0; entry_i--)
+        if (archive->entries[entry_i - 1].generation == generation) {
+            target = entry_i - 1;
+            break;
+        }
+
+    if (target == archive->entries_number) {
+        ERROR_LEVEL = ERR_ARCHIVE_NO_GENERATION;
+        return NULL;
+    }
+
+    uint64_t keyframe = target;
+    while (archive->entries[keyframe].type != ARCHIVE_ENTRY_FULL) {
+        if (keyframe == 0) {
+            ERROR_LEVEL = ERR_ARCHIVE_CORRUPT_DELTA;
+            return NULL;
+        }
+        keyframe--;
+    }
+
+    population_t *population = NULL;
+
+    for (uint64_t entry_i = keyframe; entry_i <= target; entry_i++) {
+
+        const archive_file_entry_preamble_t * const entry = (void *)(
+            (byte_t *)archive->file_mapping->data +
+            archive->entries[entry_i].offset);
+        const byte_t * const payload = (void *)(entry + 1);
+        const size_t payload_byte_size = NTOH(entry->payload_byte_size);
+
+        if (entry_i == keyframe) {
+            population = read_full_entry(payload, payload_byte_size);
+        } else {
+            population_t * const next =
+                read_delta_entry(population, payload, payload_byte_size);
+            const err_status_t status = ERROR_LEVEL;
+            destroy_archived_population(population);
+            ERROR_LEVEL = status;
+            population = next;
+        }
+
+        if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    }
+
+    return population;
+
+}
+
+void close_archive(archive_t * const archive) {
+
+    if (archive->last != NULL) destroy_archived_population(archive->last);
+    FREE_NOT_NULL(archive->entries);
+    close_file(archive->file_mapping);
+    free(archive);
+
+}
@@ -0,0 +1,219 @@
+/*
+
+This module contains methods for storing many generations of the run in a
+single archive file. Most of the children differ from their parents only by a
+few mutations, so instead of the whole pool only the crossover record of each
+child (see generation_lineage_t in mutations.h) and genes changed by mutations
+are written. Full dumps of the pool (keyframes) are written every
+`keyframe_interval` generations, so any generation can be restored by applying
+at most `keyframe_interval - 1` deltas.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "pool.h"
+#include "error.h"
+#include "files.h"
+#include "types.h"
+#include "memory.h"
+#include "pickler.h"
+#include "demiurge.h"
+#include "mutations.h"
+
+#define ARCHIVE_FORMAT_VERSION        (uint8_t)1
+
+#define ARCHIVE_INITIAL_BYTE          (file_control_byte_t)0xD0
+#define ARCHIVE_ENTRY_INITIAL_BYTE    (file_control_byte_t)0xD1
+#define ARCHIVE_ENTRY_TERMINAL_BYTE   (file_control_byte_t)0xD2
+
+#ifndef ARCHIVE_DEFAULT_KEYFRAME_INTERVAL
+#   define ARCHIVE_DEFAULT_KEYFRAME_INTERVAL 16
+#endif
+
+/*
+
+Structure of the archive file is the following (network byte order is used
+for all the numbers):
+
+Content                               Size (bits)  Note
+----------                            ----------   ----------
+ARCHIVE_INITIAL_BYTE                  8
+[format version]                      8
+[keyframe interval]                   32
+[entries]                             ...          Until the end of the file
+
+Every entry is:
+
+ARCHIVE_ENTRY_INITIAL_BYTE            8
+[entry type]                          8            archive_entry_type_t
+[generation number]                   64
+[size of the payload = PSB]           64
+[payload]                             PSb
+ARCHIVE_ENTRY_TERMINAL_BYTE           8
+
+Payload of ARCHIVE_ENTRY_FULL is a valid pool file (pickler.h).
+
+Payload of ARCHIVE_ENTRY_DELTA refers to the previous entry and is:
+
+[number of organisms = N]             64
+[size of pool metadata = MSB]         16
+[pool metadata]                       MSb
+[children]                            ...          N times
+
+Every child is:
+
+[child kind]                          8            archive_child_kind_t
+[number of genes = GN]                32
+[size of genome metadata = GMSB]      16
+[size of genome residue = RSb]        16
+[genome metadata]                     GMSb
+[genome residue]                      RSb          Rounded to bytes
+
+then for ARCHIVE_CHILD_LITERAL:
+
+[genes]                               GN*GSb
+
+or for ARCHIVE_CHILD_DERIVED:
+
+[number of parents = P]               8
+[indices of parents]                  64*P         In the previous generation
+[number of segments = S]              32
+[segments]                            72*S         start, length, parent
+[number of patches = C]               32
+[patches]                             (32+GSb)*C   gene index, gene
+
+Genes of the derived child are copied segment by segment from its parents,
+genes not covered by any segment are zeros, then patches are applied.
+
+ */
+
+/* @enum archive_entry_type
+ * @type uint8
+ * @member ARCHIVE_ENTRY_FULL  0
+ * @member ARCHIVE_ENTRY_DELTA 1
+ */
+typedef enum archive_entry_type_e {
+    ARCHIVE_ENTRY_FULL  = (uint8_t)0,
+    ARCHIVE_ENTRY_DELTA = (uint8_t)1
+} archive_entry_type_t;
+
+typedef enum archive_child_kind_e {
+    ARCHIVE_CHILD_LITERAL = (uint8_t)0,
+    ARCHIVE_CHILD_DERIVED = (uint8_t)1
+} archive_child_kind_t;
+
+typedef struct archive_file_preamble_s {
+    file_control_byte_t initial_byte;
+    uint8_t             version;
+    uint32_t            keyframe_interval;
+} __attribute__((packed, aligned(1))) archive_file_preamble_t;
+
+typedef struct archive_file_entry_preamble_s {
+    file_control_byte_t initial_byte;
+    uint8_t             type;
+    uint64_t            generation;
+    uint64_t            payload_byte_size;
+} __attribute__((packed, aligned(1))) archive_file_entry_preamble_t;
+
+typedef struct archive_file_delta_preamble_s {
+    uint64_t            organisms_number;
+    uint16_t            metadata_byte_size;
+} __attribute__((packed, aligned(1))) archive_file_delta_preamble_t;
+
+typedef struct archive_file_child_preamble_s {
+    uint8_t             kind;
+    uint32_t            length;
+    uint16_t            metadata_byte_size;
+    uint16_t            residue_size_bits;
+} __attribute__((packed, aligned(1))) archive_file_child_preamble_t;
+
+typedef struct archive_file_segment_s {
+    uint32_t            start;
+    uint32_t            length;
+    uint8_t             parent;
+} __attribute__((packed, aligned(1))) archive_file_segment_t;
+
+/* @struct archive_entry
+ * @member uint64 generation
+ * @member size offset
+ * @member archive_entry_type type
+ */
+typedef struct archive_entry_s {
+    uint64_t              generation;
+    // offset of the entry preamble from the start of the file
+    size_t                offset;
+    archive_entry_type_t  type;
+} archive_entry_t;
+
+/* @typedef archive_p
+ * @from_type archive*
+ */
+/* @struct archive
+ * @member file_map* file_mapping
+ * @member uint32 keyframe_interval
+ * @member uint64 entries_number
+ * @member uint64 entries_capacity
+ * @member archive_entry* entries
+ * @member population* last
+ * @member uint32 deltas_since_keyframe
+ */
+typedef struct archive_s {
+    file_map_t       *file_mapping;
+    uint32_t          keyframe_interval;
+    uint64_t          entries_number;
+    uint64_t          entries_capacity;
+    archive_entry_t  *entries;
+    // Copy of the last appended generation which the next delta refers to.
+    // NULL if nothing was appended since the archive was opened.
+    population_t     *last;
+    uint32_t          deltas_since_keyframe;
+} archive_t;
+
+/* @function create_archive
+ * @return archive*
+ * @argument char*
+ * @argument uint32
+ */
+archive_t * create_archive(
+    const char *address, const uint32_t keyframe_interval);
+
+/* @function open_archive
+ * @return archive*
+ * @argument char*
+ */
+archive_t * open_archive(const char *address);
+
+/* @function archive_append_generation
+ * @return void
+ * @argument archive*
+ * @argument uint64
+ * @argument pool*
+ * @argument genome**
+ * @argument generation_lineage*
+ * @argument uint64*
+ */
+void archive_append_generation(
+    archive_t * const, const uint64_t generation,
+    pool_t * const, genome_t ** const,
+    const generation_lineage_t * const lineage,
+    const pool_organisms_num_t * const parents_indices);
+
+/* @function archive_read_generation
+ * @return population*
+ * @argument archive*
+ * @argument uint64
+ */
+population_t * archive_read_generation(
+    const archive_t * const, const uint64_t generation);
+
+/* @function close_archive
+ * @return void
+ * @argument archive*
+ */
+void close_archive(archive_t * const);
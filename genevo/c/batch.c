@@ -0,0 +1,293 @@
+/*
+
+This module contains methods processing the whole population in one call.
+
+ */
+
+#include "batch.h"
+
+/*
+
+Write into `offsets` (organisms_number + 1 items) the index of the first gene
+of every genome in the concatenation of all the genes, and return the total
+number of genes. Outputs of decode_population should have this size.
+
+ */
+uint64_t count_population_genes(
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    uint64_t * const offsets
+) {
+
+    uint64_t genes_number = 0;
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    ) {
+        if (offsets != NULL) offsets[genome_i] = genes_number;
+        genes_number += genomes[genome_i]->length;
+    }
+
+    if (offsets != NULL) offsets[organisms_number] = genes_number;
+
+    return genes_number;
+
+}
+
+typedef struct population_decoder_s {
+    const pool_t                      *pool;
+    genome_t * const                  *genomes;
+    const uint64_t                    *offsets;
+    gene_node_id_t                    *outcome_node_ids;
+    gene_node_id_t                    *income_node_ids;
+    gene_connection_flag_t            *connection_types;
+    gene_edge_weight_unnormalized_t   *weights_unnormalized;
+    gene_edge_weight                  *weights;
+    gene_edge_weight_float            *weights_float;
+} population_decoder_t;
+
+#define OFFSET_OR_NULL(_ARRAY, _OFFSET) \
+    ((_ARRAY) != NULL ? (_ARRAY) + (_OFFSET) : NULL)
+
+void decode_population_body(
+    void * const decoder_void, const uint64_t start, const uint64_t end
+) {
+
+    const population_decoder_t * const decoder = decoder_void;
+
+    for (uint64_t genome_i = start; genome_i < end; genome_i++) {
+
+        const uint64_t offset = decoder->offsets[genome_i];
+
+        if (decoder->weights_float != NULL)
+            decode_genes_float(
+                decoder->pool,
+                decoder->genomes[genome_i]->genes,
+                decoder->genomes[genome_i]->length,
+                OFFSET_OR_NULL(decoder->outcome_node_ids, offset),
+                OFFSET_OR_NULL(decoder->income_node_ids, offset),
+                OFFSET_OR_NULL(decoder->connection_types, offset),
+                OFFSET_OR_NULL(decoder->weights_unnormalized, offset),
+                decoder->weights_float + offset);
+        else
+            decode_genes(
+                decoder->pool,
+                decoder->genomes[genome_i]->genes,
+                decoder->genomes[genome_i]->length,
+                OFFSET_OR_NULL(decoder->outcome_node_ids, offset),
+                OFFSET_OR_NULL(decoder->income_node_ids, offset),
+                OFFSET_OR_NULL(decoder->connection_types, offset),
+                OFFSET_OR_NULL(decoder->weights_unnormalized, offset),
+                OFFSET_OR_NULL(decoder->weights, offset));
+
+    }
+
+}
+
+#undef OFFSET_OR_NULL
+
+/*
+
+Decode genes of all the genomes into arrays (see decode_genes) with
+`threads_number` threads (0 means the number of CPUs). Genes of genome `i`
+are written starting from `offsets[i]`, as given by count_population_genes.
+
+ */
+void decode_population(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint64_t * const offsets,
+    gene_node_id_t * const outcome_node_ids,
+    gene_node_id_t * const income_node_ids,
+    gene_connection_flag_t * const connection_types,
+    gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    gene_edge_weight * const weights,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (pool->node_id_part_bit_size > 64 || pool->weight_part_bit_size > 64) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
+
+    population_decoder_t decoder = {
+        .pool = pool,
+        .genomes = genomes,
+        .offsets = offsets,
+        .outcome_node_ids = outcome_node_ids,
+        .income_node_ids = income_node_ids,
+        .connection_types = connection_types,
+        .weights_unnormalized = weights_unnormalized,
+        .weights = weights,
+        .weights_float = NULL
+    };
+
+    parallel_for(
+        organisms_number, threads_number,
+        decode_population_body, &decoder);
+
+}
+
+/*
+
+Same as decode_population, but normalized weights are decoded with
+decode_genes_float.
+
+ */
+void decode_population_float(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint64_t * const offsets,
+    gene_node_id_t * const outcome_node_ids,
+    gene_node_id_t * const income_node_ids,
+    gene_connection_flag_t * const connection_types,
+    gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    gene_edge_weight_float * const weights,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (pool->node_id_part_bit_size > 64 || pool->weight_part_bit_size > 64) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
+
+    population_decoder_t decoder = {
+        .pool = pool,
+        .genomes = genomes,
+        .offsets = offsets,
+        .outcome_node_ids = outcome_node_ids,
+        .income_node_ids = income_node_ids,
+        .connection_types = connection_types,
+        .weights_unnormalized = weights_unnormalized,
+        .weights = NULL,
+        .weights_float = weights
+    };
+
+    parallel_for(
+        organisms_number, threads_number,
+        decode_population_body, &decoder);
+
+}
+
+/*
+
+Mutate every genome like pairing_season mutates children. Random generators
+are shared by the whole library, so genomes are processed one by one.
+
+ */
+void mutate_population(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const mutation_probability_t change_genes_prob,
+    const gene_mutation_mode_t mutation_mode,
+    const mutation_probability_t flip_bits_prob
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    ) {
+
+        change_genes_in_genome_with_probability(
+            genomes[genome_i], pool, mutation_mode, change_genes_prob);
+
+        flip_bits_in_genome_with_probability(
+            genomes[genome_i], pool, flip_bits_prob);
+
+    }
+
+}
+
+int compare_ranked_genomes(const void *a_void, const void *b_void) {
+
+    const ranked_genome_t * const a = a_void, * const b = b_void;
+
+    // the fittest go first, equal ones keep their order
+    if (a->fitness != b->fitness) return a->fitness < b->fitness ? 1 : -1;
+    return (a->index > b->index) - (a->index < b->index);
+
+}
+
+/*
+
+Produce the next generation: `survivors_number` fittest genomes of
+`genomes_parents` are crossed over and mutated by pairing_season into
+`organisms_number` genomes of `genomes_children`. Children duplicating other
+children are bred again at most `redraws_number` times (see
+pairing_season_unique). Both vectors should be allocated beforehand, so a
+driver can swap them every generation.
+
+ */
+void run_generation(
+    const pool_t * const pool,
+    const genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_organisms_num_t organisms_number,
+    const double * const fitness,
+    const pool_organisms_num_t survivors_number,
+    const replication_type_t replication_type,
+    const blend_coefficient_t blend_coefficient,
+    const mutation_probability_t change_genes_prob,
+    const gene_mutation_mode_t mutation_mode,
+    const mutation_probability_t flip_bits_prob,
+    const uint8_t redraws_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (survivors_number == 0 || survivors_number > organisms_number) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
+
+    DECLARE_MALLOC_ARRAY(
+        ranked_genome_t, ranking, organisms_number, RETURN_VOID_ON_ERR);
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    ) {
+        ranking[genome_i].fitness = fitness[genome_i];
+        ranking[genome_i].index = genome_i;
+    }
+
+    qsort(
+        ranking, organisms_number, sizeof(ranked_genome_t),
+        compare_ranked_genomes);
+
+    DECLARE_MALLOC_LINKS_ARRAY(
+        const genome_t, survivors, survivors_number,
+        free(ranking); RETURN_VOID_ON_ERR);
+
+    for (
+        pool_organisms_num_t survivor_i = 0;
+        survivor_i < survivors_number;
+        survivor_i++
+    )
+        survivors[survivor_i] = genomes_parents[ranking[survivor_i].index];
+
+    free(ranking);
+
+    pairing_season_unique(
+        survivors_number, organisms_number,
+        replication_type, blend_coefficient,
+        change_genes_prob, mutation_mode, flip_bits_prob,
+        survivors, genomes_children, pool->gene_bytes_size,
+        NULL /* lineage */, redraws_number);
+
+    free(survivors);
+
+}
@@ -0,0 +1,135 @@
+/*
+
+This module contains coarse-grained functions processing the whole population
+in one call. They are meant for Python: ctypes releases the GIL for the time of
+every call into the library, so while one of these functions runs, other
+Python threads (I/O, logging) keep working. Calling the per-gene or per-genome
+functions instead would hold the GIL between millions of tiny calls.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "pool.h"
+#include "error.h"
+#include "memory.h"
+#include "pickler.h"
+#include "mutations.h"
+#include "parallel.h"
+
+typedef struct ranked_genome_s {
+    double                fitness;
+    pool_organisms_num_t  index;
+} ranked_genome_t;
+
+// Order of qsort: the fittest genomes go first
+int compare_ranked_genomes(const void *a_void, const void *b_void);
+
+/* @function count_population_genes
+ * @return uint64
+ * @argument genome**
+ * @argument uint64
+ * @argument uint64*
+ */
+uint64_t count_population_genes(
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    uint64_t * const offsets);
+
+/* @function decode_population
+ * @return void
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint64*
+ * @argument uint64*
+ * @argument uint64*
+ * @argument uint8*
+ * @argument int64*
+ * @argument double*
+ * @argument uint16
+ */
+void decode_population(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint64_t * const offsets,
+    gene_node_id_t * const outcome_node_ids,
+    gene_node_id_t * const income_node_ids,
+    gene_connection_flag_t * const connection_types,
+    gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    gene_edge_weight * const weights,
+    const uint16_t threads_number);
+
+/* @function decode_population_float
+ * @return void
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint64*
+ * @argument uint64*
+ * @argument uint64*
+ * @argument uint8*
+ * @argument int64*
+ * @argument float*
+ * @argument uint16
+ */
+void decode_population_float(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint64_t * const offsets,
+    gene_node_id_t * const outcome_node_ids,
+    gene_node_id_t * const income_node_ids,
+    gene_connection_flag_t * const connection_types,
+    gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    gene_edge_weight_float * const weights,
+    const uint16_t threads_number);
+
+/* @function mutate_population
+ * @return void
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument double
+ * @argument gene_mutation_mode
+ * @argument double
+ */
+void mutate_population(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const mutation_probability_t change_genes_prob, const gene_mutation_mode_t,
+    const mutation_probability_t flip_bits_prob);
+
+/* @function run_generation
+ * @return void
+ * @argument pool*
+ * @argument genome**
+ * @argument genome**
+ * @argument uint64
+ * @argument double*
+ * @argument uint64
+ * @argument uint8
+ * @argument double
+ * @argument double
+ * @argument gene_mutation_mode
+ * @argument double
+ * @argument uint8
+ */
+void run_generation(
+    const pool_t * const,
+    const genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_organisms_num_t organisms_number,
+    const double * const fitness,
+    const pool_organisms_num_t survivors_number,
+    const replication_type_t, const blend_coefficient_t,
+    const mutation_probability_t change_genes_prob, const gene_mutation_mode_t,
+    const mutation_probability_t flip_bits_prob,
+    const uint8_t redraws_number);
@@ -0,0 +1,725 @@
+/*
+
+Benchmark driver of the library. It is built and run by `make bench`,
+arguments are passed with `make bench BENCH_ARGS="..."`.
+
+For every standard simple network (see drafts/gene_simple_network.h) a
+population with 2.5 genes per node is created, and the following benchmarks
+are measured on it: creating the pool file, reading it, decoding genes,
+encoding them with encode_genes and genes_to_byte_array, every mode of
+change_genes_with_probability, flipping bits and crossover. Generating state machine states and random generators don't depend
+on the network, they are measured once with size "-".
+
+Every benchmark is repeated until it takes at least the given time. Results
+are printed as tab-separated values with a header line:
+
+    size  gene_bytes  genome_length  benchmark  ops  bytes  ns_per_op  gb_per_s
+
+where `ops` is the number of genes (or numbers) processed and `bytes` is the
+number of bytes of genes read or written. Genomes of big networks are
+truncated, so that the whole population fits into the memory budget.
+
+Usage: bench [-s plant,roundworm,...] [-o organisms] [-m budget in MiB]
+             [-t seconds] [-d directory for pool files]
+
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include <unistd.h>
+
+#include "demiurge.h"
+#include "pickler.h"
+#include "mutations.h"
+#include "state_machine.h"
+#include "rand.h"
+#include "mersenne.h"
+
+// Genes decoded or encoded at once
+#define BENCH_CHUNK_GENES 4096
+// Transitions of the state machine and numbers drawn from the generators
+// per round
+#define BENCH_DRAWS_NUMBER (1 << 20)
+#define BENCH_RANDOM_BUFFER_SIZE (1 << 20)
+#define BENCH_MUTATION_PROBABILITY 0.01
+
+typedef struct bench_network_s {
+    const char                *name;
+    pool_gene_node_id_part_t   node_id_bit_size;
+    pool_gene_weight_part_t    weight_bit_size;
+} bench_network_t;
+
+const bench_network_t bench_networks[] = {
+    { "plant",      5,  6 },
+    { "roundworm",  9, 14 },
+    { "leech",     14, 20 },
+    { "lobster",   17, 22 },
+    { "guppy",     22, 20 },
+    { "frog",      24, 24 }
+};
+
+#define BENCH_NETWORKS_NUMBER \
+    (sizeof(bench_networks) / sizeof(bench_network_t))
+
+typedef struct bench_options_s {
+    const char            *sizes;
+    pool_organisms_num_t   organisms_number;
+    uint64_t               budget_bytes;
+    double                 min_seconds;
+    const char            *directory;
+} bench_options_t;
+
+typedef struct bench_context_s {
+    const bench_network_t  *network;
+    pool_organisms_num_t    organisms_number;
+    pool_gene_byte_size_t   gene_bytes_size;
+    genome_length_t         genome_length;
+    char                    address[4096];
+    // genomes in memory, not mapped to the file
+    pool_t                 *pool;
+    genome_t              **genomes;
+    genome_t              **children;
+    // decoded chunk of genes
+    gene_node_id_t                   outcome_node_ids[BENCH_CHUNK_GENES];
+    gene_node_id_t                   income_node_ids[BENCH_CHUNK_GENES];
+    gene_connection_flag_t           connection_types[BENCH_CHUNK_GENES];
+    gene_edge_weight_unnormalized_t  weights_unnormalized[BENCH_CHUNK_GENES];
+    gene_edge_weight                 weights[BENCH_CHUNK_GENES];
+    gene_edge_weight_float           weights_float[BENCH_CHUNK_GENES];
+    gene_t                           genes[BENCH_CHUNK_GENES];
+    gene_t                          *genes_links[BENCH_CHUNK_GENES];
+    state_machine_t                 *machine;
+    byte_t                           random_buffer[BENCH_RANDOM_BUFFER_SIZE];
+    // keeps the compiler from throwing away the results
+    uint64_t                         sink;
+} bench_context_t;
+
+// Run one round of the benchmark and tell how many ops and bytes it took
+typedef void (*bench_body_t)(
+    bench_context_t * const, uint64_t * const ops, uint64_t * const bytes);
+
+double bench_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+uint64_t genome_bytes(const bench_context_t * const context) {
+    return (uint64_t)context->genome_length * context->gene_bytes_size;
+}
+
+uint64_t population_bytes(const bench_context_t * const context) {
+    return context->organisms_number * genome_bytes(context);
+}
+
+uint64_t population_genes(const bench_context_t * const context) {
+    return context->organisms_number * context->genome_length;
+}
+
+pool_t * allocate_bench_pool(const bench_context_t * const context) {
+
+    pool_t * const pool = allocate_pool();
+    if (pool == NULL) return NULL;
+
+    pool->organisms_number = context->organisms_number;
+    pool->input_neurons_number = 1;
+    pool->output_neurons_number = 1;
+    pool->node_id_part_bit_size = context->network->node_id_bit_size;
+    pool->weight_part_bit_size = context->network->weight_bit_size;
+    pool->gene_bytes_size = context->gene_bytes_size;
+
+    return pool;
+
+}
+
+genome_t ** allocate_bench_genomes(
+    const bench_context_t * const context, const bool allocate_data
+) {
+
+    return allocate_genome_vector(
+        context->organisms_number, allocate_data, context->genome_length,
+        context->gene_bytes_size, BYTES_TO_BITS(genome_bytes(context)));
+
+}
+
+/*
+
+Benchmarks.
+
+ */
+
+void bench_create_pool(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+
+    DECLARE_CONST_MALLOC_OBJECT(population_t, population, RETURN_VOID_ON_ERR);
+
+    population->pool = allocate_bench_pool(context);
+    population->genomes = allocate_bench_genomes(context, false);
+
+    fill_pool(context->address, population, GENERATE_RANDOMNESS);
+    // fill_pool writes the genomes only
+    save_pool(population->pool, population->genomes, POOL_REWRITE_DESCRIPTION);
+
+    destroy_population(population, true, false, true);
+
+    *ops = population_genes(context);
+    *bytes = population_bytes(context);
+
+}
+
+void bench_read_pool(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+
+    pool_t * const pool = read_pool(context->address);
+    if (pool == NULL) return;
+
+    genome_t ** const genomes = read_genomes(pool);
+    if (genomes == NULL) {
+        close_pool(pool);
+        return;
+    }
+
+    // read_genomes parses headers only, genes are read as a consumer would
+    uint64_t sum = 0;
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < pool->organisms_number;
+        genome_i++
+    ) {
+        const genome_t * const genome = genomes[genome_i];
+        const uint64_t size = (uint64_t)genome->length * pool->gene_bytes_size;
+        for (uint64_t byte_i = 0; byte_i < size; byte_i++)
+            sum += genome->genes[byte_i];
+    }
+    context->sink += sum;
+
+    // genomes point into the file mapping
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < pool->organisms_number;
+        genome_i++
+    )
+        free(genomes[genome_i]);
+    free_genomes_ptrs(genomes);
+    close_pool(pool);
+
+    *ops = population_genes(context);
+    *bytes = population_bytes(context);
+
+}
+
+void bench_decode_genes(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < context->organisms_number;
+        genome_i++
+    )
+        for (
+            genome_length_t gene_i = 0;
+            gene_i < context->genome_length;
+            gene_i += BENCH_CHUNK_GENES
+        ) {
+            const genome_length_t left = context->genome_length - gene_i;
+            decode_genes(
+                context->pool,
+                context->genomes[genome_i]->genes +
+                    (uint64_t)gene_i * context->gene_bytes_size,
+                left < BENCH_CHUNK_GENES ? left : BENCH_CHUNK_GENES,
+                context->outcome_node_ids, context->income_node_ids,
+                context->connection_types, context->weights_unnormalized,
+                context->weights);
+            context->sink += context->outcome_node_ids[0];
+        }
+
+    *ops = population_genes(context);
+    *bytes = population_bytes(context);
+
+}
+
+void bench_decode_genes_float(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < context->organisms_number;
+        genome_i++
+    )
+        for (
+            genome_length_t gene_i = 0;
+            gene_i < context->genome_length;
+            gene_i += BENCH_CHUNK_GENES
+        ) {
+            const genome_length_t left = context->genome_length - gene_i;
+            decode_genes_float(
+                context->pool,
+                context->genomes[genome_i]->genes +
+                    (uint64_t)gene_i * context->gene_bytes_size,
+                left < BENCH_CHUNK_GENES ? left : BENCH_CHUNK_GENES,
+                context->outcome_node_ids, context->income_node_ids,
+                context->connection_types, context->weights_unnormalized,
+                context->weights_float);
+            context->sink += context->outcome_node_ids[0];
+        }
+
+    *ops = population_genes(context);
+    *bytes = population_bytes(context);
+
+}
+
+void bench_encode_genes(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+
+    // genes of the first chunk are written over every chunk of the population
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < context->organisms_number;
+        genome_i++
+    )
+        for (
+            genome_length_t gene_i = 0;
+            gene_i < context->genome_length;
+            gene_i += BENCH_CHUNK_GENES
+        ) {
+            const genome_length_t left = context->genome_length - gene_i;
+            encode_genes(
+                context->pool,
+                context->genomes[genome_i]->genes +
+                    (uint64_t)gene_i * context->gene_bytes_size,
+                left < BENCH_CHUNK_GENES ? left : BENCH_CHUNK_GENES,
+                context->outcome_node_ids, context->income_node_ids,
+                context->connection_types, context->weights_unnormalized,
+                NULL);
+        }
+
+    *ops = population_genes(context);
+    *bytes = population_bytes(context);
+
+}
+
+void bench_genes_to_byte_array(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+
+    const genome_length_t genes_number =
+        context->genome_length < BENCH_CHUNK_GENES
+        ? context->genome_length : BENCH_CHUNK_GENES;
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < context->organisms_number;
+        genome_i++
+    ) {
+        gene_byte_t * const array = genes_to_byte_array(
+            context->genes_links, context->pool, genes_number);
+        if (array == NULL) return;
+        context->sink += array[0];
+        free_genes_byte_array(array);
+    }
+
+    *ops = context->organisms_number * genes_number;
+    *bytes = *ops * context->gene_bytes_size;
+
+}
+
+void bench_change_genes(
+    bench_context_t * const context, const gene_mutation_mode_t mode,
+    uint64_t * const ops, uint64_t * const bytes
+) {
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < context->organisms_number;
+        genome_i++
+    )
+        change_genes_with_probability(
+            context->genomes[genome_i]->genes, context->gene_bytes_size,
+            context->genome_length, mode, BENCH_MUTATION_PROBABILITY);
+
+    *ops = population_genes(context);
+    *bytes = population_bytes(context);
+
+}
+
+void bench_randomize_genes(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+    bench_change_genes(context, RANDOMIZE_GENES, ops, bytes);
+}
+
+void bench_zero_genes(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+    bench_change_genes(context, ZERO_GENES, ops, bytes);
+}
+
+void bench_repeat_neighbor_genes(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+    bench_change_genes(context, REPEAT_NEIGHBOR_GENES, ops, bytes);
+}
+
+void bench_combine_genes_mutation(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+    bench_change_genes(context, COMBINE_GENES_MUTATION, ops, bytes);
+}
+
+void bench_flip_bits(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < context->organisms_number;
+        genome_i++
+    )
+        flip_bits_with_probability(
+            context->genomes[genome_i]->genes,
+            genome_bytes(context), BENCH_MUTATION_PROBABILITY);
+
+    *ops = population_genes(context);
+    *bytes = population_bytes(context);
+
+}
+
+void bench_crossover(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+
+    crossover_genomes_combinations(
+        context->organisms_number, context->organisms_number, 2, 0.5,
+        (const genome_t * const *)context->genomes, context->children,
+        context->gene_bytes_size, NULL, NULL);
+
+    *ops = population_genes(context);
+    *bytes = population_bytes(context);
+
+}
+
+void bench_machine_next_state(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+
+    for (uint32_t draw = 0; draw < BENCH_DRAWS_NUMBER; draw++)
+        machine_next_state(context->machine);
+    context->sink += context->machine->current_state;
+
+    *ops = BENCH_DRAWS_NUMBER;
+    *bytes = 0;
+
+}
+
+// Generators are declared pure, so they are called through a volatile pointer
+// to keep the compiler from drawing a single number.
+#define DEFINE_RNG_BENCH(_NAME, _TYPE, _GENERATOR)                             \
+    void bench_ ## _NAME(                                                      \
+        bench_context_t * const context,                                       \
+        uint64_t * const ops, uint64_t * const bytes                           \
+    ) {                                                                        \
+        _TYPE (* volatile generator)(void) = _GENERATOR;                       \
+        _TYPE (* const draw_number)(void) = generator;                         \
+        uint64_t sum = 0;                                                      \
+        for (uint32_t draw = 0; draw < BENCH_DRAWS_NUMBER; draw++)             \
+            sum += draw_number();                                              \
+        context->sink += sum;                                                  \
+        *ops = BENCH_DRAWS_NUMBER;                                             \
+        *bytes = BENCH_DRAWS_NUMBER * sizeof(_TYPE);                           \
+    }
+
+DEFINE_RNG_BENCH(xorshift128p, uint64_t, xorshift128p)
+DEFINE_RNG_BENCH(lcg_rand, uint32_t, lcg_rand)
+DEFINE_RNG_BENCH(mersenne_genrand64, unsigned long long, mersenne_genrand64_int64)
+
+#undef DEFINE_RNG_BENCH
+
+void bench_fill_with_randomness(
+    bench_context_t * const context, uint64_t * const ops, uint64_t * const bytes
+) {
+
+    fill_bytes_with_randomness(context->random_buffer, BENCH_RANDOM_BUFFER_SIZE);
+    context->sink += context->random_buffer[0];
+
+    *ops = BENCH_RANDOM_BUFFER_SIZE;
+    *bytes = BENCH_RANDOM_BUFFER_SIZE;
+
+}
+
+/*
+
+Driver.
+
+ */
+
+void run_benchmark(
+    const bench_options_t * const options,
+    bench_context_t * const context,
+    const char * const size_name, const char * const benchmark_name,
+    const bench_body_t body
+) {
+
+    uint64_t total_ops = 0, total_bytes = 0;
+    double elapsed = 0;
+
+    do {
+
+        uint64_t ops = 0, bytes = 0;
+
+        ERROR_LEVEL = ERR_OK;
+        const double started = bench_now();
+        body(context, &ops, &bytes);
+        elapsed += bench_now() - started;
+
+        if (ERROR_LEVEL != ERR_OK || ops == 0) {
+            fprintf(
+                stderr, "%s\t%s: error %d\n",
+                size_name, benchmark_name, ERROR_LEVEL);
+            return;
+        }
+
+        total_ops += ops;
+        total_bytes += bytes;
+
+    } while (elapsed < options->min_seconds);
+
+    printf(
+        "%s\t%u\t%u\t%s\t%lu\t%lu\t%.3f\t%.3f\n",
+        size_name, context->gene_bytes_size, context->genome_length,
+        benchmark_name, total_ops, total_bytes,
+        elapsed * 1e9 / total_ops, total_bytes / elapsed / 1e9);
+    fflush(stdout);
+
+}
+
+bool size_is_selected(const char * const sizes, const char * const name) {
+
+    if (sizes == NULL) return true;
+
+    const size_t length = strlen(name);
+    for (const char *item = sizes; item != NULL; ) {
+        if (strncmp(item, name, length) == 0 &&
+            (item[length] == ',' || item[length] == '\0'))
+            return true;
+        item = strchr(item, ',');
+        if (item != NULL) item++;
+    }
+
+    return false;
+
+}
+
+/*
+
+Prepare the population of the network in memory, so that benchmarks don't
+depend on each other.
+
+ */
+bool setup_network(
+    const bench_options_t * const options,
+    bench_context_t * const context, const bench_network_t * const network
+) {
+
+    context->network = network;
+    context->organisms_number = options->organisms_number;
+    context->gene_bytes_size =
+        (network->node_id_bit_size * 2 + network->weight_bit_size) / 8;
+
+    // 2.5 genes per node, but no more than the budget allows
+    uint64_t genome_length = ((uint64_t)1 << network->node_id_bit_size) * 5 / 2;
+    const uint64_t budget_length =
+        options->budget_bytes /
+        (options->organisms_number * context->gene_bytes_size);
+    if (genome_length > budget_length) genome_length = budget_length;
+    // genome_bit_size of allocate_genome_vector is 32-bit
+    if (genome_length * context->gene_bytes_size > UINT32_MAX / 8)
+        genome_length = UINT32_MAX / 8 / context->gene_bytes_size;
+    if (genome_length == 0) genome_length = 1;
+    context->genome_length = genome_length;
+
+    snprintf(
+        context->address, sizeof(context->address), "%s/bench-%d-%s.pool",
+        options->directory, (int)getpid(), network->name);
+
+    context->pool = allocate_bench_pool(context);
+    context->genomes = allocate_bench_genomes(context, true);
+    context->children = allocate_bench_genomes(context, true);
+    if (
+        ERROR_LEVEL != ERR_OK || context->pool == NULL ||
+        context->genomes == NULL || context->children == NULL
+    )
+        return false;
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < context->organisms_number;
+        genome_i++
+    )
+        fill_bytes_with_randomness(
+            context->genomes[genome_i]->genes,
+            (uint32_t)genome_bytes(context));
+
+    // genes to encode are taken from the first chunk of the first genome
+    const genome_length_t chunk_genes =
+        context->genome_length < BENCH_CHUNK_GENES
+        ? context->genome_length : BENCH_CHUNK_GENES;
+    decode_genes(
+        context->pool, context->genomes[0]->genes, chunk_genes,
+        context->outcome_node_ids, context->income_node_ids,
+        context->connection_types, context->weights_unnormalized,
+        context->weights);
+    for (genome_length_t gene_i = 0; gene_i < chunk_genes; gene_i++) {
+        context->genes[gene_i] = (gene_t){
+            .outcome_node_id = context->outcome_node_ids[gene_i],
+            .income_node_id = context->income_node_ids[gene_i],
+            .connection_type = context->connection_types[gene_i],
+            .weight_unnormalized = context->weights_unnormalized[gene_i],
+            .weight = context->weights[gene_i]
+        };
+        context->genes_links[gene_i] = &context->genes[gene_i];
+    }
+
+    return ERROR_LEVEL == ERR_OK;
+
+}
+
+void teardown_network(bench_context_t * const context) {
+
+    if (context->genomes != NULL)
+        destroy_genomes_vector(
+            context->organisms_number, true, true, context->genomes);
+    if (context->children != NULL)
+        destroy_genomes_vector(
+            context->organisms_number, true, true, context->children);
+    if (context->pool != NULL) destroy_pool(context->pool, false);
+
+    context->pool = NULL;
+    context->genomes = NULL;
+    context->children = NULL;
+
+    unlink(context->address);
+
+}
+
+typedef struct bench_entry_s {
+    const char   *name;
+    bench_body_t  body;
+} bench_entry_t;
+
+const bench_entry_t network_benchmarks[] = {
+    // read_pool reads the file written by create_pool
+    { "create_pool",             bench_create_pool },
+    { "read_pool",               bench_read_pool },
+    { "decode_genes",            bench_decode_genes },
+    { "decode_genes_float",      bench_decode_genes_float },
+    { "encode_genes",            bench_encode_genes },
+    { "genes_to_byte_array",     bench_genes_to_byte_array },
+    { "randomize_genes",         bench_randomize_genes },
+    { "zero_genes",              bench_zero_genes },
+    { "repeat_neighbor_genes",   bench_repeat_neighbor_genes },
+    { "combine_genes_mutation",  bench_combine_genes_mutation },
+    { "flip_bits",               bench_flip_bits },
+    { "crossover",               bench_crossover }
+};
+
+const bench_entry_t common_benchmarks[] = {
+    { "machine_next_state",      bench_machine_next_state },
+    { "xorshift128p",            bench_xorshift128p },
+    { "lcg_rand",                bench_lcg_rand },
+    { "mersenne_genrand64",      bench_mersenne_genrand64 },
+    { "fill_with_randomness",    bench_fill_with_randomness }
+};
+
+#define ENTRIES_NUMBER(_ENTRIES) (sizeof(_ENTRIES) / sizeof(bench_entry_t))
+
+int main(int argc, char **argv) {
+
+    bench_options_t options = {
+        .sizes = NULL,
+        .organisms_number = 16,
+        .budget_bytes = (uint64_t)64 << 20,
+        .min_seconds = 0.25,
+        .directory = "."
+    };
+
+    int option;
+    while ((option = getopt(argc, argv, "s:o:m:t:d:")) != -1)
+        switch (option) {
+            case 's': options.sizes = optarg; break;
+            case 'o': options.organisms_number = strtoull(optarg, NULL, 10); break;
+            case 'm': options.budget_bytes = strtoull(optarg, NULL, 10) << 20; break;
+            case 't': options.min_seconds = strtod(optarg, NULL); break;
+            case 'd': options.directory = optarg; break;
+            default:
+                fprintf(
+                    stderr,
+                    "usage: %s [-s sizes] [-o organisms] [-m budget MiB] "
+                    "[-t seconds] [-d directory]\n", argv[0]);
+                return 1;
+        }
+
+    if (options.organisms_number < 2) options.organisms_number = 2;
+
+    bench_context_t * const context = calloc(1, sizeof(bench_context_t));
+    if (context == NULL) return 1;
+
+    printf(
+        "size\tgene_bytes\tgenome_length\tbenchmark\t"
+        "ops\tbytes\tns_per_op\tgb_per_s\n");
+
+    for (uint8_t network_i = 0; network_i < BENCH_NETWORKS_NUMBER; network_i++) {
+
+        const bench_network_t * const network = &bench_networks[network_i];
+        if (!size_is_selected(options.sizes, network->name)) continue;
+
+        if (!setup_network(&options, context, network)) {
+            fprintf(stderr, "%s: cannot set up the population\n", network->name);
+            teardown_network(context);
+            continue;
+        }
+
+        for (uint8_t entry_i = 0; entry_i < ENTRIES_NUMBER(network_benchmarks); entry_i++)
+            run_benchmark(
+                &options, context, network->name,
+                network_benchmarks[entry_i].name,
+                network_benchmarks[entry_i].body);
+
+        teardown_network(context);
+
+    }
+
+    // benchmarks not depending on the network
+    context->gene_bytes_size = 0;
+    context->genome_length = 0;
+
+    context->machine = generate_state_machine(2);
+    state_machine_diag_distribution(context->machine, 0.5, 0.5);
+    init_state_machine(context->machine, 0);
+
+    for (uint8_t entry_i = 0; entry_i < ENTRIES_NUMBER(common_benchmarks); entry_i++)
+        run_benchmark(
+            &options, context, "-",
+            common_benchmarks[entry_i].name,
+            common_benchmarks[entry_i].body);
+
+    destroy_state_machine(context->machine);
+
+    fprintf(stderr, "sink %lu\n", context->sink);
+    free(context);
+
+    return 0;
+
+}
+
+#undef ENTRIES_NUMBER
+#undef BENCH_NETWORKS_NUMBER
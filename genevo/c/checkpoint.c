@@ -0,0 +1,328 @@
+/*
+
+This module contains methods for writing and reading checkpoints of the run.
+
+ */
+
+#include "checkpoint.h"
+
+#define CHECKPOINT_FILE_SIZE(_FITNESS_NUMBER, _SELECTION_SIZE, _POOL_SIZE)     \
+    (sizeof(checkpoint_file_preamble_t) +                                      \
+     sizeof(checkpoint_file_rng_t) +                                           \
+     (_FITNESS_NUMBER) * sizeof(uint64_t) +                                    \
+     (_SELECTION_SIZE) +                                                       \
+     (_POOL_SIZE) +                                                            \
+     sizeof(CHECKPOINT_TERMINAL_BYTE))
+
+void destroy_checkpoint_writer(checkpoint_writer_t * const writer) {
+    FREE_NOT_NULL(writer->address);
+    FREE_NOT_NULL(writer->temp_address);
+    free(writer);
+}
+
+/*
+
+Worker of the background thread. Everything was already copied into the
+mapping, so the only slow thing left is the writeback of dirty pages.
+
+ */
+void * flush_checkpoint_worker(void *writer_void) {
+
+    checkpoint_writer_t * const writer = writer_void;
+    writer->status = ERR_OK;
+
+    if (msync(
+        writer->file_mapping->data, writer->file_mapping->size, MS_SYNC
+    ) != 0)
+        writer->status = ERR_FILE_CANNOT_SYNC;
+
+    close_file(writer->file_mapping);
+    writer->file_mapping = NULL;
+
+    if (writer->status != ERR_OK) {
+        unlink(writer->temp_address);
+        return NULL;
+    }
+
+    if (rename(writer->temp_address, writer->address) != 0)
+        writer->status = ERR_FILE_CANNOT_RENAME;
+
+    return NULL;
+
+}
+
+/*
+
+Copy the run state into the new checkpoint file and start flushing it in the
+background. States of the random generators are captured at the moment of the
+call, so the caller may proceed with the next generation right away.
+! Call wait_checkpoint before the next checkpoint is written to the same
+  address.
+
+ */
+checkpoint_writer_t * write_checkpoint_async(
+    const char *address, const run_state_t * const run,
+    pool_t * const pool, genome_t ** const genomes
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    DECLARE_CONST_MALLOC_OBJECT(
+        checkpoint_writer_t, writer, RETURN_NULL_ON_ERR);
+
+    const size_t address_length = strlen(address);
+    writer->address = malloc(address_length + 1);
+    writer->temp_address =
+        malloc(address_length + sizeof(CHECKPOINT_TEMP_SUFFIX));
+    writer->file_mapping = NULL;
+
+    if (writer->address == NULL || writer->temp_address == NULL)
+        DESTROY_AND_EXIT(
+            destroy_checkpoint_writer, writer, RETURN_NULL_ON_ERR);
+
+    memcpy(writer->address, address, address_length + 1);
+    memcpy(writer->temp_address, address, address_length);
+    memcpy(
+        writer->temp_address + address_length,
+        CHECKPOINT_TEMP_SUFFIX, sizeof(CHECKPOINT_TEMP_SUFFIX));
+
+    const size_t pool_byte_size = get_pool_file_size(pool, genomes);
+    const size_t file_size = CHECKPOINT_FILE_SIZE(
+        run->fitness_number, run->selection_state_byte_size, pool_byte_size);
+
+    writer->file_mapping =
+        open_file(writer->temp_address, OPEN_MODE_WRITE, file_size - 1);
+    if (ERROR_LEVEL != ERR_OK) {
+        destroy_checkpoint_writer(writer);
+        return NULL;
+    }
+
+    // preamble
+    checkpoint_file_preamble_t * const preamble = writer->file_mapping->data;
+    preamble->initial_byte = CHECKPOINT_INITIAL_BYTE;
+    preamble->version = CHECKPOINT_FORMAT_VERSION;
+    COPY_MEMBER_HTON(generation,                run, preamble);
+    COPY_MEMBER_HTON(fitness_number,            run, preamble);
+    COPY_MEMBER_HTON(selection_state_byte_size, run, preamble);
+    preamble->pool_byte_size = HTON((uint64_t)pool_byte_size);
+    preamble->rng_initial_byte = CHECKPOINT_RNG_INITIAL_BYTE;
+
+    // random generators
+    rng_states_t states;
+    save_rng_states(&states);
+
+    checkpoint_file_rng_t * const rng = (void *)(preamble + 1);
+    rng->xorshift128p[0] = HTON(states.xorshift128p[0]);
+    rng->xorshift128p[1] = HTON(states.xorshift128p[1]);
+    rng->lcg = HTON(states.lcg);
+    rng->mersenne_index = HTON((uint32_t)states.mersenne_index);
+    for (uint32_t i = 0; i < MERSENNE_STATE_SIZE; i++)
+        rng->mersenne[i] = HTON((uint64_t)states.mersenne[i]);
+    rng->terminal_byte = CHECKPOINT_RNG_TERMINAL_BYTE;
+
+    // fitness values are dumped bit by bit as 64-bit numbers
+    byte_t *position = (void *)(rng + 1);
+    for (uint64_t i = 0; i < run->fitness_number; i++) {
+        uint64_t fitness_bits;
+        memcpy(&fitness_bits, &run->fitness[i], sizeof(fitness_bits));
+        fitness_bits = HTON(fitness_bits);
+        memcpy(position, &fitness_bits, sizeof(fitness_bits));
+        position += sizeof(fitness_bits);
+    }
+
+    if (run->selection_state_byte_size > 0)
+        memcpy(
+            position, run->selection_state, run->selection_state_byte_size);
+    position += run->selection_state_byte_size;
+
+    save_pool_to_memory(
+        pool, genomes,
+        POOL_COPY_DATA | POOL_COPY_METADATA | POOL_REWRITE_DESCRIPTION,
+        position);
+    position += pool_byte_size;
+
+    *(file_control_byte_t *)position = CHECKPOINT_TERMINAL_BYTE;
+
+    if (pthread_create(
+        &writer->thread, NULL, flush_checkpoint_worker, writer) != 0
+    ) {
+        close_file(writer->file_mapping);
+        unlink(writer->temp_address);
+        destroy_checkpoint_writer(writer);
+        ERROR_LEVEL = ERR_CANNOT_SPAWN_THREAD;
+        return NULL;
+    }
+
+    return writer;
+
+}
+
+/*
+
+Block until the checkpoint is on the disk. ERROR_LEVEL is set to the status of
+the background flushing. The writer is destroyed after this call.
+
+ */
+void wait_checkpoint(checkpoint_writer_t * const writer) {
+
+    pthread_join(writer->thread, NULL);
+    ERROR_LEVEL = writer->status;
+    destroy_checkpoint_writer(writer);
+
+}
+
+void write_checkpoint(
+    const char *address, const run_state_t * const run,
+    pool_t * const pool, genome_t ** const genomes
+) {
+
+    checkpoint_writer_t * const writer =
+        write_checkpoint_async(address, run, pool, genomes);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    wait_checkpoint(writer);
+
+}
+
+#define CHECKPOINT_FAIL_CONDITION(_CONDITION, _ERR_CONST)                      \
+    if (_CONDITION) {                                                          \
+        ERROR_LEVEL = (_ERR_CONST); close_file(mapping); return NULL; }
+
+/*
+
+Map the checkpoint back into memory. Genomes of the returned checkpoint point
+right into the mapping, which is private, so they can be changed without
+touching the checkpoint file. If restore_rng is true, all the random
+generators will continue from the states they had when checkpoint was made.
+
+ */
+checkpoint_t * read_checkpoint(const char *address, const bool restore_rng) {
+
+    file_map_t * const mapping =
+        open_file(address, OPEN_MODE_COPY_ON_WRITE, 0);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    CHECKPOINT_FAIL_CONDITION(
+        mapping->size < CHECKPOINT_FILE_SIZE(0, 0, 0),
+        ERR_CHECKPOINT_CORRUPT_SIZE);
+
+    const checkpoint_file_preamble_t * const preamble = mapping->data;
+
+    CHECKPOINT_FAIL_CONDITION(
+        preamble->initial_byte != CHECKPOINT_INITIAL_BYTE,
+        ERR_CHECKPOINT_CORRUPT_START);
+
+    CHECKPOINT_FAIL_CONDITION(
+        preamble->version != CHECKPOINT_FORMAT_VERSION,
+        ERR_CHECKPOINT_WRONG_VERSION);
+
+    CHECKPOINT_FAIL_CONDITION(
+        preamble->rng_initial_byte != CHECKPOINT_RNG_INITIAL_BYTE,
+        ERR_CHECKPOINT_CORRUPT_RNG);
+
+    const checkpoint_file_rng_t * const rng = (void *)(preamble + 1);
+
+    CHECKPOINT_FAIL_CONDITION(
+        rng->terminal_byte != CHECKPOINT_RNG_TERMINAL_BYTE,
+        ERR_CHECKPOINT_CORRUPT_RNG);
+
+    const uint64_t fitness_number = NTOH(preamble->fitness_number);
+    const uint32_t selection_state_byte_size =
+        NTOH(preamble->selection_state_byte_size);
+    const uint64_t pool_byte_size = NTOH(preamble->pool_byte_size);
+
+    CHECKPOINT_FAIL_CONDITION(
+        mapping->size != CHECKPOINT_FILE_SIZE(
+            fitness_number, selection_state_byte_size, pool_byte_size),
+        ERR_CHECKPOINT_CORRUPT_SIZE);
+
+    CHECKPOINT_FAIL_CONDITION(
+        *((file_control_byte_t *)mapping->data + mapping->size - 1) !=
+            CHECKPOINT_TERMINAL_BYTE,
+        ERR_CHECKPOINT_CORRUPT_END);
+
+    checkpoint_t * const checkpoint = malloc(sizeof(checkpoint_t));
+    double * const fitness = malloc(sizeof(double) * fitness_number);
+    if (checkpoint == NULL || fitness == NULL) {
+        FREE_NOT_NULL(checkpoint);
+        FREE_NOT_NULL(fitness);
+        close_file(mapping);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    checkpoint->file_mapping = mapping;
+    checkpoint->run.generation = NTOH(preamble->generation);
+    checkpoint->run.fitness_number = fitness_number;
+    checkpoint->run.fitness = fitness;
+    checkpoint->run.selection_state_byte_size = selection_state_byte_size;
+
+    byte_t *position = (void *)(rng + 1);
+    for (uint64_t i = 0; i < fitness_number; i++) {
+        uint64_t fitness_bits;
+        memcpy(&fitness_bits, position, sizeof(fitness_bits));
+        fitness_bits = NTOH(fitness_bits);
+        memcpy(&fitness[i], &fitness_bits, sizeof(fitness_bits));
+        position += sizeof(fitness_bits);
+    }
+
+    checkpoint->run.selection_state =
+        selection_state_byte_size > 0 ? position : NULL;
+    position += selection_state_byte_size;
+
+    checkpoint->genomes = NULL;
+    checkpoint->pool = read_pool_from_memory(position, pool_byte_size);
+    if (ERROR_LEVEL != ERR_OK) {
+        const err_status_t status = ERROR_LEVEL;
+        checkpoint->pool = NULL;
+        close_checkpoint(checkpoint);
+        ERROR_LEVEL = status;
+        return NULL;
+    }
+
+    checkpoint->genomes = read_genomes(checkpoint->pool);
+    if (ERROR_LEVEL != ERR_OK) {
+        const err_status_t status = ERROR_LEVEL;
+        close_checkpoint(checkpoint);
+        ERROR_LEVEL = status;
+        return NULL;
+    }
+
+    if (restore_rng) {
+
+        rng_states_t states;
+        states.xorshift128p[0] = NTOH(rng->xorshift128p[0]);
+        states.xorshift128p[1] = NTOH(rng->xorshift128p[1]);
+        states.lcg = NTOH(rng->lcg);
+        states.mersenne_index = NTOH(rng->mersenne_index);
+        for (uint32_t i = 0; i < MERSENNE_STATE_SIZE; i++)
+            states.mersenne[i] = NTOH(rng->mersenne[i]);
+
+        restore_rng_states(&states);
+
+    }
+
+    return checkpoint;
+
+}
+
+#undef CHECKPOINT_FAIL_CONDITION
+
+void close_checkpoint(checkpoint_t * const checkpoint) {
+
+    if (checkpoint->genomes != NULL) {
+        for (
+            pool_organisms_num_t genome_i = 0;
+            genome_i < checkpoint->pool->organisms_number;
+            genome_i++
+        )
+            free(checkpoint->genomes[genome_i]);
+        free_genomes_ptrs(checkpoint->genomes);
+    }
+
+    if (checkpoint->pool != NULL) close_pool(checkpoint->pool);
+
+    FREE_NOT_NULL(checkpoint->run.fitness);
+    close_file(checkpoint->file_mapping);
+    free(checkpoint);
+
+}
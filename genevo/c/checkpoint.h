@@ -0,0 +1,167 @@
+/*
+
+This module contains methods for saving the whole state of an evolutionary run
+(the pool, states of random generators and run metadata) into a single file
+and restoring it back, so long jobs can survive preemption.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <pthread.h>
+
+#include "pool.h"
+#include "error.h"
+#include "files.h"
+#include "types.h"
+#include "memory.h"
+#include "rand.h"
+#include "pickler.h"
+
+#define CHECKPOINT_FORMAT_VERSION     (uint8_t)1
+
+#define CHECKPOINT_INITIAL_BYTE       (file_control_byte_t)0xC0
+#define CHECKPOINT_RNG_INITIAL_BYTE   (file_control_byte_t)0xC1
+#define CHECKPOINT_RNG_TERMINAL_BYTE  (file_control_byte_t)0xC2
+#define CHECKPOINT_TERMINAL_BYTE      (file_control_byte_t)0xC3
+
+// Checkpoint is written into the file with this suffix first and renamed when
+// it is completely flushed, so a crash never leaves a half-written checkpoint.
+#define CHECKPOINT_TEMP_SUFFIX        ".tmp"
+
+/*
+
+Structure of the checkpoint file is the following (network byte order is used
+for all the numbers):
+
+Content                               Size (bits)  Note
+----------                            ----------   ----------
+CHECKPOINT_INITIAL_BYTE               8
+[format version]                      8
+[generation number]                   64
+[number of fitness values = F]        64
+[size of selection state = SSB]       32
+[size of the pool dump = PSB]         64
+CHECKPOINT_RNG_INITIAL_BYTE           8
+[xorshift128p state]                  128
+[LCG state]                           32
+[Mersenne twister index]              32
+[Mersenne twister state]              312*64
+CHECKPOINT_RNG_TERMINAL_BYTE          8
+[fitness values]                      64*F         IEEE 754 doubles
+[selection state]                     SSb          Opaque bytes of the caller
+[pool dump]                           PSb          Valid pool file (pickler.h)
+CHECKPOINT_TERMINAL_BYTE              8
+
+ */
+
+typedef struct checkpoint_file_preamble_s {
+    file_control_byte_t initial_byte;
+    uint8_t             version;
+    uint64_t            generation;
+    uint64_t            fitness_number;
+    uint32_t            selection_state_byte_size;
+    uint64_t            pool_byte_size;
+    file_control_byte_t rng_initial_byte;
+} __attribute__((packed, aligned(1))) checkpoint_file_preamble_t;
+
+typedef struct checkpoint_file_rng_s {
+    uint64_t            xorshift128p[2];
+    uint32_t            lcg;
+    uint32_t            mersenne_index;
+    uint64_t            mersenne[MERSENNE_STATE_SIZE];
+    file_control_byte_t terminal_byte;
+} __attribute__((packed, aligned(1))) checkpoint_file_rng_t;
+
+/* @struct run_state
+ * @member uint64 generation
+ * @member uint64 fitness_number
+ * @member double* fitness
+ * @member uint32 selection_state_byte_size
+ * @member uint8* selection_state
+ */
+typedef struct run_state_s {
+    uint64_t  generation;
+    uint64_t  fitness_number;
+    double   *fitness;
+    uint32_t  selection_state_byte_size;
+    byte_t   *selection_state;
+} run_state_t;
+
+/* @typedef checkpoint_p
+ * @from_type checkpoint*
+ */
+/* @struct checkpoint
+ * @member run_state run
+ * @member pool* pool
+ * @member genome** genomes
+ * @member file_map* file_mapping
+ */
+typedef struct checkpoint_s {
+    run_state_t   run;
+    pool_t       *pool;
+    genome_t    **genomes;
+    // Genomes and run.selection_state point into this mapping
+    file_map_t   *file_mapping;
+} checkpoint_t;
+
+/* @struct checkpoint_writer
+ * @member char* address
+ * @member char* temp_address
+ * @member file_map* file_mapping
+ * @member uint8 status
+ */
+typedef struct checkpoint_writer_s {
+    char         *address;
+    char         *temp_address;
+    file_map_t   *file_mapping;
+    err_status_t  status;
+    pthread_t     thread;
+} checkpoint_writer_t;
+
+/* @function write_checkpoint_async
+ * @return checkpoint_writer*
+ * @argument char*
+ * @argument run_state*
+ * @argument pool*
+ * @argument genome**
+ */
+checkpoint_writer_t * write_checkpoint_async(
+    const char *address, const run_state_t * const,
+    pool_t * const, genome_t ** const);
+
+/* @function wait_checkpoint
+ * @return void
+ * @argument checkpoint_writer*
+ */
+void wait_checkpoint(checkpoint_writer_t * const);
+
+/* @function write_checkpoint
+ * @return void
+ * @argument char*
+ * @argument run_state*
+ * @argument pool*
+ * @argument genome**
+ */
+void write_checkpoint(
+    const char *address, const run_state_t * const,
+    pool_t * const, genome_t ** const);
+
+/* @function read_checkpoint
+ * @return checkpoint*
+ * @argument char*
+ * @argument bool
+ */
+checkpoint_t * read_checkpoint(const char *address, const bool restore_rng);
+
+/* @function close_checkpoint
+ * @return void
+ * @argument checkpoint*
+ */
+void close_checkpoint(checkpoint_t * const);
@@ -0,0 +1,503 @@
+/*
+
+This module contains methods for computing and verifying checksums of pools.
+
+ */
+
+#include "checksum.h"
+
+// Reflected polynomial of CRC32C (Castagnoli)
+#define CRC32C_POLYNOMIAL 0x82F63B78U
+
+uint32_t crc32c_tables[8][256];
+
+pthread_once_t crc32c_init_once = PTHREAD_ONCE_INIT;
+
+uint32_t crc32c_software(uint32_t, const byte_t *, size_t);
+uint32_t (*crc32c_implementation)(uint32_t, const byte_t *, size_t) =
+    crc32c_software;
+
+/*
+
+Table fallback processes 8 bytes at once (slicing-by-8).
+
+ */
+uint32_t crc32c_software(uint32_t crc, const byte_t *data, size_t size) {
+
+    while (size > 0 && ((uintptr_t)data & 7) != 0) {
+        crc = crc32c_tables[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+        size--;
+    }
+
+    for (; size >= 8; size -= 8, data += 8) {
+        uint32_t low, high;
+        memcpy(&low, data, sizeof(low));
+        memcpy(&high, data + 4, sizeof(high));
+        #ifndef IS_LITTLE_ENDIAN
+        low = __builtin_bswap32(low);
+        high = __builtin_bswap32(high);
+        #endif
+        low ^= crc;
+        crc =
+            crc32c_tables[7][ low         & 0xFF] ^
+            crc32c_tables[6][(low  >>  8) & 0xFF] ^
+            crc32c_tables[5][(low  >> 16) & 0xFF] ^
+            crc32c_tables[4][ low  >> 24        ] ^
+            crc32c_tables[3][ high        & 0xFF] ^
+            crc32c_tables[2][(high >>  8) & 0xFF] ^
+            crc32c_tables[1][(high >> 16) & 0xFF] ^
+            crc32c_tables[0][ high >> 24        ];
+    }
+
+    while (size-- > 0)
+        crc = crc32c_tables[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+
+    return crc;
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("sse4.2")))
+uint32_t crc32c_sse42(uint32_t crc, const byte_t *data, size_t size) {
+
+    while (size > 0 && ((uintptr_t)data & 7) != 0) {
+        crc = __builtin_ia32_crc32qi(crc, *data++);
+        size--;
+    }
+
+    #ifdef __x86_64__
+    uint64_t wide_crc = crc;
+    for (; size >= 8; size -= 8, data += 8) {
+        uint64_t value;
+        memcpy(&value, data, sizeof(value));
+        wide_crc = __builtin_ia32_crc32di(wide_crc, value);
+    }
+    crc = wide_crc;
+    #endif
+
+    for (; size >= 4; size -= 4, data += 4) {
+        uint32_t value;
+        memcpy(&value, data, sizeof(value));
+        crc = __builtin_ia32_crc32si(crc, value);
+    }
+
+    while (size-- > 0)
+        crc = __builtin_ia32_crc32qi(crc, *data++);
+
+    return crc;
+
+}
+
+#endif
+
+void crc32c_init() {
+
+    for (uint32_t byte = 0; byte < 256; byte++) {
+        uint32_t crc = byte;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = crc & 1 ? (crc >> 1) ^ CRC32C_POLYNOMIAL : crc >> 1;
+        crc32c_tables[0][byte] = crc;
+    }
+
+    for (uint32_t byte = 0; byte < 256; byte++)
+        for (uint8_t slice = 1; slice < 8; slice++)
+            crc32c_tables[slice][byte] =
+                (crc32c_tables[slice - 1][byte] >> 8) ^
+                crc32c_tables[0][crc32c_tables[slice - 1][byte] & 0xFF];
+
+    #if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        crc32c_implementation = crc32c_sse42;
+    #endif
+
+}
+
+/*
+
+Continue computing CRC32C of the data whose checksum so far is `crc` (pass 0
+at the start). SSE4.2 instruction is used if the processor supports it.
+
+ */
+uint32_t crc32c(uint32_t crc, const void * const data, size_t size) {
+
+    pthread_once(&crc32c_init_once, crc32c_init);
+    return ~crc32c_implementation(~crc, data, size);
+
+}
+
+typedef struct checksum_job_s {
+    const pool_checksums_t *checksums;
+    // true to store the computed checksums, false to compare with them
+    bool                    store;
+    uint64_t                mismatches;
+} checksum_job_t;
+
+void checksum_body(
+    void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+    checksum_job_t * const job = job_void;
+    const pool_checksums_t * const checksums = job->checksums;
+    uint64_t mismatches = 0;
+
+    for (uint64_t genome_i = start; genome_i < end; genome_i++) {
+
+        pool_checksum_entry_t * const entry = &checksums->entries[genome_i];
+
+        if (!job->store && checksums->verified[genome_i]) continue;
+
+        const uint32_t checksum = crc32c(
+            0, checksums->base + entry->offset, entry->byte_size);
+
+        if (job->store) entry->checksum = checksum;
+        else if (entry->checksum != checksum) {
+            // the first mismatch of the range is reported
+            if (mismatches++ == 0)
+                RAISE_ERROR_AT(
+                    ERR_GENM_CHECKSUM_MISMATCH, genome_i, entry->offset);
+        }
+        else checksums->verified[genome_i] = 1;
+
+    }
+
+    __atomic_fetch_add(&job->mismatches, mismatches, __ATOMIC_RELAXED);
+
+}
+
+/*
+
+Compute checksums of all the genomes split between `threads_number` threads
+(0 means number of online processors). Returns number of mismatches.
+
+ */
+uint64_t run_checksum_jobs(
+    const pool_checksums_t * const checksums, const bool store,
+    const uint16_t threads_number
+) {
+
+    checksum_job_t job = {
+        .checksums = checksums, .store = store, .mismatches = 0 };
+
+    parallel_for(
+        checksums->organisms_number, threads_number, checksum_body, &job);
+
+    return job.mismatches;
+
+}
+
+void destroy_pool_checksums(pool_checksums_t * const checksums) {
+    FREE_NOT_NULL(checksums->entries);
+    FREE_NOT_NULL(checksums->verified);
+    free(checksums);
+}
+
+pool_checksums_t * allocate_pool_checksums(
+    const byte_t * const base, const pool_organisms_num_t organisms_number
+) {
+
+    DECLARE_CONST_MALLOC_OBJECT(
+        pool_checksums_t, checksums, RETURN_NULL_ON_ERR);
+
+    checksums->base = base;
+    checksums->organisms_number = organisms_number;
+    checksums->entries =
+        malloc(sizeof(pool_checksum_entry_t) * organisms_number);
+    checksums->verified = calloc(organisms_number, sizeof(uint8_t));
+
+    // arrays of an empty pool may be NULL
+    if (organisms_number > 0 &&
+        (checksums->entries == NULL || checksums->verified == NULL))
+        DESTROY_AND_EXIT(
+            destroy_pool_checksums, checksums, RETURN_NULL_ON_ERR);
+
+    return checksums;
+
+}
+
+/*
+
+Compute checksums of the pool and write them into the file at `address`. The
+pool should be placed in memory (e.g. read by read_pool or written by
+write_pool) and its genome cursor is left untouched.
+
+ */
+void write_pool_checksums(
+    pool_t * const pool, const char *address, const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    pool_checksums_t * const checksums =
+        allocate_pool_checksums(POOL_DUMP_START(pool), pool->organisms_number);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    // find every genome in the dump
+    pool_checksums_t * const attached_checksums = pool->checksums;
+    void * const cursor = pool->cursor;
+    pool->checksums = NULL;
+    reset_genome_cursor(pool);
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < pool->organisms_number;
+        genome_i++
+    ) {
+
+        const byte_t * const genome_start = pool->cursor;
+        genome_t * const genome = read_next_genome(pool);
+        if (ERROR_LEVEL != ERR_OK) break;
+        free(genome);
+
+        checksums->entries[genome_i].offset = genome_start - checksums->base;
+        checksums->entries[genome_i].byte_size =
+            (byte_t *)pool->cursor - genome_start;
+
+    }
+
+    pool->checksums = attached_checksums;
+    pool->cursor = cursor;
+
+    if (ERROR_LEVEL != ERR_OK) {
+        const err_status_t status = ERROR_LEVEL;
+        destroy_pool_checksums(checksums);
+        ERROR_LEVEL = status;
+        return;
+    }
+
+    const size_t description_byte_size = POOL_DESCRIPTION_BYTE_SIZE(pool);
+    checksums->description_checksum =
+        crc32c(0, checksums->base, description_byte_size);
+
+    run_checksum_jobs(checksums, true, threads_number);
+
+    const size_t file_size =
+        sizeof(pool_checksums_file_preamble_t) +
+        sizeof(pool_checksums_file_entry_t) * pool->organisms_number +
+        sizeof(POOL_CHECKSUMS_TERMINAL_BYTE);
+
+    // open_file maps one byte less than it writes into the stretched file
+    file_map_t * const mapping =
+        open_file(address, OPEN_MODE_WRITE, file_size - 1);
+    if (ERROR_LEVEL == ERR_OK) resize_file(mapping, file_size);
+    if (ERROR_LEVEL != ERR_OK) {
+        const err_status_t status = ERROR_LEVEL;
+        if (mapping != NULL) close_file(mapping);
+        destroy_pool_checksums(checksums);
+        ERROR_LEVEL = status;
+        return;
+    }
+
+    pool_checksums_file_preamble_t * const preamble = mapping->data;
+    preamble->initial_byte = POOL_CHECKSUMS_INITIAL_BYTE;
+    preamble->version = POOL_CHECKSUMS_FORMAT_VERSION;
+    preamble->organisms_number = HTON(checksums->organisms_number);
+    preamble->description_byte_size = HTON((uint64_t)description_byte_size);
+    COPY_MEMBER_HTON(description_checksum, checksums, preamble);
+    preamble->table_byte = POOL_CHECKSUMS_TABLE_BYTE;
+
+    pool_checksums_file_entry_t * const table = (void *)(preamble + 1);
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < pool->organisms_number;
+        genome_i++
+    ) {
+        const pool_checksum_entry_t * const entry =
+            &checksums->entries[genome_i];
+        pool_checksums_file_entry_t * const record = &table[genome_i];
+        COPY_MEMBER_HTON(offset,    entry, record);
+        COPY_MEMBER_HTON(byte_size, entry, record);
+        COPY_MEMBER_HTON(checksum,  entry, record);
+    }
+
+    *(file_control_byte_t *)(table + pool->organisms_number) =
+        POOL_CHECKSUMS_TERMINAL_BYTE;
+
+    const uint32_t pool_checksum = crc32c(
+        crc32c(
+            0, &preamble->description_checksum,
+            sizeof(preamble->description_checksum)),
+        table,
+        sizeof(pool_checksums_file_entry_t) * pool->organisms_number);
+    preamble->pool_checksum = HTON(pool_checksum);
+
+    if (msync(mapping->data, mapping->size, MS_SYNC) != 0)
+        ERROR_LEVEL = ERR_FILE_CANNOT_SYNC;
+
+    close_file(mapping);
+    destroy_pool_checksums(checksums);
+
+}
+
+#define CHECKSUMS_FAIL_CONDITION(_CONDITION, _ERR_CONST)                       \
+    if (_CONDITION) {                                                          \
+        if (checksums != NULL) destroy_pool_checksums(checksums);              \
+        close_file(mapping);                                                   \
+        ERROR_LEVEL = (_ERR_CONST);                                            \
+        return; }
+
+/*
+
+Read checksums of the pool from the file at `address`. Checksum of the whole
+table and of the pool description are verified right away, genomes are
+verified later by verify_pool or read_next_genome.
+
+ */
+void attach_pool_checksums(pool_t * const pool, const char *address) {
+
+    file_map_t * const mapping = open_file(address, OPEN_MODE_READ, 0);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    pool_checksums_t *checksums = NULL;
+
+    CHECKSUMS_FAIL_CONDITION(
+        mapping->size < sizeof(pool_checksums_file_preamble_t),
+        ERR_POOL_CHECKSUMS_CORRUPT);
+
+    const pool_checksums_file_preamble_t * const preamble = mapping->data;
+    const uint64_t organisms_number = NTOH(preamble->organisms_number);
+
+    CHECKSUMS_FAIL_CONDITION(
+        preamble->initial_byte != POOL_CHECKSUMS_INITIAL_BYTE ||
+        preamble->version != POOL_CHECKSUMS_FORMAT_VERSION ||
+        preamble->table_byte != POOL_CHECKSUMS_TABLE_BYTE ||
+        organisms_number != pool->organisms_number ||
+        NTOH(preamble->description_byte_size) !=
+            POOL_DESCRIPTION_BYTE_SIZE(pool) ||
+        mapping->size !=
+            sizeof(pool_checksums_file_preamble_t) +
+            sizeof(pool_checksums_file_entry_t) * organisms_number +
+            sizeof(POOL_CHECKSUMS_TERMINAL_BYTE) ||
+        *((file_control_byte_t *)mapping->data + mapping->size - 1) !=
+            POOL_CHECKSUMS_TERMINAL_BYTE,
+        ERR_POOL_CHECKSUMS_CORRUPT);
+
+    const pool_checksums_file_entry_t * const table = (void *)(preamble + 1);
+
+    const uint32_t pool_checksum = crc32c(
+        crc32c(
+            0, &preamble->description_checksum,
+            sizeof(preamble->description_checksum)),
+        table,
+        sizeof(pool_checksums_file_entry_t) * organisms_number);
+
+    CHECKSUMS_FAIL_CONDITION(
+        pool_checksum != NTOH(preamble->pool_checksum),
+        ERR_POOL_CHECKSUMS_CORRUPT);
+
+    checksums = allocate_pool_checksums(POOL_DUMP_START(pool), organisms_number);
+    if (ERROR_LEVEL != ERR_OK) {
+        close_file(mapping);
+        return;
+    }
+
+    checksums->description_checksum = NTOH(preamble->description_checksum);
+
+    CHECKSUMS_FAIL_CONDITION(
+        crc32c(0, checksums->base, POOL_DESCRIPTION_BYTE_SIZE(pool)) !=
+            checksums->description_checksum,
+        ERR_POOL_CHECKSUM_MISMATCH);
+
+    uint64_t next_offset = POOL_DESCRIPTION_BYTE_SIZE(pool);
+    for (uint64_t genome_i = 0; genome_i < organisms_number; genome_i++) {
+
+        pool_checksum_entry_t * const entry = &checksums->entries[genome_i];
+        const pool_checksums_file_entry_t * const record = &table[genome_i];
+        COPY_MEMBER_NTOH(offset,    record, entry);
+        COPY_MEMBER_NTOH(byte_size, record, entry);
+        COPY_MEMBER_NTOH(checksum,  record, entry);
+
+        // genomes follow each other without gaps
+        CHECKSUMS_FAIL_CONDITION(
+            entry->offset != next_offset, ERR_POOL_CHECKSUMS_CORRUPT);
+        next_offset = entry->offset + entry->byte_size;
+
+    }
+
+    // the whole pool should fit into its file
+    CHECKSUMS_FAIL_CONDITION(
+        pool->file_mapping != NULL &&
+        checksums->base == pool->file_mapping->data &&
+        next_offset >= pool->file_mapping->size,
+        ERR_POOL_CHECKSUMS_CORRUPT);
+
+    close_file(mapping);
+
+    detach_pool_checksums(pool);
+    pool->checksums = checksums;
+
+}
+
+#undef CHECKSUMS_FAIL_CONDITION
+
+/*
+
+Verify every genome of the pool which was not verified yet. Work is split
+between `threads_number` threads (0 means number of online processors).
+ERROR_LEVEL is set to ERR_GENM_CHECKSUM_MISMATCH if any genome is damaged, and
+the error context points to a damaged genome.
+
+ */
+void verify_pool(pool_t * const pool, const uint16_t threads_number) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (pool->checksums == NULL) {
+        ERROR_LEVEL = ERR_NOT_ENOUGH_PARAMS;
+        return;
+    }
+
+    if (run_checksum_jobs(pool->checksums, false, threads_number) > 0)
+        ERROR_LEVEL = ERR_GENM_CHECKSUM_MISMATCH;
+
+}
+
+void detach_pool_checksums(pool_t * const pool) {
+
+    if (pool->checksums == NULL) return;
+    destroy_pool_checksums(pool->checksums);
+    pool->checksums = NULL;
+
+}
+
+/*
+
+Verify the genome starting at `genome_start` unless it was verified before.
+Used by read_next_genome when checksums are attached to the pool.
+
+ */
+bool verify_genome_checksum(pool_t * const pool, const void * const genome_start) {
+
+    pool_checksums_t * const checksums = pool->checksums;
+    const uint64_t offset = (const byte_t *)genome_start - checksums->base;
+
+    uint64_t low = 0, high = checksums->organisms_number;
+    while (low < high) {
+        const uint64_t middle = low + (high - low) / 2;
+        if (checksums->entries[middle].offset < offset) low = middle + 1;
+        else high = middle;
+    }
+
+    if (
+        low == checksums->organisms_number ||
+        checksums->entries[low].offset != offset
+    ) {
+        RAISE_ERROR_AT(ERR_POOL_CHECKSUMS_CORRUPT, ERROR_CONTEXT_UNKNOWN, offset);
+        return false;
+    }
+
+    if (checksums->verified[low]) return true;
+
+    const pool_checksum_entry_t * const entry = &checksums->entries[low];
+    if (
+        crc32c(0, genome_start, entry->byte_size) != entry->checksum
+    ) {
+        RAISE_ERROR_AT(ERR_GENM_CHECKSUM_MISMATCH, low, offset);
+        return false;
+    }
+
+    checksums->verified[low] = 1;
+    return true;
+
+}
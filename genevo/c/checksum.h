@@ -0,0 +1,113 @@
+/*
+
+This module contains CRC32C checksums of pools. Checksums are kept in a
+separate file next to the pool, so the pool format stays the same and pools
+without checksums can still be read.
+
+Genomes are verified either all at once by verify_pool (in parallel), or
+lazily by read_next_genome, when it reaches a genome for the first time.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#include "pool.h"
+#include "error.h"
+#include "files.h"
+#include "types.h"
+#include "memory.h"
+#include "pickler.h"
+#include "parallel.h"
+
+#define POOL_CHECKSUMS_FORMAT_VERSION    (uint8_t)1
+
+#define POOL_CHECKSUMS_INITIAL_BYTE      (file_control_byte_t)0xC8
+#define POOL_CHECKSUMS_TABLE_BYTE        (file_control_byte_t)0xC9
+#define POOL_CHECKSUMS_TERMINAL_BYTE     (file_control_byte_t)0xCA
+
+/*
+
+Structure of the checksums file is the following (network byte order is used
+for all the numbers):
+
+Content                               Size (bits)  Note
+----------                            ----------   ----------
+POOL_CHECKSUMS_INITIAL_BYTE           8
+[format version]                      8
+[number of organisms = N]             64
+[size of pool description]            64           Bytes before the first
+                                                   genome
+[checksum of the description]         32
+[checksum of the pool]                32           Checksum of the description
+                                                   checksum and the table
+POOL_CHECKSUMS_TABLE_BYTE             8
+[table]                               160*N        offset, size and checksum
+                                                   of every genome
+POOL_CHECKSUMS_TERMINAL_BYTE          8
+
+Checksum of the pool covers every genome through their checksums, so it
+detects any change of the pool without reading the whole pool.
+
+ */
+
+typedef struct pool_checksums_file_preamble_s {
+    file_control_byte_t  initial_byte;
+    uint8_t              version;
+    uint64_t             organisms_number;
+    uint64_t             description_byte_size;
+    uint32_t             description_checksum;
+    uint32_t             pool_checksum;
+    file_control_byte_t  table_byte;
+} __attribute__((packed, aligned(1))) pool_checksums_file_preamble_t;
+
+typedef struct pool_checksums_file_entry_s {
+    uint64_t             offset;
+    uint64_t             byte_size;
+    uint32_t             checksum;
+} __attribute__((packed, aligned(1))) pool_checksums_file_entry_t;
+
+/* @function crc32c
+ * @return uint32
+ * @argument uint32
+ * @argument uint8*
+ * @argument size
+ */
+uint32_t crc32c(uint32_t crc, const void * const data, size_t size);
+
+/* @function write_pool_checksums
+ * @return void
+ * @argument pool*
+ * @argument char*
+ * @argument uint16
+ */
+void write_pool_checksums(
+    pool_t * const, const char *address, const uint16_t threads_number);
+
+/* @function attach_pool_checksums
+ * @return void
+ * @argument pool*
+ * @argument char*
+ */
+void attach_pool_checksums(pool_t * const, const char *address);
+
+/* @function verify_pool
+ * @return void
+ * @argument pool*
+ * @argument uint16
+ */
+void verify_pool(pool_t * const, const uint16_t threads_number);
+
+/* @function detach_pool_checksums
+ * @return void
+ * @argument pool*
+ */
+void detach_pool_checksums(pool_t * const);
+
+bool verify_genome_checksum(pool_t * const, const void * const genome_start);
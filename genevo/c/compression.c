@@ -0,0 +1,680 @@
+/*
+
+This module contains the block codec and methods for compressed pools.
+
+ */
+
+#include "compression.h"
+
+#define CODEC_MIN_MATCH      4
+#define CODEC_LAST_LITERALS  5
+#define CODEC_MAX_OFFSET     UINT16_MAX
+#define CODEC_HASH_BITS      14
+#define CODEC_RUN_MASK       15
+
+#define CODEC_READ32(_POINTER) ({                                              \
+    uint32_t _VALUE_;                                                          \
+    memcpy(&_VALUE_, (_POINTER), sizeof(_VALUE_));                             \
+    _VALUE_; })
+
+#define CODEC_HASH(_VALUE)                                                     \
+    (((_VALUE) * 2654435761U) >> (32 - CODEC_HASH_BITS))
+
+// Write length which doesn't fit into the nibble of the token
+#define CODEC_WRITE_LENGTH(_LENGTH) {                                          \
+    size_t _REST_ = (_LENGTH);                                                 \
+    for (; _REST_ >= 255; _REST_ -= 255) destination[out++] = 255;             \
+    destination[out++] = (byte_t)_REST_; }
+
+/*
+
+Compress `size` bytes of `source` into `destination`, which should have at
+least CODEC_BOUND(size) bytes. Returns size of the compressed data.
+
+The output is a list of sequences, each of them is:
+
+[token]                               8            High nibble is number of
+                                                   literals, low one is length
+                                                   of the match minus 4
+[more literals number]                8*n          Present if high nibble is 15
+[literals]
+[offset of the match]                 16           Little-endian
+[more match length]                   8*n          Present if low nibble is 15
+
+The last sequence contains literals only.
+
+ */
+size_t compress_block(
+    const byte_t * const source, const size_t size, byte_t * const destination
+) {
+
+    uint32_t table[1 << CODEC_HASH_BITS] = {0};
+
+    size_t position = 0, anchor = 0, out = 0;
+
+    const size_t match_limit =
+        size > CODEC_LAST_LITERALS ? size - CODEC_LAST_LITERALS : 0;
+
+    while (position + CODEC_MIN_MATCH <= match_limit) {
+
+        const uint32_t value = CODEC_READ32(source + position);
+        const uint32_t hash = CODEC_HASH(value);
+        // positions are stored plus one, so zero means empty slot
+        const size_t candidate = table[hash];
+        table[hash] = position + 1;
+
+        if (
+            candidate == 0 ||
+            position - (candidate - 1) > CODEC_MAX_OFFSET ||
+            CODEC_READ32(source + candidate - 1) != value
+        ) {
+            position++;
+            continue;
+        }
+
+        const size_t match = candidate - 1;
+        size_t length = CODEC_MIN_MATCH;
+        while (
+            position + length < match_limit &&
+            source[match + length] == source[position + length]
+        )
+            length++;
+
+        const size_t literals = position - anchor;
+        const size_t extra_length = length - CODEC_MIN_MATCH;
+
+        destination[out++] =
+            (literals     < CODEC_RUN_MASK ? literals     : CODEC_RUN_MASK) << 4 |
+            (extra_length < CODEC_RUN_MASK ? extra_length : CODEC_RUN_MASK);
+
+        if (literals >= CODEC_RUN_MASK)
+            CODEC_WRITE_LENGTH(literals - CODEC_RUN_MASK);
+
+        memcpy(destination + out, source + anchor, literals);
+        out += literals;
+
+        const size_t offset = position - match;
+        destination[out++] = offset & 0xFF;
+        destination[out++] = offset >> 8;
+
+        if (extra_length >= CODEC_RUN_MASK)
+            CODEC_WRITE_LENGTH(extra_length - CODEC_RUN_MASK);
+
+        position += length;
+        anchor = position;
+
+    }
+
+    const size_t literals = size - anchor;
+    destination[out++] =
+        (literals < CODEC_RUN_MASK ? literals : CODEC_RUN_MASK) << 4;
+    if (literals >= CODEC_RUN_MASK)
+        CODEC_WRITE_LENGTH(literals - CODEC_RUN_MASK);
+    memcpy(destination + out, source + anchor, literals);
+    out += literals;
+
+    return out;
+
+}
+
+#undef CODEC_WRITE_LENGTH
+
+/*
+
+Decompress block produced by compress_block. Returns false if the block is
+corrupted or doesn't decompress into exactly `size` bytes.
+
+ */
+bool decompress_block(
+    const byte_t * const source, const size_t stored_size,
+    byte_t * const destination, const size_t size
+) {
+
+    size_t in = 0, out = 0;
+
+    #define CODEC_READ_LENGTH(_LENGTH) {                                       \
+        byte_t _BYTE_;                                                         \
+        do {                                                                   \
+            if (in >= stored_size) return false;                               \
+            _BYTE_ = source[in++];                                             \
+            _LENGTH += _BYTE_;                                                 \
+        } while (_BYTE_ == 255); }
+
+    while (in < stored_size) {
+
+        const byte_t token = source[in++];
+
+        size_t literals = token >> 4;
+        if (literals == CODEC_RUN_MASK) CODEC_READ_LENGTH(literals);
+
+        if (literals > stored_size - in || literals > size - out)
+            return false;
+
+        memcpy(destination + out, source + in, literals);
+        in += literals;
+        out += literals;
+
+        // the last sequence has no match
+        if (in == stored_size) break;
+
+        if (stored_size - in < 2) return false;
+        const size_t offset = source[in] | (size_t)source[in + 1] << 8;
+        in += 2;
+
+        if (offset == 0 || offset > out) return false;
+
+        size_t length = token & CODEC_RUN_MASK;
+        if (length == CODEC_RUN_MASK) CODEC_READ_LENGTH(length);
+        length += CODEC_MIN_MATCH;
+
+        if (length > size - out) return false;
+
+        // source and destination of the match may overlap
+        const byte_t *match = destination + out - offset;
+        if (offset >= length) {
+            memcpy(destination + out, match, length);
+            out += length;
+        } else
+            while (length--) destination[out++] = *match++;
+
+    }
+
+    #undef CODEC_READ_LENGTH
+
+    return out == size;
+
+}
+
+/*
+
+Compress the pool file at `pool_address` into the new file at `address`.
+Genomes are grouped into chunks of about `chunk_byte_size` bytes (whole
+genomes never cross chunk boundaries). If `chunk_byte_size` is 0,
+COMPRESSED_POOL_DEFAULT_CHUNK_SIZE is used.
+
+ */
+void compress_pool(
+    const char *pool_address, const char *address,
+    const uint32_t chunk_byte_size
+) {
+
+    const uint32_t chunk_limit = chunk_byte_size > 0
+        ? chunk_byte_size : COMPRESSED_POOL_DEFAULT_CHUNK_SIZE;
+
+    pool_t * const pool = read_pool(pool_address);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    const byte_t * const pool_data = pool->file_mapping->data;
+    const size_t description_byte_size =
+        (byte_t *)pool->first_genome_start_position - pool_data;
+
+    // find boundaries of the chunks
+    uint64_t chunks_number = 0, chunks_capacity = 0;
+    compressed_pool_chunk_t *chunks = NULL;
+    size_t largest_chunk = 0;
+
+    #define COMPRESS_FAIL(_ERR) {                                              \
+        const err_status_t _STATUS_ = (_ERR);                                  \
+        FREE_NOT_NULL(chunks);                                                 \
+        close_pool(pool);                                                      \
+        ERROR_LEVEL = _STATUS_;                                                \
+        return; }
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < pool->organisms_number;
+        genome_i++
+    ) {
+
+        const size_t genome_start = (byte_t *)pool->cursor - pool_data;
+        genome_t * const genome = read_next_genome(pool);
+        if (ERROR_LEVEL != ERR_OK) COMPRESS_FAIL(ERROR_LEVEL);
+        free(genome);
+        const size_t genome_size =
+            (byte_t *)pool->cursor - pool_data - genome_start;
+
+        compressed_pool_chunk_t *chunk =
+            chunks_number > 0 ? &chunks[chunks_number - 1] : NULL;
+
+        if (
+            chunk == NULL ||
+            chunk->raw_byte_size + genome_size > chunk_limit
+        ) {
+
+            if (chunks_number == chunks_capacity) {
+                chunks_capacity = chunks_capacity ? chunks_capacity * 2 : 64;
+                compressed_pool_chunk_t * const new_chunks = realloc(
+                    chunks, sizeof(compressed_pool_chunk_t) * chunks_capacity);
+                if (new_chunks == NULL) COMPRESS_FAIL(ERR_CANNOT_MALLOC);
+                chunks = new_chunks;
+            }
+
+            chunk = &chunks[chunks_number++];
+            chunk->first_genome = genome_i;
+            // raw offset is kept here until the chunk is written
+            chunk->offset = genome_start;
+            chunk->raw_byte_size = 0;
+            chunk->stored_byte_size = 0;
+
+        }
+
+        if ((uint64_t)chunk->raw_byte_size + genome_size > UINT32_MAX)
+            COMPRESS_FAIL(ERR_WRONG_PARAMS);
+
+        chunk->raw_byte_size += genome_size;
+        if (chunk->raw_byte_size > largest_chunk)
+            largest_chunk = chunk->raw_byte_size;
+
+    }
+
+    const size_t header_byte_size =
+        sizeof(compressed_pool_file_preamble_t) +
+        sizeof(compressed_pool_chunk_t) * chunks_number +
+        description_byte_size;
+
+    // open_file maps one byte less than it writes into the stretched file
+    file_map_t * const mapping =
+        open_file(address, OPEN_MODE_WRITE, header_byte_size - 1);
+    if (ERROR_LEVEL != ERR_OK) COMPRESS_FAIL(ERROR_LEVEL);
+
+    byte_t * const buffer = malloc(CODEC_BOUND(largest_chunk));
+    if (buffer == NULL) {
+        close_file(mapping);
+        COMPRESS_FAIL(ERR_CANNOT_MALLOC);
+    }
+
+    #undef COMPRESS_FAIL
+    #define COMPRESS_FAIL(_ERR) {                                              \
+        const err_status_t _STATUS_ = (_ERR);                                  \
+        free(buffer);                                                          \
+        close_file(mapping);                                                   \
+        FREE_NOT_NULL(chunks);                                                 \
+        close_pool(pool);                                                      \
+        ERROR_LEVEL = _STATUS_;                                                \
+        return; }
+
+    // chunks are stored raw when compression does not help, so the file is
+    // stretched once for the worst case and cut after the last chunk
+    size_t raw_byte_size = 0;
+    for (uint64_t chunk_i = 0; chunk_i < chunks_number; chunk_i++)
+        raw_byte_size += chunks[chunk_i].raw_byte_size;
+
+    resize_file(mapping, header_byte_size + raw_byte_size + 1);
+    if (ERROR_LEVEL != ERR_OK) COMPRESS_FAIL(ERROR_LEVEL);
+
+    size_t offset = header_byte_size;
+
+    for (uint64_t chunk_i = 0; chunk_i < chunks_number; chunk_i++) {
+
+        compressed_pool_chunk_t * const chunk = &chunks[chunk_i];
+        const byte_t * const raw = pool_data + chunk->offset;
+
+        size_t stored_size = compress_block(raw, chunk->raw_byte_size, buffer);
+        const byte_t *stored = buffer;
+        if (stored_size >= chunk->raw_byte_size) {
+            stored_size = chunk->raw_byte_size;
+            stored = raw;
+        }
+
+        memcpy((byte_t *)mapping->data + offset, stored, stored_size);
+
+        chunk->offset = offset;
+        chunk->stored_byte_size = stored_size;
+        offset += stored_size;
+
+    }
+
+    const size_t terminal_offset = offset;
+    resize_file(mapping, terminal_offset + 1);
+    if (ERROR_LEVEL != ERR_OK) COMPRESS_FAIL(ERROR_LEVEL);
+    *((file_control_byte_t *)mapping->data + terminal_offset) =
+        COMPRESSED_POOL_TERMINAL_BYTE;
+
+    compressed_pool_file_preamble_t * const preamble = mapping->data;
+    preamble->initial_byte = COMPRESSED_POOL_INITIAL_BYTE;
+    preamble->version = COMPRESSED_POOL_FORMAT_VERSION;
+    preamble->chunk_byte_size = HTON(chunk_limit);
+    COPY_MEMBER_HTON(organisms_number, pool, preamble);
+    preamble->chunks_number = HTON(chunks_number);
+    preamble->description_byte_size = HTON((uint64_t)description_byte_size);
+    preamble->index_byte = COMPRESSED_POOL_INDEX_BYTE;
+
+    compressed_pool_chunk_t * const index = (void *)(preamble + 1);
+    for (uint64_t chunk_i = 0; chunk_i < chunks_number; chunk_i++) {
+        const compressed_pool_chunk_t * const chunk = &chunks[chunk_i];
+        compressed_pool_chunk_t * const record = &index[chunk_i];
+        COPY_MEMBER_HTON(first_genome,     chunk, record);
+        COPY_MEMBER_HTON(offset,           chunk, record);
+        COPY_MEMBER_HTON(raw_byte_size,    chunk, record);
+        COPY_MEMBER_HTON(stored_byte_size, chunk, record);
+    }
+
+    memcpy(index + chunks_number, pool_data, description_byte_size);
+
+    #undef COMPRESS_FAIL
+
+    free(buffer);
+    free(chunks);
+    close_pool(pool);
+
+    if (msync(mapping->data, mapping->size, MS_SYNC) != 0)
+        ERROR_LEVEL = ERR_FILE_CANNOT_SYNC;
+    close_file(mapping);
+
+}
+
+#define CPOOL_FAIL_CONDITION(_CONDITION, _ERR_CONST)                           \
+    if (_CONDITION) {                                                          \
+        ERROR_LEVEL = (_ERR_CONST); close_compressed_pool(cpool);              \
+        return NULL; }
+
+compressed_pool_t * open_compressed_pool(const char *address) {
+
+    file_map_t * const mapping = open_file(address, OPEN_MODE_READ, 0);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    compressed_pool_t * const cpool = malloc(sizeof(compressed_pool_t));
+    if (cpool == NULL) {
+        close_file(mapping);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    cpool->file_mapping = mapping;
+    cpool->pool = NULL;
+    cpool->chunks_number = 0;
+    cpool->chunks = NULL;
+    cpool->cache = NULL;
+
+    CPOOL_FAIL_CONDITION(
+        mapping->size <
+            sizeof(compressed_pool_file_preamble_t) +
+            sizeof(COMPRESSED_POOL_TERMINAL_BYTE),
+        ERR_CPOOL_CORRUPT_START);
+
+    const compressed_pool_file_preamble_t * const preamble = mapping->data;
+
+    CPOOL_FAIL_CONDITION(
+        preamble->initial_byte != COMPRESSED_POOL_INITIAL_BYTE,
+        ERR_CPOOL_CORRUPT_START);
+
+    CPOOL_FAIL_CONDITION(
+        preamble->version != COMPRESSED_POOL_FORMAT_VERSION,
+        ERR_CPOOL_WRONG_VERSION);
+
+    CPOOL_FAIL_CONDITION(
+        preamble->index_byte != COMPRESSED_POOL_INDEX_BYTE,
+        ERR_CPOOL_CORRUPT_INDEX);
+
+    CPOOL_FAIL_CONDITION(
+        *((file_control_byte_t *)mapping->data + mapping->size - 1) !=
+            COMPRESSED_POOL_TERMINAL_BYTE,
+        ERR_CPOOL_CORRUPT_INDEX);
+
+    const uint64_t chunks_number = NTOH(preamble->chunks_number);
+    const uint64_t description_byte_size =
+        NTOH(preamble->description_byte_size);
+    const size_t data_byte_size =
+        mapping->size - sizeof(compressed_pool_file_preamble_t);
+
+    // only an empty pool has no chunks
+    CPOOL_FAIL_CONDITION(
+        (chunks_number == 0) != (NTOH(preamble->organisms_number) == 0) ||
+        chunks_number > data_byte_size / sizeof(compressed_pool_chunk_t) ||
+        description_byte_size >
+            data_byte_size - chunks_number * sizeof(compressed_pool_chunk_t),
+        ERR_CPOOL_CORRUPT_INDEX);
+
+    // chunks of an empty pool may be NULL
+    cpool->chunks = malloc(sizeof(compressed_pool_chunk_t) * chunks_number);
+    if (cpool->chunks == NULL && chunks_number > 0) {
+        close_compressed_pool(cpool);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+    cpool->chunks_number = chunks_number;
+    cpool->cached_chunk = chunks_number;
+
+    const compressed_pool_chunk_t * const index = (void *)(preamble + 1);
+    uint32_t largest_chunk = 0;
+    uint64_t next_genome = 0;
+
+    for (uint64_t chunk_i = 0; chunk_i < chunks_number; chunk_i++) {
+
+        compressed_pool_chunk_t * const chunk = &cpool->chunks[chunk_i];
+        const compressed_pool_chunk_t * const record = &index[chunk_i];
+        COPY_MEMBER_NTOH(first_genome,     record, chunk);
+        COPY_MEMBER_NTOH(offset,           record, chunk);
+        COPY_MEMBER_NTOH(raw_byte_size,    record, chunk);
+        COPY_MEMBER_NTOH(stored_byte_size, record, chunk);
+
+        CPOOL_FAIL_CONDITION(
+            chunk->first_genome < next_genome ||
+            (chunk_i == 0 && chunk->first_genome != 0) ||
+            chunk->offset > mapping->size - 1 ||
+            chunk->stored_byte_size > mapping->size - 1 - chunk->offset ||
+            chunk->stored_byte_size > chunk->raw_byte_size,
+            ERR_CPOOL_CORRUPT_INDEX);
+
+        next_genome = chunk->first_genome + 1;
+        if (chunk->raw_byte_size > largest_chunk)
+            largest_chunk = chunk->raw_byte_size;
+
+    }
+
+    // extra byte is for POOL_TERMINAL_BYTE, which stops read_next_genome
+    cpool->cache = malloc((size_t)largest_chunk + 1);
+    if (cpool->cache == NULL) {
+        close_compressed_pool(cpool);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    byte_t * const description =
+        (byte_t *)(index + chunks_number);
+
+    cpool->pool = read_pool_from_memory(
+        description, (byte_t *)mapping->data + mapping->size - description);
+    if (ERROR_LEVEL != ERR_OK) {
+        const err_status_t status = ERROR_LEVEL;
+        cpool->pool = NULL;
+        close_compressed_pool(cpool);
+        ERROR_LEVEL = status;
+        return NULL;
+    }
+
+    CPOOL_FAIL_CONDITION(
+        (byte_t *)cpool->pool->first_genome_start_position - description !=
+            (ptrdiff_t)description_byte_size ||
+        cpool->pool->organisms_number != NTOH(preamble->organisms_number),
+        ERR_CPOOL_CORRUPT_INDEX);
+
+    return cpool;
+
+}
+
+#undef CPOOL_FAIL_CONDITION
+
+/*
+
+Decompress the chunk into the cache of the pool unless it's already there.
+
+ */
+void load_compressed_chunk(
+    compressed_pool_t * const cpool, const uint64_t chunk_i
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (cpool->cached_chunk == chunk_i) return;
+
+    const compressed_pool_chunk_t * const chunk = &cpool->chunks[chunk_i];
+    const byte_t * const stored =
+        (byte_t *)cpool->file_mapping->data + chunk->offset;
+
+    cpool->cached_chunk = cpool->chunks_number;
+
+    if (chunk->stored_byte_size == chunk->raw_byte_size)
+        memcpy(cpool->cache, stored, chunk->raw_byte_size);
+    else if (!decompress_block(
+        stored, chunk->stored_byte_size, cpool->cache, chunk->raw_byte_size)
+    ) {
+        ERROR_LEVEL = ERR_CPOOL_CORRUPT_CHUNK;
+        return;
+    }
+
+    cpool->cache[chunk->raw_byte_size] = POOL_TERMINAL_BYTE;
+    cpool->cached_chunk = chunk_i;
+
+}
+
+/*
+
+Read genome with the given index. Only the chunk containing the genome is
+decompressed. Returned genome owns its data and should be destroyed with
+destroy_genome(genome, true).
+
+ */
+genome_t * read_compressed_genome(
+    compressed_pool_t * const cpool, const pool_organisms_num_t index
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (index >= cpool->pool->organisms_number) {
+        ERROR_LEVEL = ERR_CPOOL_NO_GENOME;
+        return NULL;
+    }
+
+    // binary search of the last chunk starting before the genome
+    uint64_t low = 0, high = cpool->chunks_number;
+    while (high - low > 1) {
+        const uint64_t middle = low + (high - low) / 2;
+        if (cpool->chunks[middle].first_genome <= index) low = middle;
+        else high = middle;
+    }
+
+    load_compressed_chunk(cpool, low);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    pool_t * const pool = cpool->pool;
+    pool->cursor = cpool->cache;
+
+    genome_t *genome = NULL;
+    for (
+        pool_organisms_num_t genome_i = cpool->chunks[low].first_genome;
+        genome_i <= index;
+        genome_i++
+    ) {
+        FREE_NOT_NULL(genome);
+        genome = read_next_genome(pool);
+        if (ERROR_LEVEL != ERR_OK) {
+            ERROR_LEVEL = ERR_CPOOL_CORRUPT_CHUNK;
+            return NULL;
+        }
+    }
+
+    // the genome points into the cache, so its data is copied out
+    const size_t genes_byte_size = (size_t)genome->length * pool->gene_bytes_size;
+    const size_t residue_byte_size = BITS_TO_BYTES(genome->residue_size_bits);
+
+    byte_t * const metadata = malloc(genome->metadata_byte_size + 1);
+    gene_byte_t * const genes = malloc(genes_byte_size + 1);
+    byte_t * const residue = malloc(residue_byte_size + 1);
+
+    if (metadata == NULL || genes == NULL || residue == NULL) {
+        FREE_NOT_NULL(metadata);
+        FREE_NOT_NULL(genes);
+        FREE_NOT_NULL(residue);
+        free(genome);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    memcpy(metadata, genome->metadata, genome->metadata_byte_size);
+    memcpy(genes, genome->genes, genes_byte_size);
+    memcpy(residue, genome->residue, residue_byte_size);
+
+    genome->metadata = metadata;
+    genome->genes = genes;
+    genome->residue = residue;
+
+    return genome;
+
+}
+
+/*
+
+Restore the original pool file from the compressed one.
+
+ */
+void decompress_pool(const char *address, const char *pool_address) {
+
+    compressed_pool_t * const cpool = open_compressed_pool(address);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    const byte_t * const description =
+        (byte_t *)cpool->file_mapping->data +
+        sizeof(compressed_pool_file_preamble_t) +
+        sizeof(compressed_pool_chunk_t) * cpool->chunks_number;
+    const size_t description_byte_size =
+        (byte_t *)cpool->pool->first_genome_start_position - description;
+
+    size_t pool_byte_size =
+        description_byte_size + sizeof(POOL_TERMINAL_BYTE);
+    for (uint64_t chunk_i = 0; chunk_i < cpool->chunks_number; chunk_i++)
+        pool_byte_size += cpool->chunks[chunk_i].raw_byte_size;
+
+    // open_file maps one byte less than it writes into the stretched file
+    file_map_t * const mapping =
+        open_file(pool_address, OPEN_MODE_WRITE, pool_byte_size - 1);
+    if (ERROR_LEVEL != ERR_OK) {
+        close_compressed_pool(cpool);
+        return;
+    }
+
+    resize_file(mapping, pool_byte_size);
+    if (ERROR_LEVEL != ERR_OK) {
+        close_file(mapping);
+        close_compressed_pool(cpool);
+        return;
+    }
+
+    byte_t *position = mapping->data;
+    memcpy(position, description, description_byte_size);
+    position += description_byte_size;
+
+    for (uint64_t chunk_i = 0; chunk_i < cpool->chunks_number; chunk_i++) {
+
+        const compressed_pool_chunk_t * const chunk = &cpool->chunks[chunk_i];
+        const byte_t * const stored =
+            (byte_t *)cpool->file_mapping->data + chunk->offset;
+
+        if (chunk->stored_byte_size == chunk->raw_byte_size)
+            memcpy(position, stored, chunk->raw_byte_size);
+        else if (!decompress_block(
+            stored, chunk->stored_byte_size, position, chunk->raw_byte_size)
+        ) {
+            close_file(mapping);
+            close_compressed_pool(cpool);
+            unlink(pool_address);
+            ERROR_LEVEL = ERR_CPOOL_CORRUPT_CHUNK;
+            return;
+        }
+
+        position += chunk->raw_byte_size;
+
+    }
+
+    *(file_control_byte_t *)position = POOL_TERMINAL_BYTE;
+
+    close_file(mapping);
+    close_compressed_pool(cpool);
+
+}
+
+void close_compressed_pool(compressed_pool_t * const cpool) {
+
+    if (cpool->pool != NULL) close_pool(cpool->pool);
+    FREE_NOT_NULL(cpool->chunks);
+    FREE_NOT_NULL(cpool->cache);
+    close_file(cpool->file_mapping);
+    free(cpool);
+
+}
@@ -0,0 +1,157 @@
+/*
+
+This module contains a fast in-tree block codec and methods for keeping cold
+pools compressed. Genomes are grouped into chunks which are compressed
+independently, so reading a single organism only decompresses the chunk
+containing it.
+
+The codec is a byte-oriented LZ77 similar to LZ4 block format. Node ids and
+repeated neighbor genes (see REPEAT_NEIGHBOR_GENES) compress well, while
+random weight bits are mostly stored as literals.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "pool.h"
+#include "error.h"
+#include "files.h"
+#include "types.h"
+#include "memory.h"
+#include "pickler.h"
+
+#define COMPRESSED_POOL_FORMAT_VERSION     (uint8_t)1
+
+#define COMPRESSED_POOL_INITIAL_BYTE       (file_control_byte_t)0xB0
+#define COMPRESSED_POOL_INDEX_BYTE         (file_control_byte_t)0xB1
+#define COMPRESSED_POOL_TERMINAL_BYTE      (file_control_byte_t)0xB2
+
+#ifndef COMPRESSED_POOL_DEFAULT_CHUNK_SIZE
+#   define COMPRESSED_POOL_DEFAULT_CHUNK_SIZE (1 << 20)
+#endif
+
+// Largest size of compress_block output for `_SIZE` bytes of input
+#define CODEC_BOUND(_SIZE) ((_SIZE) + (_SIZE) / 255 + 16)
+
+/*
+
+Structure of the compressed pool file is the following (network byte order is
+used for all the numbers):
+
+Content                               Size (bits)  Note
+----------                            ----------   ----------
+COMPRESSED_POOL_INITIAL_BYTE          8
+[format version]                      8
+[chunk size]                          32           Desired raw size of a chunk
+[number of organisms]                 64
+[number of chunks = C]                64
+[size of pool description = DSB]      64
+COMPRESSED_POOL_INDEX_BYTE            8
+[chunk index]                         C*192        compressed_pool_chunk_t
+[pool description]                    DSb          Pool file up to the first
+                                                   genome (pickler.h)
+[chunks]                              ...
+COMPRESSED_POOL_TERMINAL_BYTE         8
+
+Every chunk holds whole genomes exactly as they're written in the pool file.
+If the codec can't make a chunk smaller, it's stored as is, so its stored size
+equals raw size.
+
+ */
+
+typedef struct compressed_pool_file_preamble_s {
+    file_control_byte_t    initial_byte;
+    uint8_t                version;
+    uint32_t               chunk_byte_size;
+    uint64_t               organisms_number;
+    uint64_t               chunks_number;
+    uint64_t               description_byte_size;
+    file_control_byte_t    index_byte;
+} __attribute__((packed, aligned(1))) compressed_pool_file_preamble_t;
+
+/* @struct compressed_pool_chunk
+ * @member uint64 first_genome
+ * @member uint64 offset
+ * @member uint32 raw_byte_size
+ * @member uint32 stored_byte_size
+ */
+typedef struct compressed_pool_chunk_s {
+    // index of the first genome in the chunk
+    uint64_t               first_genome;
+    // offset of the stored chunk from the start of the file
+    uint64_t               offset;
+    uint32_t               raw_byte_size;
+    uint32_t               stored_byte_size;
+} __attribute__((packed, aligned(1))) compressed_pool_chunk_t;
+
+/* @typedef compressed_pool_p
+ * @from_type compressed_pool*
+ */
+/* @struct compressed_pool
+ * @member file_map* file_mapping
+ * @member pool* pool
+ * @member uint64 chunks_number
+ * @member compressed_pool_chunk* chunks
+ * @member uint64 cached_chunk
+ * @member uint8* cache
+ */
+typedef struct compressed_pool_s {
+    file_map_t               *file_mapping;
+    // Description of the pool. Its metadata points into the mapping and it
+    // has no genomes to iterate over.
+    pool_t                   *pool;
+    uint64_t                  chunks_number;
+    // Index in host byte order
+    compressed_pool_chunk_t  *chunks;
+    // Last decompressed chunk (chunks_number if none)
+    uint64_t                  cached_chunk;
+    byte_t                   *cache;
+} compressed_pool_t;
+
+size_t compress_block(
+    const byte_t * const source, const size_t size, byte_t * const destination);
+bool decompress_block(
+    const byte_t * const source, const size_t stored_size,
+    byte_t * const destination, const size_t size);
+
+/* @function compress_pool
+ * @return void
+ * @argument char*
+ * @argument char*
+ * @argument uint32
+ */
+void compress_pool(
+    const char *pool_address, const char *address,
+    const uint32_t chunk_byte_size);
+
+/* @function decompress_pool
+ * @return void
+ * @argument char*
+ * @argument char*
+ */
+void decompress_pool(const char *address, const char *pool_address);
+
+/* @function open_compressed_pool
+ * @return compressed_pool*
+ * @argument char*
+ */
+compressed_pool_t * open_compressed_pool(const char *address);
+
+/* @function read_compressed_genome
+ * @return genome*
+ * @argument compressed_pool*
+ * @argument uint64
+ */
+genome_t * read_compressed_genome(
+    compressed_pool_t * const, const pool_organisms_num_t index);
+
+/* @function close_compressed_pool
+ * @return void
+ * @argument compressed_pool*
+ */
+void close_compressed_pool(compressed_pool_t * const);
@@ -1,4 +1,5 @@
 #include "demiurge.h"
+#include "checksum.h"
 
 /*
 
@@ -10,6 +11,8 @@ void generate_genome_data(
 	const generator_mode_t generator_mode
 ) {
 
+	genome->flags |= GENOME_DIRTY;
+
 	if (generator_mode == GENERATE_RANDOMNESS) {
 		fill_bytes_with_randomness(genome->genes, genome->length * gene_byte_size);
 		fill_bits_with_randomness(genome->residue, genome->residue_size_bits);
@@ -63,6 +66,8 @@ genome_t * allocate_genome(
 	genome->residue_size_bits = residue_size_bits;
 	genome->metadata = NULL;
 	genome->metadata_byte_size = 0;
+	// the genome is not written into any pool file yet
+	genome->flags = GENOME_DIRTY;
 
 	return genome;
 
@@ -128,6 +133,7 @@ void copy_genome(
 	dst->length = src->length;
 	dst->metadata_byte_size = src->metadata_byte_size;
 	dst->residue_size_bits = src->residue_size_bits;
+	dst->flags |= GENOME_DIRTY;
 
 	switch (mode) {
 
@@ -207,6 +213,9 @@ pool_t * allocate_pool() {
 
 	pool->metadata = NULL;
 	pool->metadata_byte_size = 0;
+	pool->file_mapping = NULL;
+	pool->dirty_ranges = NULL;
+	pool->checksums = NULL;
 
 	return pool;
 
@@ -215,6 +224,7 @@ pool_t * allocate_pool() {
 void destroy_pool(pool_t * const pool, const bool close_file) {
 
 	if (close_file) close_file_for_pool(pool);
+	detach_pool_checksums(pool);
 	delete_pool_metadata(pool);
 
 	free(pool);
@@ -244,24 +254,74 @@ void delete_pool_metadata(pool_t * const pool) {
 
 Create name for a file in which the pool will be allocated. New name will be
 created based on current timestamp and a pointer to the pool.
+If POOL_IN_SHARED_MEMORY is defined, the name refers to a POSIX shared memory
+object (see files.h), so pools created by create_pool_in_file can be mapped by
+other processes without touching the disk.
 ! This function allocates new memory, which should be freed after use.
 
  */
+#ifdef POOL_IN_SHARED_MEMORY
+#	define POOL_NAME_FORMAT SHARED_MEMORY_ADDRESS_PREFIX "/%lX.pool"
+#else
+#	define POOL_NAME_FORMAT "%lX.pool"
+#endif
+
 char * alloc_name_for_pool(pool_t * const pool) {
 
 	const uint64_t number = time(NULL) + (uint64_t)pool;
-	// maximum size of uint64 in hex is 9 symbols + ".pool"
-	DECLARE_CONST_CALLOC_ARRAY(char, address, 9 + 5, RETURN_NULL_ON_ERR);
+	// maximum size of uint64 in hex is 16 symbols, plus prefix, ".pool" and \0
+	DECLARE_CONST_CALLOC_ARRAY(
+		char, address, sizeof(POOL_NAME_FORMAT) + 16, RETURN_NULL_ON_ERR);
 
-	// in case printed string is less than (9 + 5), symbols, the last bit is
-	// \0 anyway, so it will suit well for functions taking (const char *)
-	sprintf(address, "%lX.pool", number);
+	sprintf(address, POOL_NAME_FORMAT, number);
 
 	return address;
 
 }
 
 
+typedef struct fill_pool_job_s {
+	genome_t * const   *genomes;
+	uint8_t             gene_bytes_size;
+	generator_mode_t    generator_mode;
+	uint64_t            seed;
+} fill_pool_job_t;
+
+/*
+
+Genome `i` is filled from stream `i` of the seed, so the pool does not depend on
+the number of threads.
+
+ */
+void fill_pool_body(
+	void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+	const fill_pool_job_t * const job = job_void;
+
+	for (uint64_t genome_itr = start; genome_itr < end; genome_itr++) {
+
+		genome_t * const genome = job->genomes[genome_itr];
+
+		genome->flags |= GENOME_DIRTY;
+
+		// the file was just truncated, so its genes are zeros already
+		if (job->generator_mode != GENERATE_RANDOMNESS) continue;
+
+		xorshift128p_stream_t stream;
+		seed_xorshift128p_stream(&stream, job->seed, genome_itr);
+
+		fill_with_stream_randomness(
+			&stream, genome->genes,
+			genome->length * job->gene_bytes_size, 0);
+		fill_with_stream_randomness(
+			&stream, genome->residue,
+			genome->residue_size_bits / 8, genome->residue_size_bits % 8);
+
+	}
+
+}
+
 /*
 
 Generate genomes for pool. For this function the following members of
@@ -270,12 +330,28 @@ pool_t must be set:
 	* node_id_part_bit_size
 	* weight_part_bit_size
 
+Genomes are generated right in the pool file by `threads_number` threads (0
+means the number of CPUs). Every thread takes consecutive genomes, so pages of
+the file are first touched by the thread which fills them. Random genes are
+drawn from independent streams (see xorshift128p_stream_t) seeded by one
+number of xorshift128p.
+
  */
-void fill_pool(
+void fill_pool_parallel(
 	const char *address, population_t * const population,
-	const generator_mode_t generator_mode
+	const generator_mode_t generator_mode, const uint16_t threads_number
 ) {
 
+	PROBE_SCOPE(PROBE_FILL_POOL);
+
+	if (
+		generator_mode != GENERATE_RANDOMNESS &&
+		generator_mode != GENERATE_ZEROS
+	) {
+		ERROR_LEVEL = ERR_WRONG_FLAG;
+		return;
+	}
+
 	#ifndef ERROR_ON_EMPTY_FILENAME_FOR_POOL
 	bool address_is_allocated = false;
 	char *allocated_address;
@@ -303,17 +379,42 @@ void fill_pool(
 	if (address_is_allocated) free(allocated_address);
 	#endif
 
-	// fill each genome with values
+	fill_pool_job_t job = {
+		.genomes = population->genomes,
+		.gene_bytes_size = population->pool->gene_bytes_size,
+		.generator_mode = generator_mode,
+		.seed = 0
+	};
+
+	if (generator_mode == GENERATE_RANDOMNESS) {
+		#ifndef SKIP_XORSHIFT128P_RND_SEED_CHECK
+			ENSURE_XORSHIFT128P_RND_SEED_IS_SET;
+		#endif
+		job.seed = next_urandom64();
+	}
+
+	parallel_for(
+		population->pool->organisms_number, threads_number,
+		fill_pool_body, &job);
+
+	#ifdef ENABLE_INSTRUMENTATION
 	for(
 		uint64_t genome_itr = 0;
 		genome_itr < population->pool->organisms_number;
 		genome_itr++
-	) {
-		generate_genome_data(
-			population->genomes[genome_itr],
-			population->pool->gene_bytes_size, generator_mode);
-	}
+	)
+		PROBE_BYTES(
+			(uint64_t)population->genomes[genome_itr]->length *
+			population->pool->gene_bytes_size);
+	#endif
+
+}
 
+void fill_pool(
+	const char *address, population_t * const population,
+	const generator_mode_t generator_mode
+) {
+	fill_pool_parallel(address, population, generator_mode, 0);
 }
 
 population_t * create_pool_in_file(
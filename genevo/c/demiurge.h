@@ -8,6 +8,7 @@
 #include "string.h"
 #include "stdbool.h"
 #include "pickler.h"
+#include "parallel.h"
 #include "bit_manipulations.h"
 
 /* @enum generator_mode
@@ -173,6 +174,18 @@ void fill_pool(
     const generator_mode_t
 );
 
+/* @function fill_pool_parallel
+ * @return void
+ * @argument char*
+ * @argument population*
+ * @argument generator_mode
+ * @argument uint16
+ */
+void fill_pool_parallel(
+    const char *address, population_t * const,
+    const generator_mode_t, const uint16_t threads_number
+);
+
 /* @function create_pool_in_file
  * @return population*
  * @argument uint64
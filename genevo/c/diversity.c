@@ -0,0 +1,359 @@
+/*
+
+This module contains methods for measuring distances between genomes.
+
+ */
+
+#include "diversity.h"
+
+pthread_once_t hamming_init_once = PTHREAD_ONCE_INIT;
+
+uint64_t hamming_distance_portable(const byte_t *, const byte_t *, size_t);
+uint64_t (*hamming_implementation)(const byte_t *, const byte_t *, size_t) =
+    hamming_distance_portable;
+
+#define HAMMING_WORDS_LOOP(_A, _B, _SIZE, _DISTANCE)                           \
+    for (; _SIZE >= 8; _SIZE -= 8, _A += 8, _B += 8) {                         \
+        uint64_t _WORD_A_, _WORD_B_;                                           \
+        memcpy(&_WORD_A_, _A, sizeof(_WORD_A_));                               \
+        memcpy(&_WORD_B_, _B, sizeof(_WORD_B_));                               \
+        _DISTANCE += __builtin_popcountll(_WORD_A_ ^ _WORD_B_);                \
+    }                                                                          \
+    while (_SIZE-- > 0)                                                        \
+        _DISTANCE += __builtin_popcount(*_A++ ^ *_B++);
+
+uint64_t hamming_distance_portable(
+    const byte_t *a, const byte_t *b, size_t size
+) {
+
+    uint64_t distance = 0;
+    HAMMING_WORDS_LOOP(a, b, size, distance);
+    return distance;
+
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+__attribute__((target("popcnt")))
+uint64_t hamming_distance_popcnt(
+    const byte_t *a, const byte_t *b, size_t size
+) {
+
+    uint64_t distance = 0;
+    HAMMING_WORDS_LOOP(a, b, size, distance);
+    return distance;
+
+}
+
+/*
+
+Bits of every byte are counted with two lookups of nibbles in the table (see
+W. Mula, "Faster population counts using AVX2 instructions"). Byte counters are
+summed up before they can overflow.
+
+ */
+__attribute__((target("avx2,popcnt")))
+uint64_t hamming_distance_avx2(
+    const byte_t *a, const byte_t *b, size_t size
+) {
+
+    const __m256i lookup = _mm256_setr_epi8(
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    const __m256i zero = _mm256_setzero_si256();
+
+    __m256i total = zero;
+
+    while (size >= 32) {
+
+        __m256i counters = zero;
+
+        // every iteration adds at most 8 to a byte counter
+        for (uint8_t step = 0; step < 31 && size >= 32; step++) {
+            const __m256i difference = _mm256_xor_si256(
+                _mm256_loadu_si256((const __m256i *)a),
+                _mm256_loadu_si256((const __m256i *)b));
+            const __m256i low = _mm256_and_si256(difference, low_mask);
+            const __m256i high = _mm256_and_si256(
+                _mm256_srli_epi16(difference, 4), low_mask);
+            counters = _mm256_add_epi8(
+                counters,
+                _mm256_add_epi8(
+                    _mm256_shuffle_epi8(lookup, low),
+                    _mm256_shuffle_epi8(lookup, high)));
+            a += 32;
+            b += 32;
+            size -= 32;
+        }
+
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(counters, zero));
+
+    }
+
+    uint64_t distance =
+        (uint64_t)_mm256_extract_epi64(total, 0) +
+        (uint64_t)_mm256_extract_epi64(total, 1) +
+        (uint64_t)_mm256_extract_epi64(total, 2) +
+        (uint64_t)_mm256_extract_epi64(total, 3);
+
+    HAMMING_WORDS_LOOP(a, b, size, distance);
+    return distance;
+
+}
+
+#endif
+
+#undef HAMMING_WORDS_LOOP
+
+void hamming_init() {
+
+    #if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        hamming_implementation = hamming_distance_avx2;
+    else
+    if (__builtin_cpu_supports("popcnt"))
+        hamming_implementation = hamming_distance_popcnt;
+    #endif
+
+}
+
+/*
+
+Number of different bits in `size` bytes of `a` and `b`.
+
+ */
+uint64_t hamming_distance(
+    const byte_t * const a, const byte_t * const b, const size_t size
+) {
+
+    pthread_once(&hamming_init_once, hamming_init);
+    return hamming_implementation(a, b, size);
+
+}
+
+/*
+
+Hamming distance between genes of the genomes. Genes of the longer genome
+which the shorter one doesn't have are counted as completely different.
+
+ */
+uint64_t genomes_distance(
+    const genome_t * const a, const genome_t * const b,
+    const pool_t * const pool
+) {
+
+    const genome_length_t common_length =
+        a->length < b->length ? a->length : b->length;
+    const genome_length_t extra_length =
+        a->length < b->length ? b->length - a->length : a->length - b->length;
+
+    return
+        hamming_distance(
+            a->genes, b->genes,
+            (size_t)common_length * pool->gene_bytes_size) +
+        BYTES_TO_BITS((uint64_t)extra_length * pool->gene_bytes_size);
+
+}
+
+typedef struct distance_matrix_job_s {
+    const pool_t       *pool;
+    genome_t * const   *genomes;
+    uint64_t            organisms_number;
+    uint64_t           *matrix;
+    uint64_t            tiles_number;
+} distance_matrix_job_t;
+
+/*
+
+Items of the job are tiles of the upper triangle of the matrix (diagonal
+included), numbered row by row. Every tile also fills its mirror below the
+diagonal, so tiles never write the same cells.
+
+ */
+void distance_matrix_body(
+    void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+    const distance_matrix_job_t * const job = job_void;
+    const uint64_t n = job->organisms_number;
+
+    // find the tile `start` by skipping whole rows of tiles
+    uint64_t tile_row = 0, tile_column = 0, row_start = 0;
+    while (row_start + (job->tiles_number - tile_row) <= start) {
+        row_start += job->tiles_number - tile_row;
+        tile_row++;
+    }
+    tile_column = tile_row + (start - row_start);
+
+    for (uint64_t tile = start; tile < end; tile++) {
+
+        const uint64_t row_first = tile_row * DISTANCE_MATRIX_TILE,
+                       column_first = tile_column * DISTANCE_MATRIX_TILE;
+        const uint64_t row_last = row_first + DISTANCE_MATRIX_TILE < n
+                           ? row_first + DISTANCE_MATRIX_TILE : n,
+                       column_last = column_first + DISTANCE_MATRIX_TILE < n
+                           ? column_first + DISTANCE_MATRIX_TILE : n;
+
+        for (uint64_t row = row_first; row < row_last; row++)
+            for (
+                uint64_t column = tile_row == tile_column ? row : column_first;
+                column < column_last;
+                column++
+            ) {
+                const uint64_t distance = row == column ? 0 : genomes_distance(
+                    job->genomes[row], job->genomes[column], job->pool);
+                job->matrix[row * n + column] = distance;
+                job->matrix[column * n + row] = distance;
+            }
+
+        if (++tile_column == job->tiles_number) {
+            tile_row++;
+            tile_column = tile_row;
+        }
+
+    }
+
+}
+
+/*
+
+Fill `matrix` of organisms_number x organisms_number items (row-major) with
+distances between every pair of genomes using `threads_number` threads (0
+means the number of CPUs).
+
+ */
+void distance_matrix(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    uint64_t * const matrix,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    const uint64_t tiles_number =
+        (organisms_number + DISTANCE_MATRIX_TILE - 1) / DISTANCE_MATRIX_TILE;
+
+    distance_matrix_job_t job = {
+        .pool = pool,
+        .genomes = genomes,
+        .organisms_number = organisms_number,
+        .matrix = matrix,
+        .tiles_number = tiles_number
+    };
+
+    parallel_for(
+        tiles_number * (tiles_number + 1) / 2,
+        threads_number,
+        distance_matrix_body, &job);
+
+}
+
+typedef struct diversity_job_s {
+    const pool_t          *pool;
+    genome_t * const      *genomes;
+    const uint64_t        *pairs;
+    // normalized distance of every sampled pair
+    double                *distances;
+} diversity_job_t;
+
+void sample_diversity_body(
+    void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+    const diversity_job_t * const job = job_void;
+
+    for (uint64_t sample = start; sample < end; sample++) {
+
+        const genome_t * const a = job->genomes[job->pairs[sample * 2]],
+                       * const b = job->genomes[job->pairs[sample * 2 + 1]];
+
+        const uint64_t bits_number = BYTES_TO_BITS(
+            (uint64_t)(a->length > b->length ? a->length : b->length) *
+            job->pool->gene_bytes_size);
+
+        job->distances[sample] = bits_number == 0 ? 0 :
+            (double)genomes_distance(a, b, job->pool) / bits_number;
+
+    }
+
+}
+
+/*
+
+Estimate the diversity of the population as the mean share of different bits
+between two distinct genomes, using `samples_number` random pairs instead of
+all of them. Standard error of the estimate is written into `standard_error`
+if it's not NULL.
+
+ */
+double sample_diversity(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint64_t samples_number,
+    double * const standard_error,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (organisms_number < 2 || samples_number == 0) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return 0;
+    }
+
+    DECLARE_MALLOC_ARRAY(
+        uint64_t, pairs, samples_number * 2, RETURN_ZERO_ON_ERR);
+
+    DECLARE_MALLOC_ARRAY(
+        double, distances, samples_number,
+        free(pairs); RETURN_ZERO_ON_ERR);
+
+    ENSURE_MERSENNE_RND_SEED_IS_SET;
+
+    // pairs are drawn here, since generators are not thread-safe
+    for (uint64_t sample = 0; sample < samples_number; sample++) {
+        const uint64_t a = next_mersenne_random64_in_range(
+            0, organisms_number);
+        // shift by [1; N-1] to always pick another genome
+        const uint64_t b = (a + next_mersenne_random64_in_range(
+            1, organisms_number)) % organisms_number;
+        pairs[sample * 2] = a;
+        pairs[sample * 2 + 1] = b;
+    }
+
+    diversity_job_t job = {
+        .pool = pool,
+        .genomes = genomes,
+        .pairs = pairs,
+        .distances = distances
+    };
+
+    parallel_for(
+        samples_number, threads_number,
+        sample_diversity_body, &job);
+
+    double mean = 0;
+    for (uint64_t sample = 0; sample < samples_number; sample++)
+        mean += distances[sample];
+    mean /= samples_number;
+
+    if (standard_error != NULL) {
+        double variance = 0;
+        for (uint64_t sample = 0; sample < samples_number; sample++)
+            variance += (distances[sample] - mean) * (distances[sample] - mean);
+        *standard_error = samples_number > 1
+            ? sqrt(variance / (samples_number - 1) / samples_number)
+            : 0;
+    }
+
+    free(pairs);
+    free(distances);
+
+    return mean;
+
+}
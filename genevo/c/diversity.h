@@ -0,0 +1,86 @@
+/*
+
+This module contains Hamming distances between genomes and estimators of the
+population diversity built on them. Distances are computed straight on the
+gene bytes, so genomes read from the pool file are never copied.
+
+Population counting uses AVX2 or POPCNT instructions if the processor supports
+them, the portable version is used otherwise.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <immintrin.h>
+#endif
+
+#include "pool.h"
+#include "error.h"
+#include "memory.h"
+#include "rand.h"
+#include "parallel.h"
+
+// Number of genomes in the side of a tile of the distance matrix. Genes of two
+// tiles are expected to stay in the cache while the tile is computed.
+#ifndef DISTANCE_MATRIX_TILE
+#   define DISTANCE_MATRIX_TILE 32
+#endif
+
+/* @function hamming_distance
+ * @return uint64
+ * @argument uint8*
+ * @argument uint8*
+ * @argument size
+ */
+uint64_t hamming_distance(
+    const byte_t * const a, const byte_t * const b, const size_t size);
+
+/* @function genomes_distance
+ * @return uint64
+ * @argument genome*
+ * @argument genome*
+ * @argument pool*
+ */
+uint64_t genomes_distance(
+    const genome_t * const, const genome_t * const, const pool_t * const);
+
+/* @function distance_matrix
+ * @return void
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint64*
+ * @argument uint16
+ */
+void distance_matrix(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    uint64_t * const matrix,
+    const uint16_t threads_number);
+
+/* @function sample_diversity
+ * @return double
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint64
+ * @argument double*
+ * @argument uint16
+ */
+double sample_diversity(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint64_t samples_number,
+    double * const standard_error,
+    const uint16_t threads_number);
@@ -0,0 +1,296 @@
+/*
+
+This module contains methods for finding identical genomes.
+
+ */
+
+#include "duplicates.h"
+
+#define HASH_PRIME_1 0x9E3779B185EBCA87ULL
+#define HASH_PRIME_2 0xC2B2AE3D27D4EB4FULL
+#define HASH_PRIME_3 0x165667B19E3779F9ULL
+#define HASH_PRIME_4 0x85EBCA77C2B2AE63ULL
+#define HASH_PRIME_5 0x27D4EB2F165667C5ULL
+
+#define ROTATE_LEFT(_X, _R) (((_X) << (_R)) | ((_X) >> (64 - (_R))))
+
+#define HASH_ROUND(_ACCUMULATOR, _INPUT)                                       \
+    ROTATE_LEFT((_ACCUMULATOR) + (_INPUT) * HASH_PRIME_2, 31) * HASH_PRIME_1
+
+#define HASH_MERGE(_HASH, _ACCUMULATOR)                                        \
+    (((_HASH) ^ HASH_ROUND(0, _ACCUMULATOR)) * HASH_PRIME_1 + HASH_PRIME_4)
+
+/*
+
+64-bit hash of the bytes in the manner of xxHash64: 32-byte stripes are mixed
+into four independent accumulators, so the processor computes them in
+parallel.
+
+ */
+uint64_t hash_bytes(const uint64_t seed, const byte_t *data, size_t size) {
+
+    const size_t total_size = size;
+    uint64_t hash;
+
+    if (size >= 32) {
+
+        uint64_t accumulators[4] = {
+            seed + HASH_PRIME_1 + HASH_PRIME_2,
+            seed + HASH_PRIME_2,
+            seed,
+            seed - HASH_PRIME_1
+        };
+
+        for (; size >= 32; size -= 32, data += 32) {
+            uint64_t words[4];
+            memcpy(words, data, sizeof(words));
+            for (uint8_t lane = 0; lane < 4; lane++)
+                accumulators[lane] =
+                    HASH_ROUND(accumulators[lane], words[lane]);
+        }
+
+        hash =
+            ROTATE_LEFT(accumulators[0], 1) +
+            ROTATE_LEFT(accumulators[1], 7) +
+            ROTATE_LEFT(accumulators[2], 12) +
+            ROTATE_LEFT(accumulators[3], 18);
+
+        for (uint8_t lane = 0; lane < 4; lane++)
+            hash = HASH_MERGE(hash, accumulators[lane]);
+
+    } else
+        hash = seed + HASH_PRIME_5;
+
+    hash += total_size;
+
+    for (; size >= 8; size -= 8, data += 8) {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        hash ^= HASH_ROUND(0, word);
+        hash = ROTATE_LEFT(hash, 27) * HASH_PRIME_1 + HASH_PRIME_4;
+    }
+
+    for (; size > 0; size--, data++) {
+        hash ^= *data * HASH_PRIME_5;
+        hash = ROTATE_LEFT(hash, 11) * HASH_PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME_3;
+    hash ^= hash >> 32;
+
+    return hash;
+
+}
+
+#undef HASH_MERGE
+
+// Bits of the last residue byte after the residue itself are ignored
+#define RESIDUE_FULL_BYTES(_GENOME) ((_GENOME)->residue_size_bits / 8)
+#define RESIDUE_LAST_BYTE(_GENOME)                                             \
+    ((_GENOME)->residue_size_bits % 8 == 0 ? 0 :                               \
+        (_GENOME)->residue[RESIDUE_FULL_BYTES(_GENOME)] &                      \
+        (byte_t)(0xFF << (8 - (_GENOME)->residue_size_bits % 8)))
+
+uint64_t hash_genome(
+    const genome_t * const genome, const pool_gene_byte_size_t gene_bytes_size
+) {
+
+    uint64_t hash = hash_bytes(
+        (uint64_t)genome->residue_size_bits << 32 | genome->length,
+        genome->genes, (size_t)genome->length * gene_bytes_size);
+
+    if (genome->residue_size_bits > 0)
+        hash = hash_bytes(
+            hash ^ HASH_ROUND(0, RESIDUE_LAST_BYTE(genome)),
+            genome->residue, RESIDUE_FULL_BYTES(genome));
+
+    return hash;
+
+}
+
+#undef HASH_ROUND
+
+bool genomes_are_equal(
+    const genome_t * const a, const genome_t * const b,
+    const pool_gene_byte_size_t gene_bytes_size
+) {
+
+    return
+        a->length == b->length &&
+        a->residue_size_bits == b->residue_size_bits &&
+        memcmp(a->genes, b->genes, (size_t)a->length * gene_bytes_size) == 0 &&
+        (a->residue_size_bits == 0 || (
+            memcmp(a->residue, b->residue, RESIDUE_FULL_BYTES(a)) == 0 &&
+            RESIDUE_LAST_BYTE(a) == RESIDUE_LAST_BYTE(b)));
+
+}
+
+#undef RESIDUE_FULL_BYTES
+#undef RESIDUE_LAST_BYTE
+
+/*
+
+Create the set for `expected_size` genomes. The set is at most half full, so
+probing sequences stay short.
+
+ */
+genome_hash_set_t * create_genome_hash_set(
+    const uint64_t expected_size, const pool_gene_byte_size_t gene_bytes_size
+) {
+
+    DECLARE_CONST_MALLOC_OBJECT(genome_hash_set_t, set, RETURN_NULL_ON_ERR);
+
+    set->gene_bytes_size = gene_bytes_size;
+    set->size = 0;
+    set->capacity = 16;
+    while (set->capacity < expected_size * 2) set->capacity <<= 1;
+
+    set->slots = calloc(set->capacity, sizeof(genome_hash_slot_t));
+    if (set->slots == NULL) {
+        free(set);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    return set;
+
+}
+
+/*
+
+Insert the genome into the set with linear probing. If an identical genome is
+already in the set, its slot is returned and the set is not changed. Returns
+NULL if the genome was inserted. The set doesn't grow, so it should not get
+more genomes than it was created for.
+
+ */
+const genome_hash_slot_t * genome_hash_set_insert(
+    genome_hash_set_t * const set, const genome_t * const genome,
+    const uint64_t hash, const uint64_t index
+) {
+
+    const uint64_t mask = set->capacity - 1;
+
+    for (uint64_t slot_i = hash & mask;; slot_i = (slot_i + 1) & mask) {
+
+        genome_hash_slot_t * const slot = &set->slots[slot_i];
+
+        if (slot->genome == NULL) {
+            slot->hash = hash;
+            slot->genome = genome;
+            slot->index = index;
+            set->size++;
+            return NULL;
+        }
+
+        if (slot->hash == hash &&
+            genomes_are_equal(slot->genome, genome, set->gene_bytes_size))
+            return slot;
+
+    }
+
+}
+
+void destroy_genome_hash_set(genome_hash_set_t * const set) {
+    free(set->slots);
+    free(set);
+}
+
+typedef struct hashing_job_s {
+    const pool_t      *pool;
+    genome_t * const  *genomes;
+    uint64_t          *hashes;
+} hashing_job_t;
+
+void hash_population_body(
+    void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+    const hashing_job_t * const job = job_void;
+
+    for (uint64_t genome_i = start; genome_i < end; genome_i++)
+        job->hashes[genome_i] = hash_genome(
+            job->genomes[genome_i], job->pool->gene_bytes_size);
+
+}
+
+void hash_population(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    uint64_t * const hashes,
+    const uint16_t threads_number
+) {
+
+    hashing_job_t job = {
+        .pool = pool,
+        .genomes = genomes,
+        .hashes = hashes
+    };
+
+    parallel_for(
+        organisms_number, threads_number,
+        hash_population_body, &job);
+
+}
+
+/*
+
+Find groups of identical genomes. For every genome, `groups` gets the index of
+the first genome identical to it (that is its own index for unique genomes
+and the first genome of every group). Returns the number of genomes which
+duplicate some previous one.
+
+ */
+uint64_t find_duplicates(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    uint64_t * const groups,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (organisms_number == 0) return 0;
+
+    DECLARE_MALLOC_ARRAY(
+        uint64_t, hashes, organisms_number, RETURN_ZERO_ON_ERR);
+
+    hash_population(pool, genomes, organisms_number, hashes, threads_number);
+
+    genome_hash_set_t * const set =
+        create_genome_hash_set(organisms_number, pool->gene_bytes_size);
+    if (set == NULL) {
+        free(hashes);
+        return 0;
+    }
+
+    uint64_t duplicates_number = 0;
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    ) {
+
+        const genome_hash_slot_t * const original = genome_hash_set_insert(
+            set, genomes[genome_i], hashes[genome_i], genome_i);
+
+        if (original == NULL)
+            groups[genome_i] = genome_i;
+        else {
+            groups[genome_i] = original->index;
+            duplicates_number++;
+        }
+
+    }
+
+    destroy_genome_hash_set(set);
+    free(hashes);
+
+    return duplicates_number;
+
+}
@@ -0,0 +1,87 @@
+/*
+
+This module contains search of identical genomes. Every genome is hashed into
+a 64-bit number (genes and residue), and hashes are put into a hash set with
+open addressing. Genomes with equal hashes are compared byte by byte, so hash
+collisions never produce false duplicates.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "pool.h"
+#include "error.h"
+#include "memory.h"
+#include "parallel.h"
+
+typedef struct genome_hash_slot_s {
+    uint64_t          hash;
+    // NULL if the slot is empty
+    const genome_t   *genome;
+    uint64_t          index;
+} genome_hash_slot_t;
+
+typedef struct genome_hash_set_s {
+    pool_gene_byte_size_t  gene_bytes_size;
+    // capacity is a power of two
+    uint64_t               capacity;
+    uint64_t               size;
+    genome_hash_slot_t    *slots;
+} genome_hash_set_t;
+
+uint64_t hash_bytes(const uint64_t seed, const byte_t *data, size_t size);
+
+/* @function hash_genome
+ * @return uint64
+ * @argument genome*
+ * @argument uint8
+ */
+uint64_t hash_genome(const genome_t * const, const pool_gene_byte_size_t);
+
+bool genomes_are_equal(
+    const genome_t * const, const genome_t * const,
+    const pool_gene_byte_size_t);
+
+genome_hash_set_t * create_genome_hash_set(
+    const uint64_t expected_size, const pool_gene_byte_size_t);
+
+const genome_hash_slot_t * genome_hash_set_insert(
+    genome_hash_set_t * const, const genome_t * const,
+    const uint64_t hash, const uint64_t index);
+
+void destroy_genome_hash_set(genome_hash_set_t * const);
+
+/* @function hash_population
+ * @return void
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint64*
+ * @argument uint16
+ */
+void hash_population(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    uint64_t * const hashes,
+    const uint16_t threads_number);
+
+/* @function find_duplicates
+ * @return uint64
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint64*
+ * @argument uint16
+ */
+uint64_t find_duplicates(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    uint64_t * const groups,
+    const uint16_t threads_number);
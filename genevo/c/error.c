@@ -2,7 +2,57 @@
 
 #include <stdio.h>
 
-err_status_t ERROR_LEVEL = 0;
+__thread err_status_t ERROR_LEVEL = 0;
+__thread error_context_t ERROR_CONTEXT = {
+	.status = ERR_OK, .function = NULL,
+	.genome_index = ERROR_CONTEXT_UNKNOWN, .byte_offset = ERROR_CONTEXT_UNKNOWN
+};
+
+err_status_t get_error_level() {
+	return ERROR_LEVEL;
+}
+
+/*
+
+Write the description of ERROR_LEVEL of this thread into `context`. Returns
+false if the error was raised without one, then only `status` is set.
+
+ */
+bool get_error_context(error_context_t * const context) {
+
+	if (
+		ERROR_LEVEL != ERR_OK && ERROR_CONTEXT.status == ERROR_LEVEL &&
+		ERROR_CONTEXT.function != NULL
+	) {
+		*context = ERROR_CONTEXT;
+		return true;
+	}
+
+	*context = (error_context_t){
+		.status = ERROR_LEVEL, .function = NULL,
+		.genome_index = ERROR_CONTEXT_UNKNOWN,
+		.byte_offset = ERROR_CONTEXT_UNKNOWN
+	};
+	return false;
+
+}
+
+/*
+
+Set the error of another thread (saved with get_error_context) as the error of
+this one, unless this thread has already met an error itself.
+
+ */
+void propagate_error(
+	const err_status_t status, const error_context_t * const context
+) {
+
+	if (ERROR_LEVEL != ERR_OK || status == ERR_OK) return;
+
+	ERROR_LEVEL = status;
+	ERROR_CONTEXT = *context;
+
+}
 
 const char * get_err_string(const err_status_t errcode) {
 
@@ -13,6 +63,9 @@ const char * get_err_string(const err_status_t errcode) {
 		case ERR_CANNOT_MALLOC:
 			return ERR_CANNOT_MALLOC_STR;
 			break;
+		case ERR_CANNOT_SPAWN_THREAD:
+			return ERR_CANNOT_SPAWN_THREAD_STR;
+			break;
 		case ERR_OUT_OF_BOUNDS:
 			return ERR_OUT_OF_BOUNDS_STR;
 			break;
@@ -43,6 +96,15 @@ const char * get_err_string(const err_status_t errcode) {
 		case ERR_FILE_CANNOT_STRETCH_READ:
 			return ERR_FILE_CANNOT_STRETCH_READ_STR;
 			break;
+		case ERR_FILE_CANNOT_SYNC:
+			return ERR_FILE_CANNOT_SYNC_STR;
+			break;
+		case ERR_FILE_CANNOT_RENAME:
+			return ERR_FILE_CANNOT_RENAME_STR;
+			break;
+		case ERR_FILE_CANNOT_REMOVE:
+			return ERR_FILE_CANNOT_REMOVE_STR;
+			break;
 		case ERR_POOL_CORRUPT_TOO_SMALL:
 			return ERR_POOL_CORRUPT_TOO_SMALL_STR;
 			break;
@@ -58,6 +120,12 @@ const char * get_err_string(const err_status_t errcode) {
 		case ERR_POOL_CORRUPT_END:
 			return ERR_POOL_CORRUPT_END_STR;
 			break;
+		case ERR_POOL_CHECKSUM_MISMATCH:
+			return ERR_POOL_CHECKSUM_MISMATCH_STR;
+			break;
+		case ERR_POOL_CHECKSUMS_CORRUPT:
+			return ERR_POOL_CHECKSUMS_CORRUPT_STR;
+			break;
 		case ERR_GENM_CORRUPT_METADATA_START:
 			return ERR_GENM_CORRUPT_METADATA_START_STR;
 			break;
@@ -76,6 +144,9 @@ const char * get_err_string(const err_status_t errcode) {
 		case ERR_GENM_END_ITERATION:
 			return ERR_GENM_END_ITERATION_STR;
 			break;
+		case ERR_GENM_CHECKSUM_MISMATCH:
+			return ERR_GENM_CHECKSUM_MISMATCH_STR;
+			break;
 		case ERR_GENE_NOT_ALIGNED:
 			return ERR_GENE_NOT_ALIGNED_STR;
 			break;
@@ -85,6 +156,81 @@ const char * get_err_string(const err_status_t errcode) {
 		case ERR_GENE_WEIGHT_TOO_LARGE:
 			return ERR_GENE_WEIGHT_TOO_LARGE_STR;
 			break;
+		case ERR_CHECKPOINT_CORRUPT_START:
+			return ERR_CHECKPOINT_CORRUPT_START_STR;
+			break;
+		case ERR_CHECKPOINT_WRONG_VERSION:
+			return ERR_CHECKPOINT_WRONG_VERSION_STR;
+			break;
+		case ERR_CHECKPOINT_CORRUPT_SIZE:
+			return ERR_CHECKPOINT_CORRUPT_SIZE_STR;
+			break;
+		case ERR_CHECKPOINT_CORRUPT_RNG:
+			return ERR_CHECKPOINT_CORRUPT_RNG_STR;
+			break;
+		case ERR_CHECKPOINT_CORRUPT_END:
+			return ERR_CHECKPOINT_CORRUPT_END_STR;
+			break;
+		case ERR_ARCHIVE_CORRUPT_START:
+			return ERR_ARCHIVE_CORRUPT_START_STR;
+			break;
+		case ERR_ARCHIVE_WRONG_VERSION:
+			return ERR_ARCHIVE_WRONG_VERSION_STR;
+			break;
+		case ERR_ARCHIVE_CORRUPT_ENTRY:
+			return ERR_ARCHIVE_CORRUPT_ENTRY_STR;
+			break;
+		case ERR_ARCHIVE_NO_GENERATION:
+			return ERR_ARCHIVE_NO_GENERATION_STR;
+			break;
+		case ERR_ARCHIVE_CORRUPT_DELTA:
+			return ERR_ARCHIVE_CORRUPT_DELTA_STR;
+			break;
+		case ERR_CPOOL_CORRUPT_START:
+			return ERR_CPOOL_CORRUPT_START_STR;
+			break;
+		case ERR_CPOOL_WRONG_VERSION:
+			return ERR_CPOOL_WRONG_VERSION_STR;
+			break;
+		case ERR_CPOOL_CORRUPT_INDEX:
+			return ERR_CPOOL_CORRUPT_INDEX_STR;
+			break;
+		case ERR_CPOOL_CORRUPT_CHUNK:
+			return ERR_CPOOL_CORRUPT_CHUNK_STR;
+			break;
+		case ERR_CPOOL_NO_GENOME:
+			return ERR_CPOOL_NO_GENOME_STR;
+			break;
+		case ERR_MANIFEST_CORRUPT_START:
+			return ERR_MANIFEST_CORRUPT_START_STR;
+			break;
+		case ERR_MANIFEST_WRONG_VERSION:
+			return ERR_MANIFEST_WRONG_VERSION_STR;
+			break;
+		case ERR_MANIFEST_CORRUPT_TABLE:
+			return ERR_MANIFEST_CORRUPT_TABLE_STR;
+			break;
+		case ERR_SHARD_MISMATCH:
+			return ERR_SHARD_MISMATCH_STR;
+			break;
+		case ERR_SHARD_NO_ORGANISM:
+			return ERR_SHARD_NO_ORGANISM_STR;
+			break;
+		case ERR_MIGRATION_TIMEOUT:
+			return ERR_MIGRATION_TIMEOUT_STR;
+			break;
+		case ERR_MIGRATION_TOO_LARGE:
+			return ERR_MIGRATION_TOO_LARGE_STR;
+			break;
+		case ERR_MIGRATION_CORRUPT:
+			return ERR_MIGRATION_CORRUPT_STR;
+			break;
+		case ERR_MIGRATION_INCOMPATIBLE:
+			return ERR_MIGRATION_INCOMPATIBLE_STR;
+			break;
+		case ERR_MIGRATION_CANNOT_CONNECT:
+			return ERR_MIGRATION_CANNOT_CONNECT_STR;
+			break;
 		default:
 			return ERR_OK_STR;
 			break;
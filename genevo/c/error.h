@@ -3,11 +3,21 @@
 This header contains declarations for all error levels that are being used
 across the library.
 
+ERROR_LEVEL is thread-local: every thread sees the status of the last call it
+made itself, so functions may be called from several threads at once.
+Functions running loops with parallel_for report the first error met by their
+worker threads.
+
+Some errors also tell where they happened (see RAISE_ERROR_AT and
+get_error_context): the function, index of the genome and offset of the byte
+in the pool dump or genes array.
+
  */
 
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <wchar.h>
 #include <stdint.h>
 
@@ -19,10 +29,49 @@ typedef uint8_t err_status_t;
  */
 const char * get_err_string(const err_status_t errcode);
 
-/* @variable ERROR_LEVEL
- * @type uint8
+// Value of genome_index and byte_offset of error_context if they are unknown
+#define ERROR_CONTEXT_UNKNOWN UINT64_MAX
+
+/* @typedef error_context_p
+ * @from_type error_context*
+ */
+/* @struct error_context
+ * @member uint8 status
+ * @member char* function
+ * @member uint64 genome_index
+ * @member uint64 byte_offset
+ */
+typedef struct error_context_s {
+    err_status_t  status;
+    const char   *function;
+    uint64_t      genome_index;
+    uint64_t      byte_offset;
+} error_context_t;
+
+extern __thread err_status_t ERROR_LEVEL;
+// Description of the last error raised with RAISE_ERROR_AT in this thread. It
+// belongs to ERROR_LEVEL only while their statuses are the same.
+extern __thread error_context_t ERROR_CONTEXT;
+
+#define RAISE_ERROR_AT(_STATUS, _GENOME_INDEX, _BYTE_OFFSET) {                 \
+    ERROR_LEVEL = (_STATUS);                                                   \
+    ERROR_CONTEXT = (error_context_t){                                         \
+        .status = (_STATUS), .function = __func__,                             \
+        .genome_index = (_GENOME_INDEX), .byte_offset = (_BYTE_OFFSET) };      \
+}
+
+/* @function get_error_level
+ * @return uint8
+ */
+err_status_t get_error_level();
+
+/* @function get_error_context
+ * @return uint8
+ * @argument error_context*
  */
-extern err_status_t ERROR_LEVEL;
+bool get_error_context(error_context_t * const);
+
+void propagate_error(const err_status_t, const error_context_t * const);
 
 
 #define ERR_OK                              (err_status_t)0x00
@@ -34,6 +83,9 @@ extern err_status_t ERROR_LEVEL;
 #define ERR_CANNOT_MALLOC                   (err_status_t)0xf0
 #define ERR_CANNOT_MALLOC_STR               "Cannot allocate memory."
 
+#define ERR_CANNOT_SPAWN_THREAD             (err_status_t)0xf1
+#define ERR_CANNOT_SPAWN_THREAD_STR         "Cannot create new thread."
+
 
 // General errors ==============================================================
 
@@ -81,6 +133,17 @@ extern err_status_t ERROR_LEVEL;
 #define ERR_FILE_CANNOT_STRETCH_READ_STR    "Cannot set size of the file in "  \
                                             "read mode."
 
+#define ERR_FILE_CANNOT_SYNC                (err_status_t)0x07
+#define ERR_FILE_CANNOT_SYNC_STR            "Cannot flush the file mapping "   \
+                                            "to the disk."
+
+#define ERR_FILE_CANNOT_RENAME              (err_status_t)0x08
+#define ERR_FILE_CANNOT_RENAME_STR          "Cannot move the file to its "     \
+                                            "final address."
+
+#define ERR_FILE_CANNOT_REMOVE              (err_status_t)0x09
+#define ERR_FILE_CANNOT_REMOVE_STR          "Cannot remove the file."
+
 // Gene pool file errors =======================================================
 
 #define ERR_POOL_CORRUPT_TOO_SMALL          (err_status_t)0x11
@@ -106,6 +169,14 @@ extern err_status_t ERROR_LEVEL;
 #define ERR_POOL_CORRUPT_END_STR            "Terminal byte of the gene pool "  \
                                             "was not found."
 
+#define ERR_POOL_CHECKSUM_MISMATCH          (err_status_t)0x16
+#define ERR_POOL_CHECKSUM_MISMATCH_STR      "Description of the pool does not "\
+                                            "match its checksum."
+
+#define ERR_POOL_CHECKSUMS_CORRUPT          (err_status_t)0x17
+#define ERR_POOL_CHECKSUMS_CORRUPT_STR      "Checksums file is corrupted or "  \
+                                            "belongs to another pool."
+
 
 // Genome errors ===============================================================
 
@@ -133,6 +204,10 @@ extern err_status_t ERROR_LEVEL;
 #define ERR_GENM_END_ITERATION              (err_status_t)0x26
 #define ERR_GENM_END_ITERATION_STR          "End of the pool reached."
 
+#define ERR_GENM_CHECKSUM_MISMATCH          (err_status_t)0x27
+#define ERR_GENM_CHECKSUM_MISMATCH_STR      "Data of the genome does not "     \
+                                            "match its checksum."
+
 
 // Gene ========================================================================
 
@@ -155,3 +230,112 @@ extern err_status_t ERROR_LEVEL;
 #define ERR_SM_WRONG_DISTRIBUTION           (err_status_t)0x41
 #define ERR_SM_WRONG_DISTRIBUTION_STR       "Wrong distribution were given to "\
                                             "the state machine."
+
+// Checkpoints =================================================================
+
+#define ERR_CHECKPOINT_CORRUPT_START        (err_status_t)0x51
+#define ERR_CHECKPOINT_CORRUPT_START_STR    "Initial byte of the checkpoint "  \
+                                            "was not found."
+
+#define ERR_CHECKPOINT_WRONG_VERSION        (err_status_t)0x52
+#define ERR_CHECKPOINT_WRONG_VERSION_STR    "Checkpoint was written with "     \
+                                            "unsupported format version."
+
+#define ERR_CHECKPOINT_CORRUPT_SIZE         (err_status_t)0x53
+#define ERR_CHECKPOINT_CORRUPT_SIZE_STR     "Size of the checkpoint file does "\
+                                            "not match its description."
+
+#define ERR_CHECKPOINT_CORRUPT_RNG          (err_status_t)0x54
+#define ERR_CHECKPOINT_CORRUPT_RNG_STR      "States of random generators in "  \
+                                            "the checkpoint are corrupted."
+
+#define ERR_CHECKPOINT_CORRUPT_END          (err_status_t)0x55
+#define ERR_CHECKPOINT_CORRUPT_END_STR      "Terminal byte of the checkpoint " \
+                                            "was not found."
+
+// Archives ====================================================================
+
+#define ERR_ARCHIVE_CORRUPT_START           (err_status_t)0x61
+#define ERR_ARCHIVE_CORRUPT_START_STR       "Initial byte of the archive was " \
+                                            "not found."
+
+#define ERR_ARCHIVE_WRONG_VERSION           (err_status_t)0x62
+#define ERR_ARCHIVE_WRONG_VERSION_STR       "Archive was written with "        \
+                                            "unsupported format version."
+
+#define ERR_ARCHIVE_CORRUPT_ENTRY           (err_status_t)0x63
+#define ERR_ARCHIVE_CORRUPT_ENTRY_STR       "Generation entry of the archive " \
+                                            "is corrupted."
+
+#define ERR_ARCHIVE_NO_GENERATION           (err_status_t)0x64
+#define ERR_ARCHIVE_NO_GENERATION_STR       "Requested generation is not "     \
+                                            "stored in the archive."
+
+#define ERR_ARCHIVE_CORRUPT_DELTA           (err_status_t)0x65
+#define ERR_ARCHIVE_CORRUPT_DELTA_STR       "Delta of the generation refers "  \
+                                            "to non-existent parents or genes."
+
+// Compressed pools ============================================================
+
+#define ERR_CPOOL_CORRUPT_START             (err_status_t)0x71
+#define ERR_CPOOL_CORRUPT_START_STR         "Initial byte of the compressed "  \
+                                            "pool was not found."
+
+#define ERR_CPOOL_WRONG_VERSION             (err_status_t)0x72
+#define ERR_CPOOL_WRONG_VERSION_STR         "Compressed pool was written with "\
+                                            "unsupported format version."
+
+#define ERR_CPOOL_CORRUPT_INDEX             (err_status_t)0x73
+#define ERR_CPOOL_CORRUPT_INDEX_STR         "Chunk index of the compressed "   \
+                                            "pool is corrupted."
+
+#define ERR_CPOOL_CORRUPT_CHUNK             (err_status_t)0x74
+#define ERR_CPOOL_CORRUPT_CHUNK_STR         "Chunk of the compressed pool "    \
+                                            "cannot be decompressed."
+
+#define ERR_CPOOL_NO_GENOME                 (err_status_t)0x75
+#define ERR_CPOOL_NO_GENOME_STR             "Compressed pool has no genome "   \
+                                            "with such index."
+
+// Sharded pools ===============================================================
+
+#define ERR_MANIFEST_CORRUPT_START          (err_status_t)0x81
+#define ERR_MANIFEST_CORRUPT_START_STR      "Initial byte of the pool "        \
+                                            "manifest was not found."
+
+#define ERR_MANIFEST_WRONG_VERSION          (err_status_t)0x82
+#define ERR_MANIFEST_WRONG_VERSION_STR      "Pool manifest was written with "  \
+                                            "unsupported format version."
+
+#define ERR_MANIFEST_CORRUPT_TABLE          (err_status_t)0x83
+#define ERR_MANIFEST_CORRUPT_TABLE_STR      "Shards table of the pool "        \
+                                            "manifest is corrupted."
+
+#define ERR_SHARD_MISMATCH                  (err_status_t)0x84
+#define ERR_SHARD_MISMATCH_STR              "Shard file does not match the "   \
+                                            "description in the manifest."
+
+#define ERR_SHARD_NO_ORGANISM               (err_status_t)0x85
+#define ERR_SHARD_NO_ORGANISM_STR           "Sharded pool has no organism "    \
+                                            "with such index."
+
+// Migration ===================================================================
+
+#define ERR_MIGRATION_TIMEOUT               (err_status_t)0x91
+#define ERR_MIGRATION_TIMEOUT_STR           "Neighbor islands did not respond "\
+                                            "in time."
+
+#define ERR_MIGRATION_TOO_LARGE             (err_status_t)0x92
+#define ERR_MIGRATION_TOO_LARGE_STR         "Migrants do not fit into the "    \
+                                            "migration slot."
+
+#define ERR_MIGRATION_CORRUPT               (err_status_t)0x93
+#define ERR_MIGRATION_CORRUPT_STR           "Received migrants are corrupted."
+
+#define ERR_MIGRATION_INCOMPATIBLE          (err_status_t)0x94
+#define ERR_MIGRATION_INCOMPATIBLE_STR      "Neighbor island has different "   \
+                                            "genomes or migration settings."
+
+#define ERR_MIGRATION_CANNOT_CONNECT        (err_status_t)0x95
+#define ERR_MIGRATION_CANNOT_CONNECT_STR    "Cannot connect to the neighbor "  \
+                                            "island."
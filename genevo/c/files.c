@@ -1,3 +1,6 @@
+// sync_file_range and mremap are Linux extensions
+#define _GNU_SOURCE
+
 #include "files.h"
 
 /*
@@ -20,18 +23,50 @@ void set_file_size(int descriptor, size_t new_size) {
 
 }
 
+/*
+
+Open the file, shared memory object or memory file (see files.h) with flags
+corresponding to the mode. Returns -1 on failure.
+
+ */
+int open_descriptor(const char *address, map_mode_t mode) {
+
+    const int flags = mode == OPEN_MODE_WRITE
+        ? O_RDWR | O_CREAT | O_TRUNC
+        : mode == OPEN_MODE_READ_WRITE
+        ? O_RDWR
+        : O_RDONLY;
+
+    if (ADDRESS_HAS_PREFIX(address, SHARED_MEMORY_ADDRESS_PREFIX))
+        return shm_open(
+            address + sizeof(SHARED_MEMORY_ADDRESS_PREFIX) - 1,
+            flags, (mode_t)0600);
+
+    if (ADDRESS_HAS_PREFIX(address, MEMFD_ADDRESS_PREFIX)) {
+    #ifdef __linux__
+        // memory file can't be opened again by its name
+        return mode == OPEN_MODE_WRITE
+            ? memfd_create(address + sizeof(MEMFD_ADDRESS_PREFIX) - 1, 0)
+            : -1;
+    #else
+        return -1;
+    #endif
+    }
+
+    return open(address, flags, (mode_t)0600);
+
+}
+
 file_map_t * open_file(const char *address, map_mode_t mode, size_t trunc_to_size) {
 
     ERROR_LEVEL = 0;
 
-    if (mode == OPEN_MODE_READ && trunc_to_size > 0) {
+    if (mode != OPEN_MODE_WRITE && trunc_to_size > 0) {
         ERROR_LEVEL = ERR_FILE_CANNOT_STRETCH_READ;
         return NULL;
     }
 
-    int descriptor = mode == OPEN_MODE_READ
-        ? open(address, O_RDONLY, 0)
-        : open(address, O_RDWR | O_CREAT | O_TRUNC, (mode_t)0600);
+    const int descriptor = open_descriptor(address, mode);
 
     if (descriptor < 0) {
         ERROR_LEVEL = ERR_FILE_CANNOT_OPEN;
@@ -60,13 +95,22 @@ file_map_t * open_file(const char *address, map_mode_t mode, size_t trunc_to_siz
 
     }
 
+    // read-only mapping is shared, so changes published by other processes
+    // (e.g. into shared memory) are visible without remapping
     void * const data = mode == OPEN_MODE_READ
         ? mmap(
             NULL, file_size,
             PROT_READ,
-            MAP_PRIVATE,
+            MAP_SHARED,
             descriptor,
             0) // offset
+        : mode == OPEN_MODE_COPY_ON_WRITE
+        ? mmap(
+            NULL, file_size,
+            PROT_READ | PROT_WRITE,
+            MAP_PRIVATE,
+            descriptor,
+            0)
         : mmap(
             NULL, file_size,
             PROT_READ | PROT_WRITE,
@@ -101,3 +145,103 @@ void close_file(file_map_t * const mapping) {
     free(mapping);
 
 }
+
+/*
+
+Delete the file or shared memory object. Processes which have already mapped
+it keep their mappings.
+
+ */
+void remove_file(const char *address) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (ADDRESS_HAS_PREFIX(address, MEMFD_ADDRESS_PREFIX)) return;
+
+    const int result =
+        ADDRESS_HAS_PREFIX(address, SHARED_MEMORY_ADDRESS_PREFIX)
+            ? shm_unlink(address + sizeof(SHARED_MEMORY_ADDRESS_PREFIX) - 1)
+            : unlink(address);
+
+    if (result != 0) ERROR_LEVEL = ERR_FILE_CANNOT_REMOVE;
+
+}
+
+/*
+
+Change size of the file and remap it. Data already written into the mapping is
+kept. The mapping should be opened with OPEN_MODE_WRITE or
+OPEN_MODE_READ_WRITE. Note, that `mapping->data` may be moved.
+
+ */
+void resize_file(file_map_t * const mapping, size_t new_size) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (ftruncate(mapping->descriptor, new_size) != 0) {
+        ERROR_LEVEL = ERR_FILE_CANNOT_WRITE;
+        return;
+    }
+
+    #ifdef __linux__
+    void * const data =
+        mremap(mapping->data, mapping->size, new_size, MREMAP_MAYMOVE);
+    #else
+    munmap(mapping->data, mapping->size);
+    void * const data = mmap(
+        NULL, new_size,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED,
+        mapping->descriptor,
+        0);
+    #endif
+
+    if (data == MAP_FAILED) {
+        ERROR_LEVEL = ERR_FILE_CANNOT_MMAP;
+        return;
+    }
+
+    mapping->data = data;
+    mapping->size = new_size;
+
+}
+
+/*
+
+Write the given range of the mapping back to the file. Range is extended to
+the page boundaries. If wait is false, the writeback is only started and the
+function returns immediately, so the caller can continue its computations
+while the kernel is writing pages.
+
+ */
+void flush_file_range(
+    file_map_t * const mapping, size_t offset, size_t size, bool wait
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (offset >= mapping->size) return;
+    if (offset + size > mapping->size) size = mapping->size - offset;
+
+    const size_t page_size = sysconf(_SC_PAGESIZE);
+    const size_t aligned_offset = offset - offset % page_size;
+    size += offset - aligned_offset;
+
+    if (msync(
+        (uint8_t *)mapping->data + aligned_offset, size,
+        wait ? MS_SYNC : MS_ASYNC
+    ) != 0) {
+        ERROR_LEVEL = ERR_FILE_CANNOT_SYNC;
+        return;
+    }
+
+    #ifdef __linux__
+    // MS_ASYNC does not start any I/O on Linux, so writeback of the range is
+    // initiated explicitly.
+    if (!wait)
+        sync_file_range(
+            mapping->descriptor, aligned_offset, size,
+            SYNC_FILE_RANGE_WRITE);
+    #endif
+
+}
@@ -10,6 +10,8 @@ TODO: add Windows support.
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
 
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -18,6 +20,25 @@ TODO: add Windows support.
 
 #include "error.h"
 
+/*
+
+Addresses starting with SHARED_MEMORY_ADDRESS_PREFIX refer to POSIX shared
+memory objects, e.g. "shm:/population.pool" is opened with
+shm_open("/population.pool"). Other processes can map such pool with zero
+copying just by its address.
+
+Addresses starting with MEMFD_ADDRESS_PREFIX create anonymous memory files
+(Linux only) which can be opened only for writing. The rest of the address is
+the name shown in /proc. Other processes can reach them by the descriptor of
+the mapping, either inherited with fork or via /proc/<pid>/fd/<descriptor>.
+
+ */
+#define SHARED_MEMORY_ADDRESS_PREFIX "shm:"
+#define MEMFD_ADDRESS_PREFIX         "memfd:"
+
+#define ADDRESS_HAS_PREFIX(_ADDRESS, _PREFIX)                                  \
+    (strncmp((_ADDRESS), (_PREFIX), sizeof(_PREFIX) - 1) == 0)
+
 /* @struct file_map
  * @member int descriptor
  * @member size size
@@ -29,12 +50,26 @@ typedef struct file_map_s {
     void   *data;
 } file_map_t;
 
+/*
+
+OPEN_MODE_COPY_ON_WRITE maps existing file as writable, but none of the changes
+will be carried to the file itself.
+OPEN_MODE_READ_WRITE maps existing file as writable without truncating it, so
+it can be extended later with resize_file.
+
+ */
 typedef enum map_mode_e {
-    OPEN_MODE_READ  = (uint8_t)(1 << 0),
-    OPEN_MODE_WRITE = (uint8_t)(1 << 1)
+    OPEN_MODE_READ          = (uint8_t)(1 << 0),
+    OPEN_MODE_WRITE         = (uint8_t)(1 << 1),
+    OPEN_MODE_COPY_ON_WRITE = (uint8_t)(1 << 2),
+    OPEN_MODE_READ_WRITE    = (uint8_t)(1 << 3)
 } map_mode_t;
 
 void set_file_size(int descriptor, size_t new_size);
 file_map_t * open_file(
     const char *address, map_mode_t mode, size_t trunc_to_size);
 void close_file(file_map_t * const mapping);
+void remove_file(const char *address);
+void resize_file(file_map_t * const mapping, size_t new_size);
+void flush_file_range(
+    file_map_t * const mapping, size_t offset, size_t size, bool wait);
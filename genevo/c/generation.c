@@ -0,0 +1,140 @@
+/*
+
+This module contains the counter of published generations.
+
+ */
+
+#include "generation.h"
+
+generation_counter_t * map_generation_counter(
+    const char *address, const map_mode_t mode
+) {
+
+    // open_file maps one byte less than it writes into the stretched file
+    file_map_t * const mapping = open_file(
+        address, mode, mode == OPEN_MODE_WRITE ? sizeof(uint32_t) - 1 : 0);
+    if (ERROR_LEVEL == ERR_OK && mode == OPEN_MODE_WRITE)
+        resize_file(mapping, sizeof(uint32_t));
+    if (ERROR_LEVEL == ERR_OK && mapping->size < sizeof(uint32_t))
+        ERROR_LEVEL = ERR_FILE_CANNOT_MMAP;
+    if (ERROR_LEVEL != ERR_OK) {
+        const err_status_t status = ERROR_LEVEL;
+        if (mapping != NULL) close_file(mapping);
+        ERROR_LEVEL = status;
+        return NULL;
+    }
+
+    generation_counter_t * const counter =
+        malloc(sizeof(generation_counter_t));
+    if (counter == NULL) {
+        close_file(mapping);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    counter->file_mapping = mapping;
+    counter->generation = mapping->data;
+
+    return counter;
+
+}
+
+/*
+
+Create the counter with generation 0 at `address`. An existing counter is
+reset.
+
+ */
+generation_counter_t * create_generation_counter(const char *address) {
+    return map_generation_counter(address, OPEN_MODE_WRITE);
+}
+
+/*
+
+Map existing counter read-only.
+
+ */
+generation_counter_t * open_generation_counter(const char *address) {
+    return map_generation_counter(address, OPEN_MODE_READ);
+}
+
+/*
+
+Set the counter and wake up all the processes waiting for it. Everything
+written into the pool before the call is visible to the processes which see
+the new value.
+
+ */
+void publish_generation(
+    generation_counter_t * const counter, const uint32_t generation
+) {
+
+    __atomic_store_n(counter->generation, generation, __ATOMIC_RELEASE);
+
+    #ifdef __linux__
+    syscall(
+        SYS_futex, counter->generation, FUTEX_WAKE, INT32_MAX,
+        NULL, NULL, 0);
+    #endif
+
+}
+
+uint32_t get_published_generation(const generation_counter_t * const counter) {
+    return __atomic_load_n(counter->generation, __ATOMIC_ACQUIRE);
+}
+
+/*
+
+Block until the counter differs from `seen_generation` or `timeout_ms`
+milliseconds pass (0 means wait forever). Returns the current value of the
+counter, which equals `seen_generation` on timeout.
+
+ */
+uint32_t wait_for_generation(
+    const generation_counter_t * const counter,
+    const uint32_t seen_generation, const uint32_t timeout_ms
+) {
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+
+    uint32_t generation;
+
+    while ((generation = get_published_generation(counter)) == seen_generation) {
+
+        struct timespec now, left;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        left.tv_sec = deadline.tv_sec - now.tv_sec;
+        left.tv_nsec = deadline.tv_nsec - now.tv_nsec;
+        if (left.tv_nsec < 0) {
+            left.tv_sec--;
+            left.tv_nsec += 1000000000;
+        }
+        if (timeout_ms > 0 && left.tv_sec < 0) break;
+
+        #ifdef __linux__
+        // the mapping is shared, so the futex is seen by all the processes
+        syscall(
+            SYS_futex, counter->generation, FUTEX_WAIT, seen_generation,
+            timeout_ms > 0 ? &left : NULL, NULL, 0);
+        #else
+        const struct timespec poll_interval = {0, 1000000};
+        nanosleep(&poll_interval, NULL);
+        #endif
+
+    }
+
+    return generation;
+
+}
+
+void close_generation_counter(generation_counter_t * const counter) {
+    close_file(counter->file_mapping);
+    free(counter);
+}
@@ -0,0 +1,84 @@
+/*
+
+This module contains a counter of published generations shared between
+processes. The process running evolution writes every new generation into its
+own pool (e.g. "shm:/run.pool.<generation>", see files.h) and then publishes
+its number. Evaluators map the counter read-only, wait until the number
+changes and open the published pool with read_pool.
+
+The counter is a single 32-bit word kept in a file or shared memory object in
+host byte order. It is a live value rather than a dump, so it's never moved
+between machines.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#ifdef __linux__
+#   include <linux/futex.h>
+#   include <sys/syscall.h>
+#endif
+
+#include "error.h"
+#include "files.h"
+#include "memory.h"
+
+/* @typedef generation_counter_p
+ * @from_type generation_counter*
+ */
+/* @struct generation_counter
+ * @member file_map* file_mapping
+ * @member uint32* generation
+ */
+typedef struct generation_counter_s {
+    file_map_t         *file_mapping;
+    // points into the mapping
+    uint32_t           *generation;
+} generation_counter_t;
+
+/* @function create_generation_counter
+ * @return generation_counter*
+ * @argument char*
+ */
+generation_counter_t * create_generation_counter(const char *address);
+
+/* @function open_generation_counter
+ * @return generation_counter*
+ * @argument char*
+ */
+generation_counter_t * open_generation_counter(const char *address);
+
+/* @function publish_generation
+ * @return void
+ * @argument generation_counter*
+ * @argument uint32
+ */
+void publish_generation(
+    generation_counter_t * const, const uint32_t generation);
+
+/* @function get_published_generation
+ * @return uint32
+ * @argument generation_counter*
+ */
+uint32_t get_published_generation(const generation_counter_t * const);
+
+/* @function wait_for_generation
+ * @return uint32
+ * @argument generation_counter*
+ * @argument uint32
+ * @argument uint32
+ */
+uint32_t wait_for_generation(
+    const generation_counter_t * const, const uint32_t seen_generation,
+    const uint32_t timeout_ms);
+
+/* @function close_generation_counter
+ * @return void
+ * @argument generation_counter*
+ */
+void close_generation_counter(generation_counter_t * const);
@@ -0,0 +1,270 @@
+/*
+
+This module contains counters of probes.
+
+ */
+
+#include "instrumentation.h"
+
+const char * const probe_names[PROBES_NUMBER] = {
+    [PROBE_FILL_POOL]          = "fill_pool",
+    [PROBE_SAVE_POOL]          = "save_pool",
+    [PROBE_READ_NEXT_GENOME]   = "read_next_genome",
+    [PROBE_CROSSOVER_GENOMES]  = "crossover_genomes",
+    [PROBE_FLIP_BITS]          = "flip_bits_with_probability",
+    [PROBE_CHANGE_GENES]       = "change_genes_with_probability",
+    [PROBE_MACHINE_NEXT_STATE] = "machine_next_state"
+};
+
+bool instrumentation_enabled() {
+    #ifdef ENABLE_INSTRUMENTATION
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+uint8_t get_probes_number() {
+    return PROBES_NUMBER;
+}
+
+const char * get_probe_name(const probe_id_t probe) {
+    return probe < PROBES_NUMBER ? probe_names[probe] : NULL;
+}
+
+/*
+
+Ticks of the time stamp counter if the processor has it, nanoseconds
+otherwise.
+
+ */
+uint64_t read_probe_ticks() {
+
+    #if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+    #else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+    #endif
+
+}
+
+double ticks_per_second = 1e9;
+pthread_once_t ticks_calibration_once = PTHREAD_ONCE_INIT;
+
+void calibrate_ticks() {
+
+    #if defined(__x86_64__) || defined(__i386__)
+    struct timespec start, end, pause = { .tv_sec = 0, .tv_nsec = 20000000 };
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    const uint64_t start_ticks = read_probe_ticks();
+    nanosleep(&pause, NULL);
+    const uint64_t end_ticks = read_probe_ticks();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    const double seconds =
+        (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+    if (seconds > 0) ticks_per_second = (end_ticks - start_ticks) / seconds;
+    #endif
+
+}
+
+/*
+
+Approximate number of ticks in a second. The first call takes about 20 ms to
+measure it.
+
+ */
+double instrumentation_ticks_per_second() {
+    pthread_once(&ticks_calibration_once, calibrate_ticks);
+    return ticks_per_second;
+}
+
+#ifdef ENABLE_INSTRUMENTATION
+
+typedef struct probe_thread_s {
+    probe_counters_t        counters[PROBES_NUMBER];
+    struct probe_thread_s  *previous;
+    struct probe_thread_s  *next;
+} probe_thread_t;
+
+__thread uint64_t probe_random_draws = 0;
+__thread probe_thread_t *probe_thread = NULL;
+
+pthread_mutex_t probes_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_once_t probes_key_once = PTHREAD_ONCE_INIT;
+pthread_key_t probes_key;
+
+// counters of running threads
+probe_thread_t *probe_threads = NULL;
+// counters of exited threads
+probe_counters_t retired_counters[PROBES_NUMBER];
+// totals at the time of the last reset_probes, they are subtracted from
+// snapshots
+probe_counters_t baseline_counters[PROBES_NUMBER];
+
+#define FOR_EACH_PROBE_COUNTER(_MACRO) \
+    _MACRO(calls) _MACRO(bytes) _MACRO(random_draws) _MACRO(ticks)
+
+void retire_probe_thread(void * const thread_void) {
+
+    probe_thread_t * const thread = thread_void;
+
+    pthread_mutex_lock(&probes_lock);
+
+    for (uint8_t probe = 0; probe < PROBES_NUMBER; probe++) {
+        #define RETIRE_COUNTER(_COUNTER)                                       \
+            retired_counters[probe]._COUNTER += thread->counters[probe]._COUNTER;
+        FOR_EACH_PROBE_COUNTER(RETIRE_COUNTER)
+        #undef RETIRE_COUNTER
+    }
+
+    if (thread->previous != NULL) thread->previous->next = thread->next;
+    else probe_threads = thread->next;
+    if (thread->next != NULL) thread->next->previous = thread->previous;
+
+    pthread_mutex_unlock(&probes_lock);
+
+    free(thread);
+
+}
+
+void create_probes_key() {
+    pthread_key_create(&probes_key, retire_probe_thread);
+}
+
+probe_thread_t * register_probe_thread() {
+
+    pthread_once(&probes_key_once, create_probes_key);
+
+    probe_thread_t * const thread = calloc(1, sizeof(probe_thread_t));
+    if (thread == NULL) return NULL;
+
+    pthread_mutex_lock(&probes_lock);
+    thread->next = probe_threads;
+    if (probe_threads != NULL) probe_threads->previous = thread;
+    probe_threads = thread;
+    pthread_mutex_unlock(&probes_lock);
+
+    // the destructor retires counters when the thread exits
+    pthread_setspecific(probes_key, thread);
+
+    return thread;
+
+}
+
+probe_scope_t open_probe_scope(const probe_id_t probe) {
+
+    return (probe_scope_t){
+        .probe = probe,
+        .started_ticks = read_probe_ticks(),
+        .started_draws = probe_random_draws,
+        .bytes = 0
+    };
+
+}
+
+/*
+
+Counters are read by snapshot_probes from other threads, so every counter is
+written at once. Only the owner thread writes them.
+
+ */
+void close_probe_scope(probe_scope_t * const scope) {
+
+    const uint64_t ticks = read_probe_ticks() - scope->started_ticks;
+
+    if (probe_thread == NULL) probe_thread = register_probe_thread();
+    if (probe_thread == NULL) return;
+
+    probe_counters_t * const counters = &probe_thread->counters[scope->probe];
+
+    __atomic_store_n(&counters->calls, counters->calls + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(
+        &counters->bytes, counters->bytes + scope->bytes, __ATOMIC_RELAXED);
+    __atomic_store_n(
+        &counters->random_draws,
+        counters->random_draws + probe_random_draws - scope->started_draws,
+        __ATOMIC_RELAXED);
+    __atomic_store_n(
+        &counters->ticks, counters->ticks + ticks, __ATOMIC_RELAXED);
+
+}
+
+/*
+
+Sum counters of all the threads, must be called under probes_lock.
+
+ */
+void sum_probe_counters(probe_counters_t * const totals) {
+
+    memcpy(totals, retired_counters, sizeof(retired_counters));
+
+    for (
+        const probe_thread_t *thread = probe_threads;
+        thread != NULL;
+        thread = thread->next
+    )
+        for (uint8_t probe = 0; probe < PROBES_NUMBER; probe++) {
+            #define ADD_COUNTER(_COUNTER)                                      \
+                totals[probe]._COUNTER += __atomic_load_n(                     \
+                    &thread->counters[probe]._COUNTER, __ATOMIC_RELAXED);
+            FOR_EACH_PROBE_COUNTER(ADD_COUNTER)
+            #undef ADD_COUNTER
+        }
+
+}
+
+#endif
+
+/*
+
+Write counters of every probe gathered since the last reset_probes into
+`counters` (get_probes_number() items).
+
+ */
+void snapshot_probes(probe_counters_t * const counters) {
+
+    #ifdef ENABLE_INSTRUMENTATION
+
+    pthread_mutex_lock(&probes_lock);
+
+    sum_probe_counters(counters);
+
+    for (uint8_t probe = 0; probe < PROBES_NUMBER; probe++) {
+        #define SUBTRACT_BASELINE(_COUNTER)                                    \
+            counters[probe]._COUNTER -= baseline_counters[probe]._COUNTER;
+        FOR_EACH_PROBE_COUNTER(SUBTRACT_BASELINE)
+        #undef SUBTRACT_BASELINE
+    }
+
+    pthread_mutex_unlock(&probes_lock);
+
+    #else
+
+    memset(counters, 0, sizeof(probe_counters_t) * PROBES_NUMBER);
+
+    #endif
+
+}
+
+/*
+
+Start counting from zero. Counters of the threads are not touched, current
+totals are remembered and subtracted from the next snapshots instead, so
+probes running at the same time are not disturbed.
+
+ */
+void reset_probes() {
+
+    #ifdef ENABLE_INSTRUMENTATION
+    pthread_mutex_lock(&probes_lock);
+    sum_probe_counters(baseline_counters);
+    pthread_mutex_unlock(&probes_lock);
+    #endif
+
+}
+
+#undef FOR_EACH_PROBE_COUNTER
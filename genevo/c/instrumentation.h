@@ -0,0 +1,132 @@
+/*
+
+This module contains counters and timers of hot functions of the library
+(probes). Every probe counts calls, bytes read or written by them, numbers
+drawn from random generators while they run, and time spent in them (in
+ticks, see instrumentation_ticks_per_second).
+
+Probes are compiled in only if ENABLE_INSTRUMENTATION is defined (build the
+library with `make INSTRUMENTATION=1`), otherwise all the macros below are
+empty and the C API returns zeros. Every thread writes into its own counters,
+so probes never wait for each other. Counters of finished threads are added
+to the common totals when the thread exits.
+
+Timers of nested probes include each other: time of machine_next_state is also
+counted by crossover_genomes calling it.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include <pthread.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <x86intrin.h>
+#endif
+
+/* @enum probe_id
+ * @type uint8
+ * @member PROBE_FILL_POOL               0
+ * @member PROBE_SAVE_POOL               1
+ * @member PROBE_READ_NEXT_GENOME        2
+ * @member PROBE_CROSSOVER_GENOMES       3
+ * @member PROBE_FLIP_BITS               4
+ * @member PROBE_CHANGE_GENES            5
+ * @member PROBE_MACHINE_NEXT_STATE      6
+ */
+typedef enum probe_id_e {
+    PROBE_FILL_POOL,
+    PROBE_SAVE_POOL,
+    PROBE_READ_NEXT_GENOME,
+    PROBE_CROSSOVER_GENOMES,
+    PROBE_FLIP_BITS,
+    PROBE_CHANGE_GENES,
+    PROBE_MACHINE_NEXT_STATE,
+    PROBES_NUMBER
+} probe_id_t;
+
+/* @typedef probe_counters_p
+ * @from_type probe_counters*
+ */
+/* @struct probe_counters
+ * @member uint64 calls
+ * @member uint64 bytes
+ * @member uint64 random_draws
+ * @member uint64 ticks
+ */
+typedef struct probe_counters_s {
+    uint64_t  calls;
+    uint64_t  bytes;
+    uint64_t  random_draws;
+    uint64_t  ticks;
+} probe_counters_t;
+
+#ifdef ENABLE_INSTRUMENTATION
+
+typedef struct probe_scope_s {
+    probe_id_t  probe;
+    uint64_t    started_ticks;
+    uint64_t    started_draws;
+    uint64_t    bytes;
+} probe_scope_t;
+
+// Numbers drawn by random generators in this thread
+extern __thread uint64_t probe_random_draws;
+
+probe_scope_t open_probe_scope(const probe_id_t);
+void close_probe_scope(probe_scope_t * const);
+
+// Measure the rest of the block, the probe is closed on any exit from it
+#define PROBE_SCOPE(_PROBE)                                                    \
+    probe_scope_t _probe_scope_ __attribute__((cleanup(close_probe_scope))) =  \
+        open_probe_scope(_PROBE)
+
+#define PROBE_BYTES(_BYTES) { _probe_scope_.bytes += (_BYTES); }
+
+#define PROBE_RANDOM_DRAW() { probe_random_draws++; }
+
+#else
+
+#define PROBE_SCOPE(_PROBE)
+#define PROBE_BYTES(_BYTES)
+#define PROBE_RANDOM_DRAW()
+
+#endif
+
+/* @function instrumentation_enabled
+ * @return uint8
+ */
+bool instrumentation_enabled();
+
+/* @function get_probes_number
+ * @return uint8
+ */
+uint8_t get_probes_number();
+
+/* @function get_probe_name
+ * @return char*
+ * @argument uint8
+ */
+const char * get_probe_name(const probe_id_t);
+
+/* @function snapshot_probes
+ * @return void
+ * @argument probe_counters*
+ */
+void snapshot_probes(probe_counters_t * const counters);
+
+/* @function reset_probes
+ * @return void
+ */
+void reset_probes();
+
+/* @function instrumentation_ticks_per_second
+ * @return double
+ */
+double instrumentation_ticks_per_second();
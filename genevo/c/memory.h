@@ -46,6 +46,8 @@
 
 #define RETURN_VOID_ON_ERR {return;}
 
+#define RETURN_ZERO_ON_ERR {return 0;}
+
 #define DO_NOTHING_ON_ERR ;
 
 #define FREE_NOT_NULL(_OBJECT)                                                 \
@@ -63,8 +63,9 @@ Its functions name was changed, so it can be used in genevo namespace.
 #include <stdio.h>
 
 #include "mersenne.h"
+#include "instrumentation.h"
 
-#define MERSENNE_NN 312
+#define MERSENNE_NN MERSENNE_STATE_SIZE
 #define MERSENNE_MM 156
 #define MERSENNE_MATRIX_A 0xB5026F5AA96619E9ULL
 #define MERSENNE_MATRIX_UM 0xFFFFFFFF80000000ULL /* Most significant 33 bits */
@@ -125,6 +126,8 @@ unsigned long long mersenne_genrand64_int64(void)
     unsigned long long x;
     static unsigned long long mag01[2]={0ULL, MERSENNE_MATRIX_A};
 
+    PROBE_RANDOM_DRAW();
+
     if (mti >= MERSENNE_NN) { /* generate MERSENNE_NN words at one time */
 
         /* if mersenne_init_genrand64() has not been called, */
@@ -180,6 +183,21 @@ double mersenne_genrand64_real3(void)
     return ((mersenne_genrand64_int64() >> 12) + 0.5) * (1.0/4503599627370496.0);
 }
 
+/* copies the state vector and its index into given buffers */
+void mersenne_get_state(unsigned long long *state, int *index)
+{
+    for (int i=0; i<MERSENNE_NN; i++) state[i] = mt[i];
+    *index = mti;
+}
+
+/* replaces the state vector and its index with given ones */
+void mersenne_set_state(const unsigned long long *state, const int index)
+{
+    mersenne_seed_initialized = true;
+    for (int i=0; i<MERSENNE_NN; i++) mt[i] = state[i];
+    mti = index;
+}
+
 #undef mt
 #undef mti
 
@@ -4,6 +4,9 @@
 #include <time.h>
 #include <stdlib.h>
 
+// Number of 64-bit words in the state vector of the generator.
+#define MERSENNE_STATE_SIZE 312
+
 void mersenne_init_genrand64(unsigned long long seed);
 
 /* generates a random number on [0, 2^64-1]-interval */
@@ -20,3 +23,9 @@ double mersenne_genrand64_real2(void);
 
 /* generates a random number on (0,1)-real-interval */
 double mersenne_genrand64_real3(void);
+
+/* copies the state vector and its index into given buffers */
+void mersenne_get_state(unsigned long long *state, int *index);
+
+/* replaces the state vector and its index with given ones */
+void mersenne_set_state(const unsigned long long *state, const int index);
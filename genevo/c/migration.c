@@ -0,0 +1,908 @@
+/*
+
+This module contains migration between islands.
+
+ */
+
+#include "migration.h"
+
+#define OUTBOX_SLOT_OFFSET(_ISLAND, _EPOCH)                                    \
+    (sizeof(migration_outbox_header_t) +                                       \
+     ((_EPOCH) % 2) *                                                          \
+     (sizeof(migration_slot_header_t) + (_ISLAND)->slot_byte_size))
+
+#define OUTBOX_BYTE_SIZE(_SLOT_BYTE_SIZE)                                      \
+    (sizeof(migration_outbox_header_t) +                                       \
+     2 * (sizeof(migration_slot_header_t) + (_SLOT_BYTE_SIZE)))
+
+void set_deadline(struct timespec * const deadline, const uint32_t timeout_ms) {
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000;
+    if (deadline->tv_nsec >= 1000000000) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000;
+    }
+}
+
+/*
+
+Set `left` to the time remaining until the deadline. Returns false if the
+deadline has passed.
+
+ */
+bool get_time_left(
+    const struct timespec * const deadline, struct timespec * const left
+) {
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    left->tv_sec = deadline->tv_sec - now.tv_sec;
+    left->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+    if (left->tv_nsec < 0) {
+        left->tv_sec--;
+        left->tv_nsec += 1000000000;
+    }
+
+    return left->tv_sec >= 0;
+
+}
+
+/*
+
+Block until the shared `word` equals `target`. Returns false on timeout.
+
+ */
+bool wait_for_word(
+    uint32_t * const word, const uint32_t target,
+    const struct timespec * const deadline
+) {
+
+    uint32_t value;
+
+    while ((value = __atomic_load_n(word, __ATOMIC_ACQUIRE)) != target) {
+
+        struct timespec left;
+        if (!get_time_left(deadline, &left)) return false;
+
+        #ifdef __linux__
+        syscall(SYS_futex, word, FUTEX_WAIT, value, &left, NULL, 0);
+        #else
+        const struct timespec poll_interval = {0, 1000000};
+        nanosleep(&poll_interval, NULL);
+        #endif
+
+    }
+
+    return true;
+
+}
+
+void wake_word(uint32_t * const word) {
+    #ifdef __linux__
+    syscall(SYS_futex, word, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+    #else
+    (void)word;
+    #endif
+}
+
+/*
+
+Return newly allocated `<address>.<index>`.
+
+ */
+char * alloc_island_address(const char *address, const uint16_t index) {
+
+    const int size = snprintf(NULL, 0, "%s.%u", address, index);
+    DECLARE_MALLOC_ARRAY(char, island_address, size + 1, RETURN_NULL_ON_ERR);
+    snprintf(island_address, size + 1, "%s.%u", address, index);
+
+    return island_address;
+
+}
+
+/*
+
+Create the outbox of the island and map outboxes of its sources, waiting
+until they're created by their islands.
+
+ */
+void open_island_outboxes(
+    island_t * const island, const struct timespec * const deadline
+) {
+
+    const size_t outbox_byte_size = OUTBOX_BYTE_SIZE(island->slot_byte_size);
+
+    char * const outbox_address =
+        alloc_island_address(island->address, island->index);
+    if (outbox_address == NULL) return;
+
+    // open_file maps one byte less than it writes into the stretched file
+    island->outbox =
+        open_file(outbox_address, OPEN_MODE_WRITE, outbox_byte_size - 1);
+    if (ERROR_LEVEL == ERR_OK) resize_file(island->outbox, outbox_byte_size);
+    free(outbox_address);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    migration_outbox_header_t * const header = island->outbox->data;
+    header->slot_byte_size = island->slot_byte_size;
+    __atomic_store_n(
+        &header->initial_byte, MIGRATION_OUTBOX_INITIAL_BYTE,
+        __ATOMIC_RELEASE);
+
+    for (uint16_t source_i = 0; source_i < island->sources_number; source_i++) {
+
+        char * const inbox_address =
+            alloc_island_address(island->address, island->sources[source_i]);
+        if (inbox_address == NULL) return;
+
+        struct timespec left;
+
+        while (true) {
+
+            file_map_t * const inbox =
+                open_file(inbox_address, OPEN_MODE_READ_WRITE, 0);
+
+            if (inbox != NULL) {
+                const migration_outbox_header_t * const inbox_header =
+                    inbox->data;
+                if (
+                    inbox->size == outbox_byte_size &&
+                    __atomic_load_n(
+                        &inbox_header->initial_byte, __ATOMIC_ACQUIRE) ==
+                        MIGRATION_OUTBOX_INITIAL_BYTE
+                ) {
+                    if (inbox_header->slot_byte_size != island->slot_byte_size) {
+                        close_file(inbox);
+                        free(inbox_address);
+                        ERROR_LEVEL = ERR_MIGRATION_INCOMPATIBLE;
+                        return;
+                    }
+                    island->inboxes[source_i] = inbox;
+                    break;
+                }
+                // the neighbor is still creating its outbox
+                close_file(inbox);
+            }
+
+            if (!get_time_left(deadline, &left)) {
+                free(inbox_address);
+                ERROR_LEVEL = ERR_MIGRATION_TIMEOUT;
+                return;
+            }
+
+            const struct timespec retry_interval = {0, 10000000};
+            nanosleep(&retry_interval, NULL);
+
+        }
+
+        free(inbox_address);
+
+    }
+
+    ERROR_LEVEL = ERR_OK;
+
+}
+
+/*
+
+Bind the socket of the island, connect to its destinations and accept
+connections of its sources. Every connection starts with the index of the
+connecting island.
+
+ */
+void open_island_sockets(
+    island_t * const island, const struct timespec * const deadline
+) {
+
+    struct sockaddr_un socket_address = { .sun_family = AF_UNIX };
+
+    #define SET_SOCKET_ADDRESS(_INDEX) {                                       \
+        char * const _PATH_ = alloc_island_address(island->address, (_INDEX)); \
+        if (_PATH_ == NULL) return;                                            \
+        if (strlen(_PATH_) >= sizeof(socket_address.sun_path)) {               \
+            free(_PATH_);                                                      \
+            ERROR_LEVEL = ERR_WRONG_PARAMS;                                    \
+            return; }                                                          \
+        strcpy(socket_address.sun_path, _PATH_);                               \
+        free(_PATH_); }
+
+    SET_SOCKET_ADDRESS(island->index);
+    unlink(socket_address.sun_path);
+
+    island->listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (
+        island->listener < 0 ||
+        bind(
+            island->listener, (struct sockaddr *)&socket_address,
+            sizeof(socket_address)) != 0 ||
+        listen(island->listener, island->sources_number + 1) != 0
+    ) {
+        ERROR_LEVEL = ERR_MIGRATION_CANNOT_CONNECT;
+        return;
+    }
+
+    for (
+        uint16_t destination_i = 0;
+        destination_i < island->destinations_number;
+        destination_i++
+    ) {
+
+        SET_SOCKET_ADDRESS(island->destinations[destination_i]);
+
+        struct timespec left;
+        int connection;
+
+        // the neighbor may not listen yet
+        while (true) {
+
+            connection = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (connection < 0) {
+                ERROR_LEVEL = ERR_MIGRATION_CANNOT_CONNECT;
+                return;
+            }
+
+            if (connect(
+                connection, (struct sockaddr *)&socket_address,
+                sizeof(socket_address)) == 0
+            )
+                break;
+
+            close(connection);
+
+            if (!get_time_left(deadline, &left)) {
+                ERROR_LEVEL = ERR_MIGRATION_TIMEOUT;
+                return;
+            }
+
+            const struct timespec retry_interval = {0, 10000000};
+            nanosleep(&retry_interval, NULL);
+
+        }
+
+        island->destination_sockets[destination_i] = connection;
+
+        if (
+            send(connection, &island->index, sizeof(uint16_t), MSG_NOSIGNAL) !=
+            sizeof(uint16_t)
+        ) {
+            ERROR_LEVEL = ERR_MIGRATION_CANNOT_CONNECT;
+            return;
+        }
+
+    }
+
+    #undef SET_SOCKET_ADDRESS
+
+    for (
+        uint16_t accepted = 0; accepted < island->sources_number; accepted++
+    ) {
+
+        struct timespec left;
+        if (!get_time_left(deadline, &left)) {
+            ERROR_LEVEL = ERR_MIGRATION_TIMEOUT;
+            return;
+        }
+
+        struct pollfd listener_poll = {
+            .fd = island->listener, .events = POLLIN };
+        if (poll(&listener_poll, 1, left.tv_sec * 1000 + left.tv_nsec / 1000000) <= 0) {
+            ERROR_LEVEL = ERR_MIGRATION_TIMEOUT;
+            return;
+        }
+
+        const int connection = accept(island->listener, NULL, NULL);
+        if (connection < 0) {
+            ERROR_LEVEL = ERR_MIGRATION_CANNOT_CONNECT;
+            return;
+        }
+
+        uint16_t source_index;
+        if (recv(connection, &source_index, sizeof(uint16_t), MSG_WAITALL) !=
+            sizeof(uint16_t)
+        ) {
+            close(connection);
+            ERROR_LEVEL = ERR_MIGRATION_CANNOT_CONNECT;
+            return;
+        }
+
+        uint16_t source_i = 0;
+        while (
+            source_i < island->sources_number &&
+            (island->sources[source_i] != source_index ||
+             island->source_sockets[source_i] >= 0)
+        )
+            source_i++;
+
+        if (source_i == island->sources_number) {
+            close(connection);
+            ERROR_LEVEL = ERR_MIGRATION_CANNOT_CONNECT;
+            return;
+        }
+
+        island->source_sockets[source_i] = connection;
+
+    }
+
+    ERROR_LEVEL = ERR_OK;
+
+}
+
+/*
+
+Create island `index` of `islands_number` islands. Shared memory transport
+expects a shared memory address (e.g. "shm:/run.migration"), while the socket
+transport expects a path for the sockets. `slot_byte_size` limits size of the
+migrants dump (0 means MIGRATION_DEFAULT_SLOT_SIZE), it is rounded up to the
+alignment of migration_slot_header_t. Blocks until the neighbors are created.
+
+ */
+island_t * create_island(
+    const char *address,
+    const uint16_t islands_number, const uint16_t index,
+    const migration_topology_t topology,
+    const migration_transport_t transport,
+    const uint32_t interval, const uint32_t migrants_number,
+    const uint64_t slot_byte_size
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (
+        index >= islands_number || interval == 0 ||
+        (uint64_t)migrants_number * sizeof(double) > UINT16_MAX ||
+        (topology != MIGRATION_RING && topology != MIGRATION_FULLY_CONNECTED) ||
+        (transport != MIGRATION_SHARED_MEMORY &&
+         transport != MIGRATION_UNIX_SOCKET)
+    ) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return NULL;
+    }
+
+    island_t * const island = calloc(1, sizeof(island_t));
+    if (island == NULL) RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+
+    island->islands_number = islands_number;
+    island->index = index;
+    island->topology = topology;
+    island->transport = transport;
+    island->interval = interval;
+    island->migrants_number = migrants_number;
+    // headers of both slots stay aligned, so futexes may wait on their words
+    const uint64_t slot_alignment = _Alignof(migration_slot_header_t);
+    island->slot_byte_size =
+        (slot_byte_size > 0 ? slot_byte_size : MIGRATION_DEFAULT_SLOT_SIZE) +
+        slot_alignment - 1;
+    island->slot_byte_size -= island->slot_byte_size % slot_alignment;
+    island->listener = -1;
+
+    const uint16_t neighbors_number =
+        islands_number < 2 ? 0
+        : topology == MIGRATION_RING ? 1
+        : islands_number - 1;
+
+    island->address = malloc(strlen(address) + 1);
+    island->destinations = malloc(sizeof(uint16_t) * (neighbors_number + 1));
+    island->sources = malloc(sizeof(uint16_t) * (neighbors_number + 1));
+    island->inboxes = calloc(neighbors_number + 1, sizeof(file_map_t *));
+    island->destination_sockets = malloc(sizeof(int) * (neighbors_number + 1));
+    island->source_sockets = malloc(sizeof(int) * (neighbors_number + 1));
+    island->source_buffers = calloc(neighbors_number + 1, sizeof(byte_t *));
+
+    if (
+        island->address == NULL || island->destinations == NULL ||
+        island->sources == NULL || island->inboxes == NULL ||
+        island->destination_sockets == NULL || island->source_sockets == NULL ||
+        island->source_buffers == NULL
+    ) {
+        close_island(island);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    strcpy(island->address, address);
+
+    for (uint16_t neighbor_i = 0; neighbor_i < neighbors_number; neighbor_i++) {
+        // in the ring the only neighbor is the next island, otherwise
+        // neighbors are all the islands but this one
+        const uint16_t offset = neighbor_i + 1;
+        island->destinations[neighbor_i] = (index + offset) % islands_number;
+        island->sources[neighbor_i] =
+            (index + islands_number - offset) % islands_number;
+        island->destination_sockets[neighbor_i] = -1;
+        island->source_sockets[neighbor_i] = -1;
+    }
+    island->destinations_number = neighbors_number;
+    island->sources_number = neighbors_number;
+
+    struct timespec deadline;
+    set_deadline(&deadline, MIGRATION_TIMEOUT_MS);
+
+    if (transport == MIGRATION_SHARED_MEMORY) {
+
+        open_island_outboxes(island, &deadline);
+
+    } else {
+
+        island->buffer = malloc(
+            sizeof(migration_frame_header_t) + island->slot_byte_size);
+        bool buffers_allocated = island->buffer != NULL;
+        for (uint16_t source_i = 0; source_i < neighbors_number; source_i++) {
+            island->source_buffers[source_i] = malloc(island->slot_byte_size);
+            buffers_allocated &= island->source_buffers[source_i] != NULL;
+        }
+
+        if (!buffers_allocated) {
+            close_island(island);
+            RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+        }
+
+        open_island_sockets(island, &deadline);
+
+    }
+
+    if (ERROR_LEVEL != ERR_OK) {
+        const err_status_t status = ERROR_LEVEL;
+        close_island(island);
+        ERROR_LEVEL = status;
+        return NULL;
+    }
+
+    return island;
+
+}
+
+/*
+
+Copy migrants from the dump into the least fit organisms listed in `ranking`
+(fittest first) starting from `*replaced` counted from its end. No more than `replaceable` organisms are replaced.
+
+ */
+void absorb_migrants(
+    void * const dump, const size_t dump_byte_size,
+    const pool_t * const pool, genome_t * const * const genomes,
+    double * const fitness, const ranked_genome_t * const ranking,
+    pool_organisms_num_t * const replaced,
+    const pool_organisms_num_t replaceable
+) {
+
+    pool_t * const migrants = read_pool_from_memory(dump, dump_byte_size);
+    if (ERROR_LEVEL != ERR_OK) {
+        ERROR_LEVEL = ERR_MIGRATION_CORRUPT;
+        return;
+    }
+
+    if (
+        migrants->metadata_byte_size !=
+            migrants->organisms_number * sizeof(double) ||
+        (size_t)((byte_t *)migrants->first_genome_start_position -
+                 (byte_t *)dump) > dump_byte_size
+    ) {
+        close_pool(migrants);
+        ERROR_LEVEL = ERR_MIGRATION_CORRUPT;
+        return;
+    }
+
+    if (migrants->gene_bytes_size != pool->gene_bytes_size) {
+        close_pool(migrants);
+        ERROR_LEVEL = ERR_MIGRATION_INCOMPATIBLE;
+        return;
+    }
+
+    for (
+        pool_organisms_num_t migrant_i = 0;
+        migrant_i < migrants->organisms_number && *replaced < replaceable;
+        migrant_i++
+    ) {
+
+        genome_t * const migrant = read_next_genome(migrants);
+        if (ERROR_LEVEL != ERR_OK) {
+            close_pool(migrants);
+            ERROR_LEVEL = ERR_MIGRATION_CORRUPT;
+            return;
+        }
+
+        const pool_organisms_num_t target_index =
+            ranking[pool->organisms_number - 1 - *replaced].index;
+        genome_t * const target = genomes[target_index];
+
+        if (
+            migrant->length != target->length ||
+            migrant->residue_size_bits != target->residue_size_bits
+        ) {
+            free(migrant);
+            close_pool(migrants);
+            ERROR_LEVEL = ERR_MIGRATION_INCOMPATIBLE;
+            return;
+        }
+
+        memcpy(
+            target->genes, migrant->genes,
+            (size_t)migrant->length * pool->gene_bytes_size);
+        memcpy(
+            target->residue, migrant->residue,
+            BITS_TO_BYTES(migrant->residue_size_bits));
+        target->flags |= GENOME_DIRTY;
+
+        memcpy(
+            &fitness[target_index], migrants->metadata + migrant_i * sizeof(double),
+            sizeof(double));
+
+        free(migrant);
+        (*replaced)++;
+
+    }
+
+    close_pool(migrants);
+    ERROR_LEVEL = ERR_OK;
+
+}
+
+/*
+
+Send the dump over the sockets and receive dumps of all the sources.
+
+ */
+void exchange_over_sockets(
+    island_t * const island, const uint32_t epoch, const size_t dump_byte_size,
+    const pool_t * const pool, genome_t * const * const genomes,
+    double * const fitness, const ranked_genome_t * const ranking,
+    pool_organisms_num_t * const replaced,
+    const pool_organisms_num_t replaceable,
+    const struct timespec * const deadline
+) {
+
+    const uint16_t destinations_number = island->destinations_number,
+                   sources_number = island->sources_number;
+
+    migration_frame_header_t * const frame = (void *)island->buffer;
+    frame->epoch = epoch;
+    frame->byte_size = dump_byte_size;
+    const size_t frame_byte_size =
+        sizeof(migration_frame_header_t) + dump_byte_size;
+
+    size_t * const sent = calloc(destinations_number + 1, sizeof(size_t));
+    size_t * const received = calloc(sources_number + 1, sizeof(size_t));
+    migration_frame_header_t * const headers =
+        calloc(sources_number + 1, sizeof(migration_frame_header_t));
+    struct pollfd * const polls = calloc(
+        destinations_number + sources_number + 1, sizeof(struct pollfd));
+
+    #define EXCHANGE_FAIL(_ERR) {                                              \
+        const err_status_t _STATUS_ = (_ERR);                                  \
+        FREE_NOT_NULL(sent); FREE_NOT_NULL(received);                          \
+        FREE_NOT_NULL(headers); FREE_NOT_NULL(polls);                          \
+        ERROR_LEVEL = _STATUS_;                                                \
+        return; }
+
+    if (sent == NULL || received == NULL || headers == NULL || polls == NULL)
+        EXCHANGE_FAIL(ERR_CANNOT_MALLOC);
+
+    while (true) {
+
+        nfds_t polls_number = 0;
+
+        for (uint16_t destination_i = 0; destination_i < destinations_number; destination_i++)
+            if (sent[destination_i] < frame_byte_size)
+                polls[polls_number++] = (struct pollfd){
+                    .fd = island->destination_sockets[destination_i],
+                    .events = POLLOUT };
+
+        for (uint16_t source_i = 0; source_i < sources_number; source_i++)
+            if (
+                received[source_i] < sizeof(migration_frame_header_t) ||
+                received[source_i] <
+                    sizeof(migration_frame_header_t) + headers[source_i].byte_size
+            )
+                polls[polls_number++] = (struct pollfd){
+                    .fd = island->source_sockets[source_i],
+                    .events = POLLIN };
+
+        if (polls_number == 0) break;
+
+        struct timespec left;
+        if (
+            !get_time_left(deadline, &left) ||
+            poll(polls, polls_number,
+                 left.tv_sec * 1000 + left.tv_nsec / 1000000) <= 0
+        )
+            EXCHANGE_FAIL(ERR_MIGRATION_TIMEOUT);
+
+        for (uint16_t destination_i = 0; destination_i < destinations_number; destination_i++) {
+
+            if (sent[destination_i] == frame_byte_size) continue;
+
+            const ssize_t written = send(
+                island->destination_sockets[destination_i],
+                island->buffer + sent[destination_i],
+                frame_byte_size - sent[destination_i],
+                MSG_NOSIGNAL | MSG_DONTWAIT);
+
+            if (written > 0) sent[destination_i] += written;
+            else if (written < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+                EXCHANGE_FAIL(ERR_MIGRATION_CANNOT_CONNECT);
+
+        }
+
+        for (uint16_t source_i = 0; source_i < sources_number; source_i++) {
+
+            const int connection = island->source_sockets[source_i];
+            const bool has_header =
+                received[source_i] >= sizeof(migration_frame_header_t);
+
+            if (
+                has_header &&
+                received[source_i] ==
+                    sizeof(migration_frame_header_t) + headers[source_i].byte_size
+            )
+                continue;
+
+            // header and body are read separately, so the next frame of a
+            // neighbor which is ahead stays in the socket
+            const ssize_t read_bytes = has_header
+                ? recv(
+                    connection,
+                    island->source_buffers[source_i] +
+                        received[source_i] - sizeof(migration_frame_header_t),
+                    sizeof(migration_frame_header_t) +
+                        headers[source_i].byte_size - received[source_i],
+                    MSG_DONTWAIT)
+                : recv(
+                    connection,
+                    (byte_t *)&headers[source_i] + received[source_i],
+                    sizeof(migration_frame_header_t) - received[source_i],
+                    MSG_DONTWAIT);
+
+            if (read_bytes == 0) EXCHANGE_FAIL(ERR_MIGRATION_CANNOT_CONNECT);
+            if (read_bytes < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK) continue;
+                EXCHANGE_FAIL(ERR_MIGRATION_CANNOT_CONNECT);
+            }
+
+            received[source_i] += read_bytes;
+
+            if (
+                !has_header &&
+                received[source_i] == sizeof(migration_frame_header_t) &&
+                (headers[source_i].epoch != epoch ||
+                 headers[source_i].byte_size > island->slot_byte_size)
+            )
+                EXCHANGE_FAIL(ERR_MIGRATION_CORRUPT);
+
+        }
+
+    }
+
+    for (uint16_t source_i = 0; source_i < sources_number; source_i++) {
+        absorb_migrants(
+            island->source_buffers[source_i], headers[source_i].byte_size,
+            pool, genomes, fitness, ranking, replaced, replaceable);
+        if (ERROR_LEVEL != ERR_OK) EXCHANGE_FAIL(ERROR_LEVEL);
+    }
+
+    EXCHANGE_FAIL(ERR_OK);
+
+    #undef EXCHANGE_FAIL
+
+}
+
+/*
+
+Exchange migrants with the neighbors if `generation` is a multiple of the
+migration interval. The fittest organisms (by `fitness`, greater is better) are
+sent, and the least fit ones are replaced with the received migrants. Their
+genes and residue are copied in place, so genomes should have the same length
+on all the islands. Fitness of the replaced organisms is set to the fitness of
+their migrants and they're marked with GENOME_DIRTY.
+
+ */
+void migrate(
+    island_t * const island, const uint64_t generation,
+    const pool_t * const pool, genome_t * const * const genomes,
+    double * const fitness
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (generation % island->interval != 0 || island->sources_number == 0)
+        return;
+
+    const uint32_t epoch = generation / island->interval + 1;
+    const pool_organisms_num_t organisms_number = pool->organisms_number;
+    const pool_organisms_num_t migrants_number =
+        island->migrants_number < organisms_number
+            ? island->migrants_number : organisms_number;
+
+    ranked_genome_t * const ranking =
+        malloc(sizeof(ranked_genome_t) * organisms_number);
+    if (ranking == NULL && organisms_number > 0)
+        RAISE_MALLOC_ERR(RETURN_VOID_ON_ERR);
+
+    for (
+        pool_organisms_num_t organism_i = 0;
+        organism_i < organisms_number;
+        organism_i++
+    )
+        ranking[organism_i] = (ranked_genome_t){
+            .fitness = fitness[organism_i], .index = organism_i };
+
+    qsort(
+        ranking, organisms_number, sizeof(ranked_genome_t),
+        compare_ranked_genomes);
+
+    genome_t ** const emigrants =
+        malloc(sizeof(genome_t *) * (migrants_number + 1));
+    double * const emigrants_fitness =
+        malloc(sizeof(double) * (migrants_number + 1));
+
+    #define MIGRATE_FAIL(_ERR) {                                               \
+        const err_status_t _STATUS_ = (_ERR);                                  \
+        free(ranking);                                                         \
+        FREE_NOT_NULL(emigrants); FREE_NOT_NULL(emigrants_fitness);            \
+        ERROR_LEVEL = _STATUS_;                                                \
+        return; }
+
+    if (emigrants == NULL || emigrants_fitness == NULL)
+        MIGRATE_FAIL(ERR_CANNOT_MALLOC);
+
+    // the fittest organisms go first
+    for (
+        pool_organisms_num_t migrant_i = 0;
+        migrant_i < migrants_number;
+        migrant_i++
+    ) {
+        const ranked_genome_t * const rank = &ranking[migrant_i];
+        emigrants[migrant_i] = genomes[rank->index];
+        emigrants_fitness[migrant_i] = rank->fitness;
+    }
+
+    // dump of the migrants is a pool whose metadata is their fitness
+    pool_t emigrants_pool = *pool;
+    emigrants_pool.organisms_number = migrants_number;
+    emigrants_pool.metadata = (byte_t *)emigrants_fitness;
+    emigrants_pool.metadata_byte_size = migrants_number * sizeof(double);
+    emigrants_pool.file_mapping = NULL;
+    emigrants_pool.dirty_ranges = NULL;
+    emigrants_pool.checksums = NULL;
+
+    const size_t dump_byte_size = get_pool_file_size(&emigrants_pool, emigrants);
+    if (dump_byte_size > island->slot_byte_size)
+        MIGRATE_FAIL(ERR_MIGRATION_TOO_LARGE);
+
+    const save_pool_flag_t dump_flags =
+        POOL_COPY_DATA | POOL_COPY_METADATA | POOL_REWRITE_DESCRIPTION;
+
+    // the fittest organisms of this island are never replaced
+    const pool_organisms_num_t replaceable = organisms_number - migrants_number;
+    pool_organisms_num_t replaced = 0;
+
+    struct timespec deadline;
+    set_deadline(&deadline, MIGRATION_TIMEOUT_MS);
+
+    if (island->transport == MIGRATION_SHARED_MEMORY) {
+
+        const size_t slot_offset = OUTBOX_SLOT_OFFSET(island, epoch);
+        migration_slot_header_t * const slot =
+            (void *)((byte_t *)island->outbox->data + slot_offset);
+
+        // the slot is reused when all the neighbors have read the migration
+        // before the previous one
+        if (
+            __atomic_load_n(&slot->epoch, __ATOMIC_ACQUIRE) != 0 &&
+            !wait_for_word(&slot->reads, island->destinations_number, &deadline)
+        )
+            MIGRATE_FAIL(ERR_MIGRATION_TIMEOUT);
+
+        save_pool_to_memory(&emigrants_pool, emigrants, dump_flags, slot + 1);
+        if (ERROR_LEVEL != ERR_OK) MIGRATE_FAIL(ERROR_LEVEL);
+
+        slot->byte_size = dump_byte_size;
+        __atomic_store_n(&slot->reads, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&slot->epoch, epoch, __ATOMIC_RELEASE);
+        wake_word(&slot->epoch);
+
+        for (uint16_t source_i = 0; source_i < island->sources_number; source_i++) {
+
+            migration_slot_header_t * const inbox_slot = (void *)(
+                (byte_t *)island->inboxes[source_i]->data + slot_offset);
+
+            if (!wait_for_word(&inbox_slot->epoch, epoch, &deadline))
+                MIGRATE_FAIL(ERR_MIGRATION_TIMEOUT);
+
+            if (inbox_slot->byte_size > island->slot_byte_size)
+                MIGRATE_FAIL(ERR_MIGRATION_CORRUPT);
+
+            absorb_migrants(
+                inbox_slot + 1, inbox_slot->byte_size,
+                pool, genomes, fitness, ranking, &replaced, replaceable);
+            if (ERROR_LEVEL != ERR_OK) MIGRATE_FAIL(ERROR_LEVEL);
+
+            __atomic_add_fetch(&inbox_slot->reads, 1, __ATOMIC_RELEASE);
+            wake_word(&inbox_slot->reads);
+
+        }
+
+    } else {
+
+        save_pool_to_memory(
+            &emigrants_pool, emigrants, dump_flags,
+            island->buffer + sizeof(migration_frame_header_t));
+        if (ERROR_LEVEL != ERR_OK) MIGRATE_FAIL(ERROR_LEVEL);
+
+        exchange_over_sockets(
+            island, epoch, dump_byte_size, pool, genomes, fitness, ranking,
+            &replaced, replaceable, &deadline);
+        if (ERROR_LEVEL != ERR_OK) MIGRATE_FAIL(ERROR_LEVEL);
+
+    }
+
+    MIGRATE_FAIL(ERR_OK);
+
+    #undef MIGRATE_FAIL
+
+}
+
+/*
+
+Close connections and mappings of the island and remove its own outbox or
+socket. Outbox is kept until the neighbors have read the last migrations from
+it (or MIGRATION_TIMEOUT_MS passes), so islands which are still catching up
+can open it.
+
+ */
+void close_island(island_t * const island) {
+
+    if (island->outbox != NULL) {
+
+        struct timespec deadline;
+        set_deadline(&deadline, MIGRATION_TIMEOUT_MS);
+
+        for (uint32_t slot_i = 0; slot_i < 2; slot_i++) {
+            migration_slot_header_t * const slot = (void *)(
+                (byte_t *)island->outbox->data +
+                OUTBOX_SLOT_OFFSET(island, slot_i));
+            if (__atomic_load_n(&slot->epoch, __ATOMIC_ACQUIRE) != 0)
+                wait_for_word(
+                    &slot->reads, island->destinations_number, &deadline);
+        }
+
+    }
+
+    char * const own_address = island->address != NULL
+        ? alloc_island_address(island->address, island->index)
+        : NULL;
+
+    for (uint16_t neighbor_i = 0; neighbor_i < island->sources_number; neighbor_i++) {
+        if (island->inboxes[neighbor_i] != NULL)
+            close_file(island->inboxes[neighbor_i]);
+        if (island->source_sockets[neighbor_i] >= 0)
+            close(island->source_sockets[neighbor_i]);
+        FREE_NOT_NULL(island->source_buffers[neighbor_i]);
+    }
+
+    for (uint16_t neighbor_i = 0; neighbor_i < island->destinations_number; neighbor_i++)
+        if (island->destination_sockets[neighbor_i] >= 0)
+            close(island->destination_sockets[neighbor_i]);
+
+    if (island->outbox != NULL) {
+        close_file(island->outbox);
+        if (own_address != NULL) remove_file(own_address);
+    }
+
+    if (island->listener >= 0) {
+        close(island->listener);
+        if (own_address != NULL) unlink(own_address);
+    }
+
+    FREE_NOT_NULL(own_address);
+    FREE_NOT_NULL(island->address);
+    FREE_NOT_NULL(island->destinations);
+    FREE_NOT_NULL(island->sources);
+    FREE_NOT_NULL(island->inboxes);
+    FREE_NOT_NULL(island->destination_sockets);
+    FREE_NOT_NULL(island->source_sockets);
+    FREE_NOT_NULL(island->source_buffers);
+    FREE_NOT_NULL(island->buffer);
+    free(island);
+
+}
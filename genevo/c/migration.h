@@ -0,0 +1,194 @@
+/*
+
+This module contains migration of organisms between islands: sub-populations
+evolving in separate processes of the same machine. Every `interval`
+generations each island sends its `migrants_number` fittest organisms to its
+neighbors and replaces its least fit organisms with the received ones.
+
+Migrants are sent as a pool dump (pickler.h) whose metadata holds their
+fitness values, so nothing passes through Python. Two transports are
+available:
+
+    * MIGRATION_SHARED_MEMORY: every island owns an outbox in shared memory
+      (files.h) with two slots used on alternate migrations. The receivers
+      copy migrants straight out of the slot and acknowledge it, so the sender
+      reuses the slot only after all the neighbors have read it.
+    * MIGRATION_UNIX_SOCKET: islands are connected with local stream sockets
+      and send migrants as frames. Sending and receiving are interleaved, so
+      islands never block each other on full socket buffers.
+
+Islands wait for each other during migration, so all of them should call
+migrate with the same sequence of generations. Shared memory outboxes and
+sockets are created at `<address>.<island index>`, so stale ones left by a
+crashed run should be removed with remove_file before the next run.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#ifdef __linux__
+#   include <linux/futex.h>
+#   include <sys/syscall.h>
+#endif
+
+#include "pool.h"
+#include "error.h"
+#include "files.h"
+#include "types.h"
+#include "memory.h"
+#include "pickler.h"
+#include "batch.h"
+
+#define MIGRATION_OUTBOX_INITIAL_BYTE  (file_control_byte_t)0x90
+
+#ifndef MIGRATION_DEFAULT_SLOT_SIZE
+#   define MIGRATION_DEFAULT_SLOT_SIZE (4 << 20)
+#endif
+
+// How long an island waits for its neighbors before ERR_MIGRATION_TIMEOUT
+#ifndef MIGRATION_TIMEOUT_MS
+#   define MIGRATION_TIMEOUT_MS 60000
+#endif
+
+/* @enum migration_topology
+ * @type uint8
+ * @member MIGRATION_RING            (1 << 0)
+ * @member MIGRATION_FULLY_CONNECTED (1 << 1)
+ */
+// MIGRATION_RING sends migrants to the next island only, while
+// MIGRATION_FULLY_CONNECTED sends them to every other island.
+typedef enum migration_topology_e {
+    MIGRATION_RING            = (uint8_t)(1 << 0),
+    MIGRATION_FULLY_CONNECTED = (uint8_t)(1 << 1)
+} migration_topology_t;
+
+/* @enum migration_transport
+ * @type uint8
+ * @member MIGRATION_SHARED_MEMORY (1 << 0)
+ * @member MIGRATION_UNIX_SOCKET   (1 << 1)
+ */
+typedef enum migration_transport_e {
+    MIGRATION_SHARED_MEMORY = (uint8_t)(1 << 0),
+    MIGRATION_UNIX_SOCKET   = (uint8_t)(1 << 1)
+} migration_transport_t;
+
+/*
+
+Outbox in shared memory is:
+
+migration_outbox_header_t
+[slot 0]                              slot_byte_size bytes
+[slot 1]                              slot_byte_size bytes
+
+Every slot starts with migration_slot_header_t followed by the migrants dump.
+These are live structures, so host byte order is used.
+
+ */
+
+typedef struct migration_outbox_header_s {
+    // set when the outbox is ready to be opened by neighbors
+    file_control_byte_t  initial_byte;
+    uint64_t             slot_byte_size;
+} migration_outbox_header_t;
+
+typedef struct migration_slot_header_s {
+    // number of the migration written into the slot, 0 if none
+    uint32_t             epoch;
+    // number of neighbors which have read the slot
+    uint32_t             reads;
+    uint64_t             byte_size;
+} migration_slot_header_t;
+
+typedef struct migration_frame_header_s {
+    uint32_t             epoch;
+    uint64_t             byte_size;
+} __attribute__((packed, aligned(1))) migration_frame_header_t;
+
+/* @typedef island_p
+ * @from_type island*
+ */
+/* @struct island
+ * @member uint16 islands_number
+ * @member uint16 index
+ * @member migration_topology topology
+ * @member migration_transport transport
+ * @member uint32 interval
+ * @member uint32 migrants_number
+ * @member uint64 slot_byte_size
+ */
+typedef struct island_s {
+    uint16_t                islands_number;
+    uint16_t                index;
+    migration_topology_t    topology;
+    migration_transport_t   transport;
+    uint32_t                interval;
+    uint32_t                migrants_number;
+    // largest size of migrants dump
+    uint64_t                slot_byte_size;
+    char                   *address;
+    // islands receiving migrants from this one
+    uint16_t                destinations_number;
+    uint16_t               *destinations;
+    // islands sending migrants to this one
+    uint16_t                sources_number;
+    uint16_t               *sources;
+    // MIGRATION_SHARED_MEMORY
+    file_map_t             *outbox;
+    file_map_t            **inboxes;
+    // MIGRATION_UNIX_SOCKET
+    int                     listener;
+    int                    *destination_sockets;
+    int                    *source_sockets;
+    // migrants dump being sent and dumps being received
+    byte_t                 *buffer;
+    byte_t                **source_buffers;
+} island_t;
+
+/* @function create_island
+ * @return island*
+ * @argument char*
+ * @argument uint16
+ * @argument uint16
+ * @argument migration_topology
+ * @argument migration_transport
+ * @argument uint32
+ * @argument uint32
+ * @argument uint64
+ */
+island_t * create_island(
+    const char *address,
+    const uint16_t islands_number, const uint16_t index,
+    const migration_topology_t, const migration_transport_t,
+    const uint32_t interval, const uint32_t migrants_number,
+    const uint64_t slot_byte_size);
+
+/* @function migrate
+ * @return void
+ * @argument island*
+ * @argument uint64
+ * @argument pool*
+ * @argument genome**
+ * @argument double*
+ */
+void migrate(
+    island_t * const, const uint64_t generation,
+    const pool_t * const, genome_t * const * const genomes,
+    double * const fitness);
+
+/* @function close_island
+ * @return void
+ * @argument island*
+ */
+void close_island(island_t * const);
@@ -17,64 +17,92 @@ of trials from the equation:
 
 */
 #define TRIALS_TO_MAKE_PROBABILITY(_COLLECTION_SIZE, _PROBABILITY) \
-    LOG_ARBITRARY_BASE(1 - (1 / _COLLECTION_SIZE), -_PROBABILITY + 1)
+    LOG_ARBITRARY_BASE(1 - (1.0 / (_COLLECTION_SIZE)), -(_PROBABILITY) + 1)
+
+/*
+
+Every mutation below draws its numbers from `stream` if it's not NULL, so
+independent threads can breed children without sharing a generator. NULL means
+the shared generators chosen by MUTATIONS_RANDOMNESS_MODE.
+
+*/
+#if   MUTATIONS_RANDOMNESS_MODE == MUTATIONS_XORSHIFT_FOR_RANDOM64
+#   define SHARED_RANDOM64_IN_RANGE next_urandom64_in_range
+#elif MUTATIONS_RANDOMNESS_MODE == MUTATIONS_MERSENNE_FOR_RANDOM64
+#   define SHARED_RANDOM64_IN_RANGE next_mersenne_random64_in_range
+#endif
+
+#define RANDOM64_IN_RANGE(_STREAM, _A, _B)                                     \
+    ((_STREAM) != NULL                                                         \
+        ? next_stream_random64_in_range(_STREAM, _A, _B)                       \
+        : SHARED_RANDOM64_IN_RANGE(_A, _B))
+
+#define FAST_RANDOM(_STREAM)                                                   \
+    ((_STREAM) != NULL                                                         \
+        ? (uint32_t)(next_xorshift128p_stream(_STREAM) & LCG_RAND_MAX)         \
+        : next_fast_random())
 
 /*
 
 Flip every bit in given bytes sequention with probability `probability`.
 
 */
-void flip_bits_with_probability(
+static void flip_bits_from_stream(
     gene_byte_t * const bytes, uint64_t bytes_number,
-    mutation_probability_t probability
+    mutation_probability_t probability, xorshift128p_stream_t * const stream
 ) {
-    for (
-        uint64_t trial = 0;
-        trial < TRIALS_TO_MAKE_PROBABILITY(bytes_number * 8, probability);
-        trial++
-    ) {
-        #if   MUTATIONS_RANDOMNESS_MODE == MUTATIONS_XORSHIFT_FOR_RANDOM64
-        uint64_t position = next_urandom64_in_range(0, bytes_number * 8);
-        #elif MUTATIONS_RANDOMNESS_MODE == MUTATIONS_MERSENNE_FOR_RANDOM64
-        uint64_t position = next_mersenne_random64_in_range(0, bytes_number * 8);
-        #endif
+    PROBE_SCOPE(PROBE_FLIP_BITS);
+
+    const uint64_t trials =
+        TRIALS_TO_MAKE_PROBABILITY(bytes_number * 8, probability);
+    PROBE_BYTES(trials);
+
+    for (uint64_t trial = 0; trial < trials; trial++) {
+        uint64_t position = RANDOM64_IN_RANGE(stream, 0, bytes_number * 8);
         uint64_t byte     = position / 8;
         uint8_t  bit      = position % 8;
         ((uint8_t * const)bytes)[byte] ^= 1 << bit;
     }
 }
 
+void flip_bits_with_probability(
+    gene_byte_t * const bytes, uint64_t bytes_number,
+    mutation_probability_t probability
+) {
+    flip_bits_from_stream(bytes, bytes_number, probability, NULL);
+}
+
 void flip_bits_in_genome_with_probability(
-    const genome_t *genome, const pool_t *pool,
+    genome_t *genome, const pool_t *pool,
     mutation_probability_t probability
 ) {
+    genome->flags |= GENOME_DIRTY;
     flip_bits_with_probability(
         genome->genes,
         genome->length * pool->gene_bytes_size,
         probability);
 }
 
-void change_genes_with_probability(
+static void change_genes_from_stream(
     gene_byte_t * const genes,
     pool_gene_byte_size_t gene_byte_size, genome_length_t genes_number,
-    gene_mutation_mode_t mode, mutation_probability_t probability
+    gene_mutation_mode_t mode, mutation_probability_t probability,
+    xorshift128p_stream_t * const stream
 ) {
 
+    PROBE_SCOPE(PROBE_CHANGE_GENES);
+
     #ifndef SKIP_LCG_RND_SEED_CHECK
-        ENSURE_LCG_RND_SEED_IS_SET;
+        if (stream == NULL) ENSURE_LCG_RND_SEED_IS_SET;
     #endif
 
-    for (
-        genome_length_t trial = 0;
-        trial < TRIALS_TO_MAKE_PROBABILITY(genes_number, probability);
-        trial++
-    ) {
+    const genome_length_t trials =
+        TRIALS_TO_MAKE_PROBABILITY(genes_number, probability);
+    PROBE_BYTES((uint64_t)trials * gene_byte_size);
+
+    for (genome_length_t trial = 0; trial < trials; trial++) {
 
-        #if   MUTATIONS_RANDOMNESS_MODE == MUTATIONS_XORSHIFT_FOR_RANDOM64
-        uint64_t position = next_urandom64_in_range(0, genes_number);
-        #elif MUTATIONS_RANDOMNESS_MODE == MUTATIONS_MERSENNE_FOR_RANDOM64
-        uint64_t position = next_mersenne_random64_in_range(0, genes_number);
-        #endif
+        uint64_t position = RANDOM64_IN_RANGE(stream, 0, genes_number);
 
         // This variable used if mode == REPEAT_NEIGHBOR_GENES
         // If neighbor_gene is `-1`, then previous gene will be repeated.
@@ -83,14 +111,19 @@ void change_genes_with_probability(
 
         if (mode == COMBINE_GENES_MUTATION)
             // maps [0; 2^32-1] -> {0; 1} -> {0; 2}
-            mode = 1 << ((next_fast_random() % 1) * 2);
+            mode = 1 << ((FAST_RANDOM(stream) % 1) * 2);
 
         switch (mode) {
 
             case RANDOMIZE_GENES:
-                fill_bytes_with_randomness(
-                    genes + position * gene_byte_size,
-                    gene_byte_size);
+                if (stream != NULL)
+                    fill_with_stream_randomness(
+                        stream, genes + position * gene_byte_size,
+                        gene_byte_size, 0);
+                else
+                    fill_bytes_with_randomness(
+                        genes + position * gene_byte_size,
+                        gene_byte_size);
                 break;
 
             case REPEAT_NEIGHBOR_GENES:
@@ -101,7 +134,7 @@ void change_genes_with_probability(
                     neighbor_gene = -1;
                 else
                     // maps {0; 1} -> {-1; 1}
-                    neighbor_gene = ((uint8_t)next_fast_random() % 1) * 2 - 1;
+                    neighbor_gene = ((uint8_t)FAST_RANDOM(stream) % 1) * 2 - 1;
 
                 memcpy(
                     genes + position * gene_byte_size,
@@ -120,42 +153,118 @@ void change_genes_with_probability(
 
 }
 
+void change_genes_with_probability(
+    gene_byte_t * const genes,
+    pool_gene_byte_size_t gene_byte_size, genome_length_t genes_number,
+    gene_mutation_mode_t mode, mutation_probability_t probability
+) {
+    change_genes_from_stream(
+        genes, gene_byte_size, genes_number, mode, probability, NULL);
+}
+
 void change_genes_in_genome_with_probability(
-    const genome_t *genome, const pool_t *pool,
+    genome_t *genome, const pool_t *pool,
     gene_mutation_mode_t mode, mutation_probability_t probability
 ) {
+    genome->flags |= GENOME_DIRTY;
     change_genes_with_probability(
         genome->genes,
         pool->gene_bytes_size, genome->length,
         mode, probability);
 }
 
-void crossover_genomes(
-    const genome_t *child, const genome_t * const * const parents,
+/*
+
+Append gene `gene_i` taken from parent `parent` to the crossover record of the
+child. Consecutive genes taken from the same parent form a single segment.
+
+*/
+void record_crossover_gene(
+    child_lineage_t * const lineage,
+    const genome_length_t gene_i, const uint8_t parent
+) {
+
+    if (lineage->segments_number > 0) {
+        crossover_segment_t * const last =
+            &lineage->segments[lineage->segments_number - 1];
+        if (last->parent == parent && last->start + last->length == gene_i) {
+            last->length++;
+            return;
+        }
+    }
+
+    if (lineage->segments_number == lineage->segments_capacity) {
+        const uint32_t new_capacity =
+            lineage->segments_capacity ? lineage->segments_capacity * 2 : 16;
+        crossover_segment_t * const segments = realloc(
+            lineage->segments, sizeof(crossover_segment_t) * new_capacity);
+        if (segments == NULL) RAISE_MALLOC_ERR(RETURN_VOID_ON_ERR);
+        lineage->segments = segments;
+        lineage->segments_capacity = new_capacity;
+    }
+
+    lineage->segments[lineage->segments_number].start = gene_i;
+    lineage->segments[lineage->segments_number].length = 1;
+    lineage->segments[lineage->segments_number].parent = parent;
+    lineage->segments_number++;
+
+}
+
+/*
+
+Fill genes of the child by taking each next gene from one of the parents.
+Parent is switched by the `blender` state machine. If lineage is not NULL, the
+list of copied segments is written into it.
+
+*/
+static void crossover_genomes_from_stream(
+    genome_t *child, const genome_t * const * const parents,
     const pool_gene_byte_size_t gene_byte_size,
-    state_machine_t * const blender
+    state_machine_t * const blender,
+    child_lineage_t * const lineage,
+    xorshift128p_stream_t * const stream
 ) {
 
+    PROBE_SCOPE(PROBE_CROSSOVER_GENOMES);
+
+    child->flags |= GENOME_DIRTY;
+
+    if (lineage != NULL) lineage->segments_number = 0;
+
     gene_byte_t *writer_position = child->genes;
     for (genome_length_t gene_i = 0; gene_i < child->length; gene_i++) {
 
-        const genome_t *parent = parents[blender->current_state];
+        const uint8_t parent_i = blender->current_state;
+        const genome_t *parent = parents[parent_i];
 
         // TODO: prevent running out of genes to copy
-        if (parent->length < gene_i) break;
+        if (parent->length <= gene_i) break;
 
         memcpy(
             writer_position,
             parent->genes + gene_byte_size * gene_i,
             gene_byte_size);
+        PROBE_BYTES(gene_byte_size);
+
+        if (lineage != NULL) record_crossover_gene(lineage, gene_i, parent_i);
 
-        writer_position += gene_byte_size * gene_i;
-        machine_next_state(blender);
+        writer_position += gene_byte_size;
+        machine_next_state_from_stream(blender, stream);
 
     }
 
 }
 
+void crossover_genomes(
+    genome_t *child, const genome_t * const * const parents,
+    const pool_gene_byte_size_t gene_byte_size,
+    state_machine_t * const blender,
+    child_lineage_t * const lineage
+) {
+    crossover_genomes_from_stream(
+        child, parents, gene_byte_size, blender, lineage, NULL);
+}
+
 /*
 
 Simple brute-force O(n^2 - n) algorithm. It could be effective to use
@@ -168,22 +277,36 @@ bool combination_has_duplicates(
 ) {
 
     for (uint8_t genome_i = 0; genome_i < combination_length; genome_i++)
-        for (uint8_t genome_j = 0; genome_j < combination_length; genome_j++)
+        for (uint8_t genome_j = genome_i + 1; genome_j < combination_length; genome_j++)
             if (combination[genome_i] == combination[genome_j])
                 return true;
 
     return false;
 }
 
-void crossover_genomes_combinations(
+/*
+
+Produce every child by crossing over `combination_length` distinct parents.
+If `parents_indices` is given, it maps positions in `genomes_parents` to
+indices which are written into the lineage (used when parents were picked by
+bottleneck_population).
+
+*/
+void crossover_genomes_combinations_from_stream(
     pool_organisms_num_t parents_number, pool_organisms_num_t children_number,
     uint8_t combination_length, double blend_coefficient,
     const genome_t * const * const genomes_parents,
     genome_t * const * const genomes_children,
-    const pool_gene_byte_size_t gene_byte_size
+    const pool_gene_byte_size_t gene_byte_size,
+    const pool_organisms_num_t * const parents_indices,
+    generation_lineage_t * const lineage,
+    xorshift128p_stream_t * const stream
 ) {
 
-    if (blend_coefficient <= 0 || blend_coefficient >= 1) {
+    if (
+        blend_coefficient <= 0 || blend_coefficient >= 1 ||
+        combination_length < 2 || combination_length > parents_number
+    ) {
         ERROR_LEVEL = ERR_WRONG_PARAMS;
         return;
     }
@@ -195,7 +318,11 @@ void crossover_genomes_combinations(
         1 - blend_coefficient,
         blend_coefficient / (combination_length - 1));
 
-    init_state_machine(blender, next_fast_random_in_range(0, combination_length));
+    init_state_machine(
+        blender,
+        stream != NULL
+            ? next_stream_random64_in_range(stream, 0, combination_length)
+            : next_fast_random_in_range(0, combination_length));
     if (ERROR_LEVEL != ERR_OK) {
         destroy_state_machine(blender);
         return;
@@ -207,6 +334,7 @@ void crossover_genomes_combinations(
 
     DECLARE_MALLOC_LINKS_ARRAY(
         const genome_t, genomes_combination, combination_length,
+        free(combination);
         DESTROY_AND_EXIT(destroy_state_machine, blender, RETURN_VOID_ON_ERR));
 
     for (
@@ -216,32 +344,62 @@ void crossover_genomes_combinations(
     ) {
 
         do for (uint8_t i = 0; i < combination_length; i++) 
-            #if   MUTATIONS_RANDOMNESS_MODE == MUTATIONS_XORSHIFT_FOR_RANDOM64
-            combination[i] = next_urandom64_in_range(0, parents_number);
-            #elif MUTATIONS_RANDOMNESS_MODE == MUTATIONS_MERSENNE_FOR_RANDOM64
-            combination[i] = next_mersenne_random64_in_range(0, parents_number);
-            #endif
+            combination[i] = RANDOM64_IN_RANGE(stream, 0, parents_number);
         while (combination_has_duplicates(combination, combination_length));
 
         for (uint8_t i = 0; i < combination_length; i++)
             genomes_combination[i] = genomes_parents[combination[i]];
 
-        crossover_genomes(
+        child_lineage_t * const child_lineage =
+            lineage != NULL ? &lineage->children[combination_counter] : NULL;
+
+        if (child_lineage != NULL)
+            for (uint8_t i = 0; i < combination_length; i++)
+                child_lineage->parents[i] = parents_indices != NULL
+                    ? parents_indices[combination[i]]
+                    : combination[i];
+
+        crossover_genomes_from_stream(
             genomes_children[combination_counter], genomes_combination,
-            gene_byte_size, blender);
+            gene_byte_size, blender, child_lineage, stream);
 
     }
 
     FREE_NOT_NULL(combination);
+    FREE_NOT_NULL(genomes_combination);
 
     destroy_state_machine(blender);
 
 }
 
+void crossover_genomes_combinations(
+    pool_organisms_num_t parents_number, pool_organisms_num_t children_number,
+    uint8_t combination_length, double blend_coefficient,
+    const genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_gene_byte_size_t gene_byte_size,
+    const pool_organisms_num_t * const parents_indices,
+    generation_lineage_t * const lineage
+) {
+
+    crossover_genomes_combinations_from_stream(
+        parents_number, children_number, combination_length, blend_coefficient,
+        genomes_parents, genomes_children, gene_byte_size,
+        parents_indices, lineage, NULL);
+
+}
+
+/*
+
+Pick `dst_number` genomes from `src`. If `dst_indices` is not NULL, index of
+every picked genome is written into it.
+
+*/
 void bottleneck_population(
     pool_organisms_num_t src_number, pool_organisms_num_t dst_number,   
     const genome_t * const * const src,
-    const genome_t ** const dst
+    const genome_t ** const dst,
+    pool_organisms_num_t * const dst_indices
 ) {
 
     state_machine_t *picker = generate_state_machine(src_number);
@@ -255,8 +413,11 @@ void bottleneck_population(
     for (pool_organisms_num_t dst_i = 0; dst_i < dst_number; dst_i++) {
         pool_organisms_num_t src_i = picker->current_state;
         dst[dst_i] = src[src_i];
+        if (dst_indices != NULL) dst_indices[dst_i] = src_i;
         machine_next_state(picker);
     }
+
+    destroy_state_machine(picker);
 }
 
 void pairing_season(
@@ -270,36 +431,241 @@ void pairing_season(
     const pool_gene_byte_size_t gene_byte_size
 ) {
 
-    const genome_t ** bottleneck_source;
+    pairing_season_with_lineage(
+        parents_number, children_number,
+        replication_type, blend_coefficient,
+        change_genes_prob, mutation_mode, flip_bits_prob,
+        genomes_parents, genomes_children, gene_byte_size,
+        NULL /* lineage */);
 
-    if (parents_number != children_number)
-        bottleneck_population(
-            parents_number, children_number, genomes_parents, bottleneck_source);
+}
+
+/*
+
+Does the same as pairing_season. Besides, if lineage is not NULL, parents and
+crossover segments of every child are recorded into it, so the generation can
+be stored as a delta (see archive.h). Indices of parents in the lineage always
+refer to `genomes_parents`.
 
-    crossover_genomes_combinations(
+*/
+void pairing_season_with_lineage(
+    const pool_organisms_num_t parents_number,
+    const pool_organisms_num_t children_number,
+    const replication_type_t replication_type, const blend_coefficient_t blend_coefficient,
+    const mutation_probability_t change_genes_prob, const gene_mutation_mode_t mutation_mode,
+    const mutation_probability_t flip_bits_prob,
+    const genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_gene_byte_size_t gene_byte_size,
+    generation_lineage_t * const lineage
+) {
+
+    pairing_season_unique(
         parents_number, children_number,
         replication_type, blend_coefficient,
-        (parents_number == children_number)
-            ? genomes_parents : bottleneck_source,
-        genomes_children,
-        gene_byte_size);
+        change_genes_prob, mutation_mode, flip_bits_prob,
+        genomes_parents, genomes_children, gene_byte_size,
+        lineage, 0 /* redraws_number */);
 
-    for (
+}
+
+void mutate_child_from_stream(
+    genome_t * const child, const pool_gene_byte_size_t gene_byte_size,
+    const mutation_probability_t change_genes_prob,
+    const gene_mutation_mode_t mutation_mode,
+    const mutation_probability_t flip_bits_prob,
+    xorshift128p_stream_t * const stream
+) {
+
+    child->flags |= GENOME_DIRTY;
+
+    change_genes_from_stream(
+        child->genes, gene_byte_size, child->length,
+        mutation_mode, change_genes_prob, stream);
+
+    flip_bits_from_stream(
+        child->genes, gene_byte_size * child->length, flip_bits_prob, stream);
+
+}
+
+void mutate_child(
+    genome_t * const child, const pool_gene_byte_size_t gene_byte_size,
+    const mutation_probability_t change_genes_prob,
+    const gene_mutation_mode_t mutation_mode,
+    const mutation_probability_t flip_bits_prob
+) {
+
+    mutate_child_from_stream(
+        child, gene_byte_size,
+        change_genes_prob, mutation_mode, flip_bits_prob, NULL);
+
+}
+
+/*
+
+Does the same as pairing_season_with_lineage. Besides, every child identical
+to one of the previous children (see duplicates.h) is bred again from another
+combination of parents, at most `redraws_number` times. Children which are
+still duplicates after that are left as they are.
+
+*/
+void pairing_season_unique(
+    const pool_organisms_num_t parents_number,
+    const pool_organisms_num_t children_number,
+    const replication_type_t replication_type, const blend_coefficient_t blend_coefficient,
+    const mutation_probability_t change_genes_prob, const gene_mutation_mode_t mutation_mode,
+    const mutation_probability_t flip_bits_prob,
+    const genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_gene_byte_size_t gene_byte_size,
+    generation_lineage_t * const lineage,
+    const uint8_t redraws_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    const genome_t ** bottleneck_source = NULL;
+    pool_organisms_num_t * bottleneck_indices = NULL;
+
+    if (parents_number != children_number) {
+
+        bottleneck_source = malloc(sizeof(genome_t *) * children_number);
+        bottleneck_indices =
+            malloc(sizeof(pool_organisms_num_t) * children_number);
+
+        if (bottleneck_source == NULL || bottleneck_indices == NULL) {
+            FREE_NOT_NULL(bottleneck_source);
+            FREE_NOT_NULL(bottleneck_indices);
+            RAISE_MALLOC_ERR(RETURN_VOID_ON_ERR);
+        }
+
+        bottleneck_population(
+            parents_number, children_number, genomes_parents,
+            bottleneck_source, bottleneck_indices);
+
+    }
+
+    #define BREED_CHILDREN(_CHILDREN, _NUMBER, _LINEAGE)                       \
+        crossover_genomes_combinations(                                        \
+            (parents_number == children_number)                                \
+                ? parents_number : children_number,                            \
+            _NUMBER,                                                           \
+            replication_type, blend_coefficient,                               \
+            (parents_number == children_number)                                \
+                ? genomes_parents : bottleneck_source,                         \
+            _CHILDREN,                                                         \
+            gene_byte_size,                                                    \
+            bottleneck_indices, _LINEAGE);
+
+    BREED_CHILDREN(genomes_children, children_number, lineage);
+
+    if (ERROR_LEVEL == ERR_OK)
+        for (
+            pool_organisms_num_t genome_i = 0;
+            genome_i < children_number;
+            genome_i++
+        )
+            mutate_child(
+                genomes_children[genome_i], gene_byte_size,
+                change_genes_prob, mutation_mode, flip_bits_prob);
+
+    genome_hash_set_t * const children_set =
+        ERROR_LEVEL == ERR_OK && redraws_number > 0
+            ? create_genome_hash_set(children_number, gene_byte_size)
+            : NULL;
+
+    if (children_set != NULL) for (
         pool_organisms_num_t genome_i = 0;
         genome_i < children_number;
         genome_i++
     ) {
 
-        change_genes_with_probability(
-            genomes_children[genome_i]->genes,
-            gene_byte_size, genomes_children[genome_i]->length,
-            mutation_mode, change_genes_prob);
+        genome_t * const * const child = &genomes_children[genome_i];
+
+        // lineage of the single child being bred again
+        generation_lineage_t child_lineage = {
+            .children_number = 1,
+            .children = lineage != NULL ? &lineage->children[genome_i] : NULL
+        };
+
+        for (uint8_t redraw = 0;; redraw++) {
+
+            if (genome_hash_set_insert(
+                    children_set, *child,
+                    hash_genome(*child, gene_byte_size), genome_i) == NULL)
+                break;
+
+            if (redraw == redraws_number) break;
+
+            BREED_CHILDREN(child, 1, lineage != NULL ? &child_lineage : NULL);
+            if (ERROR_LEVEL != ERR_OK) break;
+
+            mutate_child(
+                *child, gene_byte_size,
+                change_genes_prob, mutation_mode, flip_bits_prob);
+
+        }
+
+        if (ERROR_LEVEL != ERR_OK) break;
+
+    }
+
+    #undef BREED_CHILDREN
+
+    if (children_set != NULL) destroy_genome_hash_set(children_set);
+
+    FREE_NOT_NULL(bottleneck_source);
+    FREE_NOT_NULL(bottleneck_indices);
+
+}
+
+/*
+
+Allocate lineage records for `children_number` children each having
+`parents_number` parents.
+
+*/
+generation_lineage_t * allocate_generation_lineage(
+    const pool_organisms_num_t children_number, const uint8_t parents_number
+) {
+
+    DECLARE_CONST_MALLOC_OBJECT(
+        generation_lineage_t, lineage, RETURN_NULL_ON_ERR);
+
+    lineage->children_number = children_number;
+    lineage->children = calloc(children_number, sizeof(child_lineage_t));
+    if (lineage->children == NULL) {
+        free(lineage);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    for (
+        pool_organisms_num_t child_i = 0; child_i < children_number; child_i++
+    ) {
+        child_lineage_t * const child = &lineage->children[child_i];
+        child->parents_number = parents_number;
+        child->parents = malloc(sizeof(pool_organisms_num_t) * parents_number);
+        if (child->parents == NULL)
+            DESTROY_AND_EXIT(
+                destroy_generation_lineage, lineage, RETURN_NULL_ON_ERR);
+    }
+
+    return lineage;
 
-        flip_bits_with_probability(
-            genomes_children[genome_i]->genes,
-            gene_byte_size * genomes_children[genome_i]->length,
-            flip_bits_prob);
+}
+
+void destroy_generation_lineage(generation_lineage_t * const lineage) {
 
+    for (
+        pool_organisms_num_t child_i = 0;
+        child_i < lineage->children_number;
+        child_i++
+    ) {
+        FREE_NOT_NULL(lineage->children[child_i].parents);
+        FREE_NOT_NULL(lineage->children[child_i].segments);
     }
 
+    free(lineage->children);
+    free(lineage);
+
 }
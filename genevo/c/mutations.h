@@ -8,6 +8,7 @@
 #include "pool.h"
 #include "rand.h"
 #include "state_machine.h"
+#include "duplicates.h"
 
 #define MUTATIONS_XORSHIFT_FOR_RANDOM64  0
 #define MUTATIONS_MERSENNE_FOR_RANDOM64  1
@@ -31,7 +32,7 @@ void flip_bits_with_probability(
  * @argument double
  */
 void flip_bits_in_genome_with_probability(
-    const genome_t *genome, const pool_t *pool, mutation_probability_t
+    genome_t *genome, const pool_t *pool, mutation_probability_t
 );
 
 /* @enum gene_mutation_mode
@@ -69,13 +70,111 @@ void change_genes_with_probability(
  * @argument double
  */
 void change_genes_in_genome_with_probability(
-    const genome_t *genome, const pool_t *pool,
+    genome_t *genome, const pool_t *pool,
     gene_mutation_mode_t mode, mutation_probability_t probability
 );
 
 typedef uint8_t replication_type_t;
 typedef double blend_coefficient_t;
 
+/* @struct crossover_segment
+ * @member uint32 start
+ * @member uint32 length
+ * @member uint8 parent
+ */
+// `length` genes starting from `start` were copied from the parent with index
+// `parent` in the list of parents of the child.
+typedef struct crossover_segment_s {
+    genome_length_t start;
+    genome_length_t length;
+    uint8_t         parent;
+} crossover_segment_t;
+
+/* @struct child_lineage
+ * @member uint8 parents_number
+ * @member uint64* parents
+ * @member uint32 segments_number
+ * @member uint32 segments_capacity
+ * @member crossover_segment* segments
+ */
+typedef struct child_lineage_s {
+    uint8_t               parents_number;
+    pool_organisms_num_t *parents;
+    uint32_t              segments_number;
+    uint32_t              segments_capacity;
+    crossover_segment_t  *segments;
+} child_lineage_t;
+
+/* @typedef generation_lineage_p
+ * @from_type generation_lineage*
+ */
+/* @struct generation_lineage
+ * @member uint64 children_number
+ * @member child_lineage* children
+ */
+typedef struct generation_lineage_s {
+    pool_organisms_num_t  children_number;
+    child_lineage_t      *children;
+} generation_lineage_t;
+
+/* @function allocate_generation_lineage
+ * @return generation_lineage*
+ * @argument uint64
+ * @argument uint8
+ */
+generation_lineage_t * allocate_generation_lineage(
+    const pool_organisms_num_t children_number, const uint8_t parents_number);
+
+/* @function destroy_generation_lineage
+ * @return void
+ * @argument generation_lineage*
+ */
+void destroy_generation_lineage(generation_lineage_t * const);
+
+void crossover_genomes(
+    genome_t *child, const genome_t * const * const parents,
+    const pool_gene_byte_size_t gene_byte_size,
+    state_machine_t * const blender,
+    child_lineage_t * const lineage
+);
+
+void crossover_genomes_combinations(
+    pool_organisms_num_t parents_number, pool_organisms_num_t children_number,
+    uint8_t combination_length, double blend_coefficient,
+    const genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_gene_byte_size_t gene_byte_size,
+    const pool_organisms_num_t * const parents_indices,
+    generation_lineage_t * const lineage
+);
+
+void mutate_child(
+    genome_t * const child, const pool_gene_byte_size_t,
+    const mutation_probability_t change_genes_prob, const gene_mutation_mode_t,
+    const mutation_probability_t flip_bits_prob
+);
+
+// Same as crossover_genomes_combinations and mutate_child, but every random
+// number is drawn from `stream`, so different threads can breed their own
+// children at once. NULL means the shared generators.
+void crossover_genomes_combinations_from_stream(
+    pool_organisms_num_t parents_number, pool_organisms_num_t children_number,
+    uint8_t combination_length, double blend_coefficient,
+    const genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_gene_byte_size_t gene_byte_size,
+    const pool_organisms_num_t * const parents_indices,
+    generation_lineage_t * const lineage,
+    xorshift128p_stream_t * const stream
+);
+
+void mutate_child_from_stream(
+    genome_t * const child, const pool_gene_byte_size_t,
+    const mutation_probability_t change_genes_prob, const gene_mutation_mode_t,
+    const mutation_probability_t flip_bits_prob,
+    xorshift128p_stream_t * const stream
+);
+
 /* @function pairing_season
  * @return void
  * @argument uint64_t
@@ -99,3 +198,57 @@ void pairing_season(
     genome_t * const * const genomes_children,
     const pool_gene_byte_size_t
 );
+
+/* @function pairing_season_with_lineage
+ * @return void
+ * @argument uint64
+ * @argument uint64
+ * @argument uint8
+ * @argument double
+ * @argument double
+ * @argument gene_mutation_mode
+ * @argument double
+ * @argument genome**
+ * @argument genome**
+ * @argument uint8
+ * @argument generation_lineage*
+ */
+void pairing_season_with_lineage(
+    const pool_organisms_num_t parents_number,
+    const pool_organisms_num_t children_number,
+    const replication_type_t, const blend_coefficient_t,
+    const mutation_probability_t change_genes_prob, const gene_mutation_mode_t,
+    const mutation_probability_t flip_bits_prob,
+    const genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_gene_byte_size_t,
+    generation_lineage_t * const lineage
+);
+
+/* @function pairing_season_unique
+ * @return void
+ * @argument uint64
+ * @argument uint64
+ * @argument uint8
+ * @argument double
+ * @argument double
+ * @argument gene_mutation_mode
+ * @argument double
+ * @argument genome**
+ * @argument genome**
+ * @argument uint8
+ * @argument generation_lineage*
+ * @argument uint8
+ */
+void pairing_season_unique(
+    const pool_organisms_num_t parents_number,
+    const pool_organisms_num_t children_number,
+    const replication_type_t, const blend_coefficient_t,
+    const mutation_probability_t change_genes_prob, const gene_mutation_mode_t,
+    const mutation_probability_t flip_bits_prob,
+    const genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_gene_byte_size_t,
+    generation_lineage_t * const lineage,
+    const uint8_t redraws_number
+);
@@ -0,0 +1,98 @@
+/*
+
+This module contains the fork-join helper.
+
+ */
+
+#include "parallel.h"
+
+typedef struct parallel_job_s {
+    parallel_body_t  body;
+    void            *context;
+    uint64_t         start;
+    uint64_t         end;
+    pthread_t        thread;
+    bool             spawned;
+    // ERROR_LEVEL of the worker thread after the body
+    err_status_t     status;
+    error_context_t  error_context;
+} parallel_job_t;
+
+void * parallel_worker(void *job_void) {
+    parallel_job_t * const job = job_void;
+    job->body(job->context, job->start, job->end);
+    job->status = ERROR_LEVEL;
+    get_error_context(&job->error_context);
+    return NULL;
+}
+
+/*
+
+Return `requested` or number of online processors if it is 0.
+
+ */
+uint16_t get_threads_number(const uint16_t requested) {
+
+    if (requested > 0) return requested;
+
+    const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    return processors > 0
+        ? (processors < UINT16_MAX ? processors : UINT16_MAX)
+        : 1;
+
+}
+
+/*
+
+Split `items_number` items into contiguous ranges and run `body` over each of
+them in its own thread (0 threads means number of online processors). The
+calling thread takes the last range itself and also runs ranges whose thread
+could not be spawned, so the loop always completes.
+
+Bodies may set ERROR_LEVEL in any thread. If the calling thread has no error
+after the loop, it takes the error of the first range whose worker met one.
+
+ */
+void parallel_for(
+    const uint64_t items_number, const uint16_t threads_number,
+    const parallel_body_t body, void * const context
+) {
+
+    uint64_t jobs_number = get_threads_number(threads_number);
+    if (jobs_number > items_number) jobs_number = items_number;
+    if (jobs_number == 0) return;
+
+    parallel_job_t * const jobs =
+        jobs_number > 1 ? malloc(sizeof(parallel_job_t) * jobs_number) : NULL;
+    if (jobs == NULL) {
+        body(context, 0, items_number);
+        return;
+    }
+
+    const uint64_t step = items_number / jobs_number;
+
+    for (uint64_t job_i = 0; job_i < jobs_number; job_i++) {
+
+        parallel_job_t * const job = &jobs[job_i];
+        job->body = body;
+        job->context = context;
+        job->start = step * job_i;
+        job->end =
+            job_i + 1 == jobs_number ? items_number : step * (job_i + 1);
+
+        job->spawned =
+            job_i + 1 < jobs_number &&
+            pthread_create(&job->thread, NULL, parallel_worker, job) == 0;
+        if (!job->spawned) body(context, job->start, job->end);
+
+    }
+
+    for (uint64_t job_i = 0; job_i < jobs_number; job_i++)
+        if (jobs[job_i].spawned) {
+            pthread_join(jobs[job_i].thread, NULL);
+            propagate_error(jobs[job_i].status, &jobs[job_i].error_context);
+        }
+
+    free(jobs);
+
+}
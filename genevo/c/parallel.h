@@ -0,0 +1,31 @@
+/*
+
+This module contains a minimal fork-join helper used to split loops over
+organisms between threads.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "error.h"
+
+/*
+
+Body of the loop. It handles items in range [start, end).
+
+ */
+typedef void (*parallel_body_t)(
+    void * const context, const uint64_t start, const uint64_t end);
+
+uint16_t get_threads_number(const uint16_t requested);
+
+void parallel_for(
+    const uint64_t items_number, const uint16_t threads_number,
+    const parallel_body_t body, void * const context);
@@ -8,61 +8,61 @@ This module contains methods for dumping gene pool into file and vice versa.
 // New year 2022 commit
 
 #include "pickler.h"
+#include "checksum.h"
 
-#define sizeof_member(type, member) sizeof(((type *)0)->member)
-
-#define COPY_MEMBER(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST)                     \
-    { _STRUCT_DIST -> _MEMB_NAME = _STRUCT_SRC -> _MEMB_NAME; }
-
-#define COPY_MEMBER_WITH_SWAP(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST, _DIRECTION)\
-    {                                                                          \
-        _STRUCT_DIST -> _MEMB_NAME = _DIRECTION(_STRUCT_SRC -> _MEMB_NAME);    \
+#define POOL_FAIL_CONDITION(_CONDITION, _ERR_CONST, _BYTE_OFFSET)            \
+    if(_CONDITION) {                                                           \
+        RAISE_ERROR_AT(_ERR_CONST, ERROR_CONTEXT_UNKNOWN, _BYTE_OFFSET);       \
+        return NULL;                                                           \
     }
 
-#define COPY_MEMBER_HTON(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST)                \
-    COPY_MEMBER_WITH_SWAP(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST, HTON)
-
-#define COPY_MEMBER_NTOH(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST)                \
-    COPY_MEMBER_WITH_SWAP(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST, NTOH)
+/*
 
-#define MAPPING_FAIL_CONDITION(_CONDITION, _ERR_CONST) \
-    if(_CONDITION) {ERROR_LEVEL = (_ERR_CONST); close_file(mapping); return NULL;}
+Parse pool which dump starts at `data`. The pool won't own any file mapping,
+so pool->file_mapping is set to NULL and the memory should outlive the pool.
 
-pool_t * read_pool(const char *address) {
+ */
+pool_t * read_pool_from_memory(void * const data, const size_t size) {
 
-    file_map_t * const mapping = open_file(address, OPEN_MODE_READ, 0);
-    if (ERROR_LEVEL != ERR_OK) return NULL;
+    ERROR_LEVEL = ERR_OK;
 
-    MAPPING_FAIL_CONDITION(
-        mapping->size < (POOL_FILE_MIN_SAFE_BIT_SIZE / 8),
-        ERR_POOL_CORRUPT_TOO_SMALL);
+    POOL_FAIL_CONDITION(
+        size < (POOL_FILE_MIN_SAFE_BIT_SIZE / 8),
+        ERR_POOL_CORRUPT_TOO_SMALL, size);
 
-    pool_file_preamble_t *preamble = mapping->data;
+    pool_file_preamble_t *preamble = data;
 
-    MAPPING_FAIL_CONDITION(
+    POOL_FAIL_CONDITION(
         preamble->initial_byte != POOL_INITIAL_BYTE,
-        ERR_POOL_CORRUPT_INITIAL);
+        ERR_POOL_CORRUPT_INITIAL,
+        offsetof(pool_file_preamble_t, initial_byte));
 
-    MAPPING_FAIL_CONDITION(
+    POOL_FAIL_CONDITION(
         preamble->metadata_initial_byte != POOL_META_INITIAL_BYTE,
-        ERR_POOL_CORRUPT_METADATA_START);
+        ERR_POOL_CORRUPT_METADATA_START,
+        offsetof(pool_file_preamble_t, metadata_initial_byte));
 
-    MAPPING_FAIL_CONDITION(
+    POOL_FAIL_CONDITION(
         preamble->node_id_part_bit_size > 64,
-        ERR_GENE_OGSB_TOO_LARGE);
+        ERR_GENE_OGSB_TOO_LARGE,
+        offsetof(pool_file_preamble_t, node_id_part_bit_size));
 
-    MAPPING_FAIL_CONDITION(
+    POOL_FAIL_CONDITION(
         preamble->weight_part_bit_size > 64,
-        ERR_GENE_WEIGHT_TOO_LARGE);
+        ERR_GENE_WEIGHT_TOO_LARGE,
+        offsetof(pool_file_preamble_t, weight_part_bit_size));
 
-    MAPPING_FAIL_CONDITION(
+    POOL_FAIL_CONDITION(
         (preamble->weight_part_bit_size +
-         preamble->node_id_part_bit_size) % 8 != 0,
-        ERR_GENE_NOT_ALIGNED);
+         preamble->node_id_part_bit_size * 2) % 8 != 0,
+        ERR_GENE_NOT_ALIGNED,
+        offsetof(pool_file_preamble_t, node_id_part_bit_size));
 
     DECLARE_CONST_MALLOC_OBJECT(pool_t, pool, RETURN_NULL_ON_ERR);
 
-    pool->file_mapping = mapping;
+    pool->file_mapping = NULL;
+    pool->dirty_ranges = NULL;
+    pool->checksums = NULL;
 
     COPY_MEMBER_NTOH(organisms_number,      preamble, pool);
     COPY_MEMBER_NTOH(metadata_byte_size,    preamble, pool);
@@ -86,11 +86,31 @@ pool_t * read_pool(const char *address) {
 
 }
 
-void open_file_for_pool(
-    const char *address,
-    pool_t * const pool, genome_t ** const genomes) {
+pool_t * read_pool(const char *address) {
 
-    ERROR_LEVEL = 0;
+    file_map_t * const mapping = open_file(address, OPEN_MODE_READ, 0);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    pool_t * const pool = read_pool_from_memory(mapping->data, mapping->size);
+    if (ERROR_LEVEL != ERR_OK) {
+        close_file(mapping);
+        return NULL;
+    }
+
+    pool->file_mapping = mapping;
+
+    return pool;
+
+}
+
+/*
+
+Calculate how many bytes the dump of the pool with given genomes takes.
+
+ */
+size_t get_pool_file_size(
+    const pool_t * const pool, genome_t ** const genomes
+) {
 
     size_t file_size =
         sizeof(pool_file_preamble_t) +
@@ -114,33 +134,174 @@ void open_file_for_pool(
                 genomes[genome_i]->residue_size_bits) +
             sizeof(GENOME_TERMINAL_BYTE);
 
+    return file_size;
+
+}
+
+void open_file_for_pool(
+    const char *address,
+    pool_t * const pool, genome_t ** const genomes) {
+
+    ERROR_LEVEL = 0;
+
+    const size_t file_size = get_pool_file_size(pool, genomes);
+
     file_map_t * const mapping =
         open_file(address, OPEN_MODE_WRITE, file_size - 1);
     if (ERROR_LEVEL != ERR_OK) return;
 
     pool->file_mapping = mapping;
 
+    pool->dirty_ranges = calloc(1, sizeof(pool_dirty_ranges_t));
+    if (pool->dirty_ranges == NULL) {
+        close_file_for_pool(pool);
+        RAISE_MALLOC_ERR(RETURN_VOID_ON_ERR);
+    }
+
 }
 
 void close_file_for_pool(pool_t * const pool) {
     close_file(pool->file_mapping);
+    pool->file_mapping = NULL;
+    FREE_NOT_NULL(pool->dirty_ranges);
+    pool->dirty_ranges = NULL;
+}
+
+/*
+
+Remember that `size` bytes starting from `start` were changed, so they will be
+written back by the next pool_flush. `start` should point into the file mapping
+of the pool. Nothing happens if the pool was not opened for writing.
+
+ */
+void pool_mark_dirty(
+    pool_t * const pool, const void * const start, const size_t size
+) {
+
+    pool_dirty_ranges_t * const tracker = pool->dirty_ranges;
+    if (tracker == NULL || size == 0) return;
+
+    const size_t range_start =
+        (const byte_t *)start - (const byte_t *)pool->file_mapping->data;
+    const size_t range_end = range_start + size;
+
+    tracker->unflushed_bytes += size;
+
+    // extend the range which overlaps or touches the new one
+    for (uint32_t range_i = 0; range_i < tracker->number; range_i++) {
+        pool_dirty_range_t * const range = &tracker->ranges[range_i];
+        if (range_start <= range->end && range_end >= range->start) {
+            if (range_start < range->start) range->start = range_start;
+            if (range_end > range->end) range->end = range_end;
+            return;
+        }
+    }
+
+    if (tracker->number < POOL_DIRTY_RANGES_CAPACITY) {
+        tracker->ranges[tracker->number].start = range_start;
+        tracker->ranges[tracker->number].end = range_end;
+        tracker->number++;
+        return;
+    }
+
+    // no free slots left, so the nearest range swallows the new one
+    uint32_t nearest_i = 0;
+    size_t nearest_gap = SIZE_MAX;
+    for (uint32_t range_i = 0; range_i < tracker->number; range_i++) {
+        const pool_dirty_range_t * const range = &tracker->ranges[range_i];
+        const size_t gap = range_start > range->end
+            ? range_start - range->end
+            : range->start - range_end;
+        if (gap < nearest_gap) {
+            nearest_gap = gap;
+            nearest_i = range_i;
+        }
+    }
+
+    pool_dirty_range_t * const nearest = &tracker->ranges[nearest_i];
+    if (range_start < nearest->start) nearest->start = range_start;
+    if (range_end > nearest->end) nearest->end = range_end;
+
+}
+
+/*
+
+Write changed parts of the pool file back to the disk.
+With POOL_FLUSH_ASYNC writeback of every dirty range is started and the
+function returns without waiting for it.
+With POOL_FLUSH_SYNC the function returns only when the whole mapping is on
+the disk (including ranges which were flushed asynchronously before).
+
+ */
+void pool_flush(pool_t * const pool, const pool_flush_mode_t mode) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (mode != POOL_FLUSH_ASYNC && mode != POOL_FLUSH_SYNC) {
+        ERROR_LEVEL = ERR_WRONG_FLAG;
+        return;
+    }
+
+    if (pool->file_mapping == NULL) return;
+
+    pool_dirty_ranges_t * const tracker = pool->dirty_ranges;
+
+    if (mode == POOL_FLUSH_SYNC || tracker == NULL)
+        flush_file_range(
+            pool->file_mapping, 0, pool->file_mapping->size,
+            mode == POOL_FLUSH_SYNC);
+    else
+        for (uint32_t range_i = 0; range_i < tracker->number; range_i++) {
+            flush_file_range(
+                pool->file_mapping,
+                tracker->ranges[range_i].start,
+                tracker->ranges[range_i].end - tracker->ranges[range_i].start,
+                false /* wait */);
+            if (ERROR_LEVEL != ERR_OK) return;
+        }
+
+    if (ERROR_LEVEL != ERR_OK || tracker == NULL) return;
+
+    tracker->number = 0;
+    tracker->unflushed_bytes = 0;
+
 }
 
 void save_pool(
     pool_t * const pool, genome_t ** const genomes, const save_pool_flag_t flags
 ) {
 
+    PROBE_SCOPE(PROBE_SAVE_POOL);
+    PROBE_BYTES(get_pool_file_size(pool, genomes));
+
+    save_pool_to_memory(pool, genomes, flags, pool->file_mapping->data);
+
+}
+
+/*
+
+Does the same as save_pool, but the dump is placed at `destination` instead of
+the file mapping of the pool. `destination` should have at least
+get_pool_file_size(pool, genomes) bytes.
+
+ */
+void save_pool_to_memory(
+    pool_t * const pool, genome_t ** const genomes,
+    const save_pool_flag_t flags, void * const destination
+) {
+
     ERROR_LEVEL = ERR_OK;
 
     if (
         (flags & POOL_COPY_DATA && flags & POOL_ASSIGN_GENOME_POINTERS) ||
+        (flags & POOL_COPY_DIRTY_DATA && flags & POOL_ASSIGN_GENOME_POINTERS) ||
         (flags & POOL_COPY_METADATA && flags & POOL_ASSIGN_METADATA_POINTERS)
     ) {
         ERROR_LEVEL = ERR_INCOMPATIBLE_FLAGS;
         return;
     }
 
-    pool_file_preamble_t * const pool_preamble = pool->file_mapping->data;
+    pool_file_preamble_t * const pool_preamble = destination;
     if (flags & POOL_REWRITE_DESCRIPTION) {
         pool_preamble->initial_byte         = POOL_INITIAL_BYTE;
         COPY_MEMBER_HTON(organisms_number,        pool, pool_preamble);
@@ -154,6 +315,20 @@ void save_pool(
 
     byte_t * const pool_metadata = &pool_preamble->metadata_initial_byte + 1;
 
+    // Dirty flags of genomes are relative to the pool file, so they're not
+    // touched when the pool is dumped somewhere else.
+    const bool saving_into_pool_file =
+        pool->file_mapping != NULL && pool->file_mapping->data == destination;
+
+    // When the pool is being saved into its own writable mapping, every
+    // written genome is tracked and flushed as soon as enough bytes piled up,
+    // so writeback overlaps with copying of the rest of the pool.
+    const bool rewrites_every_genome =
+        flags & (POOL_COPY_DATA | POOL_COPY_METADATA | POOL_REWRITE_DESCRIPTION);
+    const bool track_dirty_ranges =
+        saving_into_pool_file && pool->dirty_ranges != NULL &&
+        (rewrites_every_genome || flags & POOL_COPY_DIRTY_DATA);
+
     // copy pool meta bytes
     if (flags & POOL_COPY_METADATA)
         memcpy(pool_metadata, pool->metadata, pool->metadata_byte_size);
@@ -221,7 +396,17 @@ void save_pool(
             *(uint8_t *)terminal_byte = GENOME_TERMINAL_BYTE;
         }
 
-        if (flags & POOL_COPY_DATA) {
+        const bool copy_genome_data =
+            flags & POOL_COPY_DATA ||
+            (flags & POOL_COPY_DIRTY_DATA &&
+             current_genome->flags & GENOME_DIRTY);
+
+        // genes of the genome may already live in the mapping (e.g. after
+        // POOL_ASSIGN_GENOME_POINTERS), then only writeback is needed
+        if (
+            copy_genome_data &&
+            current_genome->genes != genome_meta_terminal_byte + 1
+        ) {
             // copy genes
             memcpy(
                 genome_meta_terminal_byte + 1, current_genome->genes,
@@ -231,6 +416,9 @@ void save_pool(
                 residue_start, current_genome->residue, residue_size_bytes);
         }
 
+        if (copy_genome_data && saving_into_pool_file)
+            current_genome->flags &= ~GENOME_DIRTY;
+
         if (flags & POOL_ASSIGN_GENOME_POINTERS) {
             current_genome->genes = genome_meta_terminal_byte + 1;
             current_genome->residue = residue_start;
@@ -238,6 +426,17 @@ void save_pool(
 
         #undef GENES_BYTES_SIZE
 
+        if (
+            track_dirty_ranges &&
+            (copy_genome_data || rewrites_every_genome)
+        ) {
+            pool_mark_dirty(
+                pool, genome_preamble,
+                (byte_t *)terminal_byte + 1 - (byte_t *)genome_preamble);
+            if (pool->dirty_ranges->unflushed_bytes >= POOL_FLUSH_THRESHOLD_BYTES)
+                pool_flush(pool, POOL_FLUSH_ASYNC);
+        }
+
         genome_preamble = terminal_byte + 1;
 
     }
@@ -245,6 +444,19 @@ void save_pool(
     if (flags & POOL_REWRITE_DESCRIPTION)
         genome_preamble->initial_byte = POOL_TERMINAL_BYTE;
 
+    if (track_dirty_ranges && rewrites_every_genome) {
+        pool_mark_dirty(
+            pool, pool_preamble,
+            sizeof(pool_file_preamble_t) + pool->metadata_byte_size +
+            sizeof(POOL_META_TERMINAL_BYTE));
+        pool_mark_dirty(pool, genome_preamble, sizeof(POOL_TERMINAL_BYTE));
+    }
+
+    // only a few genomes are usually dirty, so they are sent to the disk
+    // right away
+    if (track_dirty_ranges && flags & POOL_COPY_DIRTY_DATA)
+        pool_flush(pool, POOL_FLUSH_ASYNC);
+
 }
 
 void write_pool(
@@ -256,12 +468,14 @@ void write_pool(
     save_pool(
         pool, genomes,
         POOL_COPY_DATA | POOL_REWRITE_DESCRIPTION | POOL_COPY_METADATA);
+    pool_flush(pool, POOL_FLUSH_ASYNC);
     close_file_for_pool(pool);
 
 }
 
 void close_pool(pool_t * const pool) {
     if (pool->file_mapping != NULL) close_file_for_pool(pool);
+    detach_pool_checksums(pool);
     free(pool);
 }
 
@@ -270,39 +484,53 @@ void reset_genome_cursor(pool_t * const pool) {
 }
 
 
-genome_t * read_next_genome(pool_t * const pool) {
+/*
 
-    ERROR_LEVEL = 0;
+Parse genome starting at `start` and set `next` to the byte after it. Doesn't
+touch ERROR_LEVEL: errors are written into `status`, and `next` is set to the
+byte which broke the parsing.
 
-    if (*(uint8_t *)pool->cursor == POOL_TERMINAL_BYTE) {
-        ERROR_LEVEL = ERR_GENM_END_ITERATION;
-        return NULL;
-    }
+ */
+genome_t * parse_genome(
+    const pool_t * const pool, void * const start, void ** const next,
+    err_status_t * const status
+) {
 
-    genome_file_preamble_t *preamble = pool->cursor;
+    genome_file_preamble_t *preamble = start;
 
     if (preamble->initial_byte != GENOME_INITIAL_BYTE) {
-        ERROR_LEVEL = ERR_GENM_CORRUPT_START;
+        *status = ERR_GENM_CORRUPT_START;
+        *next = &preamble->initial_byte;
         return NULL;
     }
 
     if (preamble->metadata_initial_byte != GENOME_META_INITIAL_BYTE) {
-        ERROR_LEVEL = ERR_GENM_CORRUPT_METADATA_START;
+        *status = ERR_GENM_CORRUPT_METADATA_START;
+        *next = &preamble->metadata_initial_byte;
         return NULL;
     }
 
-    DECLARE_CONST_MALLOC_OBJECT(genome_t, genome, RETURN_NULL_ON_ERR);
+    genome_t * const genome = malloc(sizeof(genome_t));
+    if (genome == NULL) {
+        *status = ERR_CANNOT_MALLOC;
+        *next = start;
+        return NULL;
+    }
 
     COPY_MEMBER_NTOH(length,             preamble, genome);
     COPY_MEMBER_NTOH(metadata_byte_size, preamble, genome);
 
+    genome->flags = 0;
+
     genome->metadata = &preamble->metadata_initial_byte + 1;
 
     void * const genome_meta_terminal_byte =
         genome->metadata + genome->metadata_byte_size;
 
     if (*(uint8_t *)genome_meta_terminal_byte != GENOME_META_TERMINAL_BYTE) {
-        ERROR_LEVEL = ERR_GENM_CORRUPT_METADATA_END;
+        *status = ERR_GENM_CORRUPT_METADATA_END;
+        *next = genome_meta_terminal_byte;
+        free(genome);
         return NULL;
     }
 
@@ -313,7 +541,8 @@ genome_t * read_next_genome(pool_t * const pool) {
         pool->gene_bytes_size * genome->length);
 
     if (*(uint8_t *)residue_byte != GENOME_RESIDUE_BYTE) {
-        ERROR_LEVEL = ERR_GENM_CORRUPT_RESIDUE;
+        *status = ERR_GENM_CORRUPT_RESIDUE;
+        *next = residue_byte;
         free(genome);
         return NULL;
     }
@@ -328,12 +557,50 @@ genome_t * read_next_genome(pool_t * const pool) {
         genome->residue + BITS_TO_BYTES(genome->residue_size_bits);
 
     if (*(uint8_t *)terminal_byte != GENOME_TERMINAL_BYTE) {
-        ERROR_LEVEL = ERR_GENM_CORRUPT_END;
+        *status = ERR_GENM_CORRUPT_END;
+        *next = terminal_byte;
         free(genome);
         return NULL;
     }
 
-    pool->cursor = terminal_byte + 1;
+    *next = terminal_byte + 1;
+    *status = ERR_OK;
+
+    return genome;
+
+}
+
+genome_t * read_next_genome(pool_t * const pool) {
+
+    PROBE_SCOPE(PROBE_READ_NEXT_GENOME);
+
+    ERROR_LEVEL = 0;
+
+    if (*(uint8_t *)pool->cursor == POOL_TERMINAL_BYTE) {
+        ERROR_LEVEL = ERR_GENM_END_ITERATION;
+        return NULL;
+    }
+
+    if (
+        pool->checksums != NULL &&
+        !verify_genome_checksum(pool, pool->cursor)
+    )
+        return NULL;
+
+    void *next;
+    err_status_t status;
+    genome_t * const genome = parse_genome(pool, pool->cursor, &next, &status);
+
+    if (genome == NULL) {
+        RAISE_ERROR_AT(
+            status, ERROR_CONTEXT_UNKNOWN,
+            (byte_t *)next - POOL_DUMP_START(pool));
+        return NULL;
+    }
+
+    PROBE_BYTES((byte_t *)next - (byte_t *)pool->cursor);
+
+    pool->cursor = next;
 
     return genome;
 
@@ -345,9 +612,160 @@ genome_t ** read_genomes(pool_t * const pool) {
         genome_t, genomes, pool->organisms_number,
         RETURN_NULL_ON_ERR);
 
-    for(uint64_t cursor = 0; cursor <= pool->organisms_number; cursor++)
+    for(uint64_t cursor = 0; cursor < pool->organisms_number; cursor++) {
+
         genomes[cursor] = read_next_genome(pool);
 
+        if (ERROR_LEVEL != ERR_OK) {
+            // read_next_genome doesn't know the index
+            if (ERROR_CONTEXT.status == ERROR_LEVEL)
+                ERROR_CONTEXT.genome_index = cursor;
+            for (uint64_t genome_i = 0; genome_i < cursor; genome_i++)
+                free(genomes[genome_i]);
+            free(genomes);
+            reset_genome_cursor(pool);
+            return NULL;
+        }
+
+    }
+
+    reset_genome_cursor(pool);
+    return genomes;
+
+}
+
+typedef struct genomes_loader_s {
+    const pool_t   *pool;
+    void          **starts;
+    genome_t      **genomes;
+    // first error met by any of the threads
+    err_status_t    status;
+} genomes_loader_t;
+
+void load_genomes_body(
+    void * const loader_void, const uint64_t start, const uint64_t end
+) {
+
+    genomes_loader_t * const loader = loader_void;
+
+    for (uint64_t genome_i = start; genome_i < end; genome_i++) {
+
+        if (__atomic_load_n(&loader->status, __ATOMIC_RELAXED) != ERR_OK)
+            return;
+
+        void *next;
+        err_status_t status;
+        loader->genomes[genome_i] = parse_genome(
+            loader->pool, loader->starts[genome_i], &next, &status);
+
+        if (status != ERR_OK) {
+            err_status_t expected = ERR_OK;
+            __atomic_compare_exchange_n(
+                &loader->status, &expected, status, false,
+                __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+            // reported by parallel_for
+            RAISE_ERROR_AT(
+                status, genome_i,
+                (byte_t *)next - POOL_DUMP_START(loader->pool));
+            return;
+        }
+
+    }
+
+}
+
+/*
+
+Same as read_genomes, but genome structures are built by `threads_number`
+threads (0 means number of online processors).
+
+Genomes have variable length, so their start positions are found first by
+hopping over the headers, which touches only a few bytes per genome. Parsing
+and allocation are then split between threads. If checksums are attached to
+the pool, all of them are verified beforehand (also in parallel).
+
+ */
+genome_t ** read_genomes_parallel(
+    pool_t * const pool, const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (pool->checksums != NULL) {
+        verify_pool(pool, threads_number);
+        if (ERROR_LEVEL != ERR_OK) return NULL;
+    }
+
+    // starts of an empty pool may be NULL
+    void ** const starts = malloc(sizeof(void *) * pool->organisms_number);
+    if (starts == NULL && pool->organisms_number > 0)
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+
+    void *cursor = pool->first_genome_start_position;
+
+    for (uint64_t genome_i = 0; genome_i < pool->organisms_number; genome_i++) {
+
+        const genome_file_preamble_t * const preamble = cursor;
+
+        if (
+            *(uint8_t *)cursor == POOL_TERMINAL_BYTE ||
+            preamble->initial_byte != GENOME_INITIAL_BYTE
+        ) {
+            RAISE_ERROR_AT(
+                ERR_GENM_CORRUPT_START, genome_i,
+                (byte_t *)cursor - POOL_DUMP_START(pool));
+            free(starts);
+            return NULL;
+        }
+
+        starts[genome_i] = cursor;
+
+        const byte_t * const residue_byte =
+            &preamble->metadata_initial_byte + 1 +
+            NTOH(preamble->metadata_byte_size) + 1 +
+            pool->gene_bytes_size * NTOH(preamble->length);
+
+        if (*residue_byte != GENOME_RESIDUE_BYTE) {
+            RAISE_ERROR_AT(
+                ERR_GENM_CORRUPT_RESIDUE, genome_i,
+                residue_byte - POOL_DUMP_START(pool));
+            free(starts);
+            return NULL;
+        }
+
+        const uint16_t residue_size_bits =
+            NTOH(*(uint16_t *)(residue_byte + sizeof(uint8_t)));
+
+        cursor = (void *)(
+            residue_byte + sizeof(uint8_t) + sizeof(uint16_t) +
+            BITS_TO_BYTES(residue_size_bits) + 1);
+
+    }
+
+    genome_t ** const genomes =
+        calloc(pool->organisms_number + 1, sizeof(genome_t *));
+    if (genomes == NULL) {
+        free(starts);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    genomes_loader_t loader = {
+        .pool = pool, .starts = starts, .genomes = genomes, .status = ERR_OK };
+
+    parallel_for(
+        pool->organisms_number, threads_number, load_genomes_body, &loader);
+
+    free(starts);
+
+    if (loader.status != ERR_OK) {
+        for (uint64_t genome_i = 0; genome_i < pool->organisms_number; genome_i++)
+            FREE_NOT_NULL(genomes[genome_i]);
+        free(genomes);
+        // the error of the first failed thread is already set by parallel_for
+        if (ERROR_LEVEL == ERR_OK) ERROR_LEVEL = loader.status;
+        return NULL;
+    }
+
     reset_genome_cursor(pool);
     return genomes;
 
@@ -475,16 +893,6 @@ and output ranges. New ID to `_ID` and type to `_CONNECTION_TYPE_VAR`.
         _ID -= _INPUT_RANGE_SIZE; }                                            \
 }
 
-#define ASSIGN_ID_BY_TYPE(_ID, _TYPE,                                          \
-                           _INPUT_RANGE_SIZE, _OUTPUT_RANGE_SIZE,              \
-                           _NODES_CAPACITY)                                    \
-{                                                                              \
-    if (_TYPE & (GENE_INCOME_IS_INTERMEDIATE | GENE_OUTCOME_IS_INTERMEDIATE))  \
-        _ID += _INPUT_RANGE_SIZE;                                              \
-    if (_TYPE & (GENE_INCOME_IS_OUTPUT | GENE_OUTCOME_IS_OUTPUT))              \
-        _ID += _NODES_CAPACITY - _OUTPUT_RANGE_SIZE;                           \
-}
-
 
 gene_t * get_gene_by_pointer(
     const gene_byte_t * const gene_start_byte, const pool_t * const pool
@@ -573,63 +981,714 @@ void free_gene(gene_t * gene) {
     free(gene);
 }
 
-gene_byte_t * genes_to_byte_array(
-    gene_t ** const genes, pool_t * const pool, uint64_t length
+/*
+
+Reads `size` bits (no more than 64) starting from bit `start` of `slots`. The
+first bit of the slots is the most significant one. Unlike
+copy_bitslots_to_uint64, bytes after the field are never touched, so it is safe
+to use on the last gene of a mapped file.
+
+ */
+static inline uint64_t read_bit_field(
+    const gene_byte_t * const slots, const uint32_t start, const uint8_t size
 ) {
 
-    #define GENES_ARRAY_SIZE \
-        (sizeof(gene_byte_t) * length * pool->gene_bytes_size)
+    const uint32_t end = start + size;
+    uint64_t number = 0;
 
-    // 8 auxiliary bytes is malloc'ed here, because
-    // copy_uint64_to_bitslots can cause writing out of bounds.
-    DECLARE_MALLOC_ARRAY(
-        gene_byte_t, array, GENES_ARRAY_SIZE + 8,
-        RETURN_NULL_ON_ERR);
-    memset(array, 0, GENES_ARRAY_SIZE);
+    for (uint32_t bit = start; bit < end;) {
+        const uint32_t offset = bit % 8,
+                       taken = 8 - offset < end - bit ? 8 - offset : end - bit;
+        number = (number << taken) |
+                 ((slots[bit / 8] >> (8 - offset - taken)) &
+                  ((1U << taken) - 1));
+        bit += taken;
+    }
+
+    return number;
+
+}
+
+/*
+
+Body of decode_genes and decode_genes_float. It is inlined into both of them
+with one of the weight arrays being NULL, so the loop never checks the other
+one.
 
-    #undef GENES_ARRAY_SIZE
+ */
+static inline __attribute__((always_inline)) void decode_genes_into(
+    const pool_t * const pool,
+    const gene_byte_t * const genes, const uint64_t genes_number,
+    gene_node_id_t * const outcome_node_ids,
+    gene_node_id_t * const income_node_ids,
+    gene_connection_flag_t * const connection_types,
+    gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    gene_edge_weight * const weights,
+    gene_edge_weight_float * const weights_float
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    const uint8_t node_bits = pool->node_id_part_bit_size,
+                  weight_bits = pool->weight_part_bit_size;
+
+    if (node_bits > 64 || weight_bits > 64) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
 
-    uint64_t nodes_capacity = MAX_FOR_BIT_WIDTH(pool->gene_bytes_size);
+    const uint64_t nodes_capacity = MAX_FOR_BIT_WIDTH(node_bits);
+    const double weight_capacity = (double)MAX_FOR_BIT_WIDTH(weight_bits);
+    const float weight_capacity_float = (float)MAX_FOR_BIT_WIDTH(weight_bits);
 
-    gene_byte_t *start_byte;
-    gene_t      *gene;
-    for (uint64_t counter = 0; counter < length; counter++) {
+    const gene_byte_t *gene = genes;
+    for (uint64_t index = 0; index < genes_number;
+         index++, gene += pool->gene_bytes_size) {
 
-        start_byte = array + counter * pool->gene_bytes_size;
-        gene = genes[counter];
+        uint64_t outcome_node_id = read_bit_field(gene, 0, node_bits),
+                 income_node_id = read_bit_field(gene, node_bits, node_bits);
+        // sign of number is not important, just copy all the bits
+        const uint64_t weight = read_bit_field(
+            gene, node_bits * 2, weight_bits);
 
-        uint64_t outcome_node_id = gene->outcome_node_id,
-                 income_node_id = gene->income_node_id;
+        gene_connection_flag_t connection_type = 0;
 
-        ASSIGN_ID_BY_TYPE(
+        ASSIGN_TYPE_BY_ID(
             outcome_node_id,
-            gene->connection_type,
             pool->input_neurons_number, pool->output_neurons_number,
-            nodes_capacity);
+            nodes_capacity,
+            connection_type,
+            OUTCOME);
 
-        ASSIGN_ID_BY_TYPE(
+        ASSIGN_TYPE_BY_ID(
             income_node_id,
-            gene->connection_type,
             pool->input_neurons_number, pool->output_neurons_number,
-            nodes_capacity);
-
-        copy_uint64_to_bitslots(
-            &outcome_node_id,
-            start_byte,
-            0,
-            pool->node_id_part_bit_size);
-
-        copy_uint64_to_bitslots(
-            &income_node_id,
-            start_byte,
-            pool->node_id_part_bit_size,
-            pool->node_id_part_bit_size);
-
-        copy_uint64_to_bitslots(
-            (uint64_t *)&(gene->weight_unnormalized),
-            start_byte,
-            pool->node_id_part_bit_size * 2,
-            pool->weight_part_bit_size);
+            nodes_capacity,
+            connection_type,
+            INCOME);
+
+        if (outcome_node_ids)     outcome_node_ids[index] = outcome_node_id;
+        if (income_node_ids)      income_node_ids[index] = income_node_id;
+        if (connection_types)     connection_types[index] = connection_type;
+        if (weights_unnormalized) weights_unnormalized[index] = weight;
+        if (weights)              weights[index] = weight / weight_capacity;
+        if (weights_float)
+            weights_float[index] = (float)weight / weight_capacity_float;
+
+    }
+
+}
+
+void decode_genes(
+    const pool_t * const pool,
+    const gene_byte_t * const genes, const uint64_t genes_number,
+    gene_node_id_t * const outcome_node_ids,
+    gene_node_id_t * const income_node_ids,
+    gene_connection_flag_t * const connection_types,
+    gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    gene_edge_weight * const weights
+) {
+
+    decode_genes_into(
+        pool, genes, genes_number,
+        outcome_node_ids, income_node_ids, connection_types,
+        weights_unnormalized, weights, NULL);
+
+}
+
+void decode_genes_float(
+    const pool_t * const pool,
+    const gene_byte_t * const genes, const uint64_t genes_number,
+    gene_node_id_t * const outcome_node_ids,
+    gene_node_id_t * const income_node_ids,
+    gene_connection_flag_t * const connection_types,
+    gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    gene_edge_weight_float * const weights
+) {
+
+    decode_genes_into(
+        pool, genes, genes_number,
+        outcome_node_ids, income_node_ids, connection_types,
+        weights_unnormalized, NULL, weights);
+
+}
+
+/*
+
+Float has FLT_MANT_DIG (24) bits of significand. If the weight part is not
+wider, neighbouring weights differ by more than the rounding error of a float,
+so every raw weight keeps its own float value and encode_genes rounds it back
+to the same bits.
+
+ */
+bool float_weights_are_lossless(const pool_t * const pool) {
+    return pool->weight_part_bit_size <= FLT_MANT_DIG;
+}
+
+/*
+
+Writes `size` bits (no more than 64) of `number` starting from bit `start` of
+`slots`, the opposite of read_bit_field. Other bits of the slots are kept.
+
+ */
+static inline void write_bit_field(
+    gene_byte_t * const slots, const uint32_t start, const uint8_t size,
+    const uint64_t number
+) {
+
+    const uint32_t end = start + size;
+
+    for (uint32_t bit = start; bit < end;) {
+        const uint32_t offset = bit % 8,
+                       taken = 8 - offset < end - bit ? 8 - offset : end - bit,
+                       shift = 8 - offset - taken;
+        const uint8_t mask = ((1U << taken) - 1) << shift;
+        const uint8_t part =
+            ((number >> (end - bit - taken)) & ((1U << taken) - 1)) << shift;
+        slots[bit / 8] = (slots[bit / 8] & ~mask) | part;
+        bit += taken;
+    }
+
+}
+
+/*
+
+Constants of encode_genes for the pool. Fields of a gene are packed into a
+word aligned to its most significant bit, so that the bytes of the gene are
+the first bytes of the byte-swapped word.
+
+ */
+typedef struct gene_encoding_s {
+    uint8_t   node_bits;
+    uint8_t   weight_bits;
+    uint16_t  gene_bits;
+    uint64_t  node_mask;
+    uint64_t  weight_mask;
+    // added to node ids of intermediate and output nodes, see
+    // ASSIGN_TYPE_BY_ID
+    uint64_t  intermediate_offset;
+    uint64_t  output_offset;
+    double    weight_capacity;
+} gene_encoding_t;
+
+typedef void (*gene_words_kernel_t)(
+    const gene_encoding_t * const,
+    const gene_node_id_t * const outcome_node_ids,
+    const gene_node_id_t * const income_node_ids,
+    const gene_connection_flag_t * const connection_types,
+    const uint64_t * const weights,
+    const uint32_t genes_number, uint64_t * const words);
+
+/*
+
+Pack genes of no more than 64 bits into byte-swapped words. The loop has no
+branches, so the compiler vectorizes it for every target it is built for.
+
+ */
+#define DEFINE_GENE_WORDS_KERNEL(_NAME, _ATTRIBUTES)                           \
+    _ATTRIBUTES void _NAME(                                                    \
+        const gene_encoding_t * const encoding,                                \
+        const gene_node_id_t * const outcome_node_ids,                         \
+        const gene_node_id_t * const income_node_ids,                          \
+        const gene_connection_flag_t * const connection_types,                 \
+        const uint64_t * const weights,                                        \
+        const uint32_t genes_number, uint64_t * const words                    \
+    ) {                                                                        \
+        const uint64_t node_mask = encoding->node_mask,                        \
+                       weight_mask = encoding->weight_mask,                    \
+                       intermediate_offset = encoding->intermediate_offset,    \
+                       output_offset = encoding->output_offset;                \
+        const uint32_t outcome_shift = 64 - encoding->node_bits,               \
+                       income_shift = 64 - encoding->node_bits * 2,            \
+                       weight_shift = 64 - encoding->gene_bits;                \
+        for (uint32_t index = 0; index < genes_number; index++) {              \
+            const gene_connection_flag_t type = connection_types[index];       \
+            const uint64_t outcome_node_id = outcome_node_ids[index] +         \
+                (type & GENE_OUTCOME_IS_INTERMEDIATE ?                         \
+                    intermediate_offset : 0) +                                 \
+                (type & GENE_OUTCOME_IS_OUTPUT ? output_offset : 0);           \
+            const uint64_t income_node_id = income_node_ids[index] +           \
+                (type & GENE_INCOME_IS_INTERMEDIATE ?                          \
+                    intermediate_offset : 0) +                                 \
+                (type & GENE_INCOME_IS_OUTPUT ? output_offset : 0);            \
+            words[index] = __builtin_bswap64(                                  \
+                (outcome_node_id & node_mask) << outcome_shift |               \
+                (income_node_id & node_mask) << income_shift |                 \
+                (weights[index] & weight_mask) << weight_shift);               \
+        }                                                                      \
+    }
+
+DEFINE_GENE_WORDS_KERNEL(pack_gene_words_default, )
+
+#if defined(__x86_64__) || defined(__i386__)
+DEFINE_GENE_WORDS_KERNEL(pack_gene_words_avx2, __attribute__((target("avx2"))))
+#endif
+
+#undef DEFINE_GENE_WORDS_KERNEL
+
+pthread_once_t gene_words_kernel_once = PTHREAD_ONCE_INIT;
+gene_words_kernel_t pack_gene_words = pack_gene_words_default;
+
+void choose_gene_words_kernel() {
+
+    #if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        pack_gene_words = pack_gene_words_avx2;
+    #endif
+
+}
+
+/*
+
+Store packed words as genes of `gene_bytes_size` bytes. Whole words are
+written while they fit into the `room` bytes left in the destination: the
+extra bytes are overwritten by the next gene. With the size known at compile
+time every store is a single instruction.
+
+ */
+static inline __attribute__((always_inline)) void store_gene_words(
+    gene_byte_t * const destination, const uint64_t * const words,
+    const uint32_t genes_number, const pool_gene_byte_size_t gene_bytes_size,
+    const uint64_t room
+) {
+
+    uint32_t index = 0;
+
+    for (;
+         index < genes_number &&
+         (uint64_t)index * gene_bytes_size + sizeof(uint64_t) <= room;
+         index++)
+        memcpy(
+            destination + (uint64_t)index * gene_bytes_size,
+            &words[index], sizeof(uint64_t));
+
+    for (; index < genes_number; index++)
+        memcpy(
+            destination + (uint64_t)index * gene_bytes_size,
+            &words[index], gene_bytes_size);
+
+}
+
+/*
+
+Encode genes wider than 64 bits. Genes of up to 128 bits are packed into pairs
+of byte-swapped words and stored like in store_gene_words, wider ones are
+written field by field.
+
+ */
+void encode_wide_genes(
+    const gene_encoding_t * const encoding,
+    const pool_gene_byte_size_t gene_bytes_size,
+    const gene_node_id_t * const outcome_node_ids,
+    const gene_node_id_t * const income_node_ids,
+    const gene_connection_flag_t * const connection_types,
+    const uint64_t * const weights,
+    const uint32_t genes_number, gene_byte_t * const destination,
+    const uint64_t room
+) {
+
+    for (uint32_t index = 0; index < genes_number; index++) {
+
+        const gene_connection_flag_t type = connection_types[index];
+        const uint64_t outcome_node_id = (outcome_node_ids[index] +
+            (type & GENE_OUTCOME_IS_INTERMEDIATE ?
+                encoding->intermediate_offset : 0) +
+            (type & GENE_OUTCOME_IS_OUTPUT ? encoding->output_offset : 0)) &
+            encoding->node_mask;
+        const uint64_t income_node_id = (income_node_ids[index] +
+            (type & GENE_INCOME_IS_INTERMEDIATE ?
+                encoding->intermediate_offset : 0) +
+            (type & GENE_INCOME_IS_OUTPUT ? encoding->output_offset : 0)) &
+            encoding->node_mask;
+        const uint64_t weight = weights[index] & encoding->weight_mask;
+
+        gene_byte_t * const gene = destination + (uint64_t)index * gene_bytes_size;
+
+        if (encoding->gene_bits > 128) {
+            // write_bit_field keeps the other bits of the byte, so padding
+            // after the weight would be left uninitialized
+            gene[gene_bytes_size - 1] = 0;
+            write_bit_field(gene, 0, encoding->node_bits, outcome_node_id);
+            write_bit_field(
+                gene, encoding->node_bits, encoding->node_bits, income_node_id);
+            write_bit_field(
+                gene, encoding->node_bits * 2, encoding->weight_bits, weight);
+            continue;
+        }
+
+        const unsigned __int128 packed = (
+            (unsigned __int128)outcome_node_id <<
+                (encoding->node_bits + encoding->weight_bits) |
+            (unsigned __int128)income_node_id << encoding->weight_bits |
+            weight) << (128 - encoding->gene_bits);
+
+        const uint64_t halves[2] = {
+            __builtin_bswap64((uint64_t)(packed >> 64)),
+            __builtin_bswap64((uint64_t)packed)
+        };
+
+        if ((uint64_t)index * gene_bytes_size + sizeof(halves) <= room)
+            memcpy(gene, halves, sizeof(halves));
+        else
+            memcpy(gene, halves, gene_bytes_size);
+
+    }
+
+}
+
+#define STORE_GENE_WORDS_CASE(_SIZE)                                           \
+    case _SIZE:                                                                \
+        store_gene_words(destination, words, chunk, _SIZE, room);              \
+        break;
+
+void encode_genes(
+    const pool_t * const pool,
+    gene_byte_t * const genes, const uint64_t genes_number,
+    const gene_node_id_t * const outcome_node_ids,
+    const gene_node_id_t * const income_node_ids,
+    const gene_connection_flag_t * const connection_types,
+    const gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    const gene_edge_weight * const weights
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (pool->node_id_part_bit_size > 64 || pool->weight_part_bit_size > 64) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
+
+    if (
+        outcome_node_ids == NULL || income_node_ids == NULL ||
+        (weights_unnormalized == NULL && weights == NULL)
+    ) {
+        ERROR_LEVEL = ERR_NOT_ENOUGH_PARAMS;
+        return;
+    }
+
+    pthread_once(&gene_words_kernel_once, choose_gene_words_kernel);
+
+    const uint64_t nodes_capacity =
+        MAX_FOR_BIT_WIDTH(pool->node_id_part_bit_size);
+
+    const gene_encoding_t encoding = {
+        .node_bits = pool->node_id_part_bit_size,
+        .weight_bits = pool->weight_part_bit_size,
+        .gene_bits =
+            pool->node_id_part_bit_size * 2 + pool->weight_part_bit_size,
+        .node_mask = nodes_capacity,
+        .weight_mask = MAX_FOR_BIT_WIDTH(pool->weight_part_bit_size),
+        .intermediate_offset = pool->input_neurons_number,
+        .output_offset = nodes_capacity - pool->output_neurons_number + 1,
+        .weight_capacity =
+            (double)MAX_FOR_BIT_WIDTH(pool->weight_part_bit_size)
+    };
+
+    const pool_gene_byte_size_t gene_bytes_size = pool->gene_bytes_size;
+
+    // missing arrays are replaced by blocks of the same size
+    gene_connection_flag_t no_types[ENCODE_GENES_BLOCK_SIZE];
+    uint64_t block_weights[ENCODE_GENES_BLOCK_SIZE];
+    uint64_t words[ENCODE_GENES_BLOCK_SIZE];
+
+    if (connection_types == NULL) memset(no_types, 0, sizeof(no_types));
+
+    for (uint64_t start = 0; start < genes_number; start += ENCODE_GENES_BLOCK_SIZE) {
+
+        const uint32_t chunk =
+            genes_number - start < ENCODE_GENES_BLOCK_SIZE
+            ? genes_number - start : ENCODE_GENES_BLOCK_SIZE;
+
+        const gene_connection_flag_t * const types =
+            connection_types != NULL ? connection_types + start : no_types;
+
+        const uint64_t *raw_weights;
+        if (weights_unnormalized != NULL)
+            raw_weights = (const uint64_t *)weights_unnormalized + start;
+        else {
+            // the opposite of the normalization made by decode_genes
+            for (uint32_t index = 0; index < chunk; index++) {
+                const double weight =
+                    weights[start + index] * encoding.weight_capacity;
+                block_weights[index] =
+                    weight <= 0 ? 0 :
+                    weight >= encoding.weight_capacity ? encoding.weight_mask :
+                    (uint64_t)(weight + 0.5);
+            }
+            raw_weights = block_weights;
+        }
+
+        gene_byte_t * const destination = genes + start * gene_bytes_size;
+        const uint64_t room = (genes_number - start) * gene_bytes_size;
+
+        if (encoding.gene_bits > 64) {
+            encode_wide_genes(
+                &encoding, gene_bytes_size,
+                outcome_node_ids + start, income_node_ids + start,
+                types, raw_weights, chunk, destination, room);
+            continue;
+        }
+
+        pack_gene_words(
+            &encoding, outcome_node_ids + start, income_node_ids + start,
+            types, raw_weights, chunk, words);
+
+        switch (gene_bytes_size) {
+            STORE_GENE_WORDS_CASE(1)
+            STORE_GENE_WORDS_CASE(2)
+            STORE_GENE_WORDS_CASE(3)
+            STORE_GENE_WORDS_CASE(4)
+            STORE_GENE_WORDS_CASE(5)
+            STORE_GENE_WORDS_CASE(6)
+            STORE_GENE_WORDS_CASE(7)
+            STORE_GENE_WORDS_CASE(8)
+        }
+
+    }
+
+}
+
+#undef STORE_GENE_WORDS_CASE
+
+/*
+
+Encode genes into the genome starting from gene `first_gene`. The genome is
+marked as changed (see GENOME_DIRTY), and if its genes lie in the writable
+file mapping of the pool, the range is marked for flushing.
+
+ */
+void encode_genome_genes(
+    pool_t * const pool, genome_t * const genome,
+    const genome_length_t first_gene, const uint64_t genes_number,
+    const gene_node_id_t * const outcome_node_ids,
+    const gene_node_id_t * const income_node_ids,
+    const gene_connection_flag_t * const connection_types,
+    const gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    const gene_edge_weight * const weights
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    #ifndef SKIP_CHECK_BOUNDS
+    if ((uint64_t)first_gene + genes_number > genome->length) {
+        ERROR_LEVEL = ERR_OUT_OF_BOUNDS;
+        return;
+    }
+    #endif
+
+    gene_byte_t * const start =
+        genome->genes + (uint64_t)first_gene * pool->gene_bytes_size;
+    const size_t size = genes_number * pool->gene_bytes_size;
+
+    encode_genes(
+        pool, start, genes_number,
+        outcome_node_ids, income_node_ids, connection_types,
+        weights_unnormalized, weights);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    genome->flags |= GENOME_DIRTY;
+
+    if (
+        pool->file_mapping != NULL &&
+        start >= (gene_byte_t *)pool->file_mapping->data &&
+        start + size <=
+            (gene_byte_t *)pool->file_mapping->data + pool->file_mapping->size
+    )
+        pool_mark_dirty(pool, start, size);
+
+}
+
+uint64_t get_genes_stride(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number
+) {
+
+    if (organisms_number == 0)
+        return 0;
+
+    const uint64_t genes_byte_size =
+        (uint64_t)genomes[0]->length * pool->gene_bytes_size;
+
+    if (organisms_number == 1)
+        return genes_byte_size;
+
+    const gene_byte_t *first = genomes[0]->genes;
+    const ptrdiff_t stride = genomes[1]->genes - first;
+
+    if (stride < (ptrdiff_t)genes_byte_size)
+        return 0;
+
+    for (pool_organisms_num_t index = 1; index < organisms_number; index++)
+        if (genomes[index]->length != genomes[0]->length ||
+            genomes[index]->genes != first + stride * index)
+            return 0;
+
+    return stride;
+
+}
+
+/*
+
+Create cursor at the first gene of the genome. `chunk_capacity` of 0 means
+GENES_CURSOR_DEFAULT_CHUNK.
+
+ */
+genes_cursor_t * create_genes_cursor(
+    const pool_t * const pool, const genome_t * const genome,
+    const uint32_t chunk_capacity
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (pool->node_id_part_bit_size > 64 || pool->weight_part_bit_size > 64) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return NULL;
+    }
+
+    DECLARE_CONST_MALLOC_OBJECT(genes_cursor_t, cursor, RETURN_NULL_ON_ERR);
+
+    cursor->pool = pool;
+    cursor->genome = genome;
+    cursor->position = 0;
+    cursor->chunk_capacity =
+        chunk_capacity ? chunk_capacity : GENES_CURSOR_DEFAULT_CHUNK;
+    cursor->chunk_start = 0;
+    cursor->chunk_size = 0;
+
+    cursor->outcome_node_ids = malloc(
+        sizeof(gene_node_id_t) * cursor->chunk_capacity);
+    cursor->income_node_ids = malloc(
+        sizeof(gene_node_id_t) * cursor->chunk_capacity);
+    cursor->connection_types = malloc(
+        sizeof(gene_connection_flag_t) * cursor->chunk_capacity);
+    cursor->weights_unnormalized = malloc(
+        sizeof(gene_edge_weight_unnormalized_t) * cursor->chunk_capacity);
+    cursor->weights = malloc(
+        sizeof(gene_edge_weight) * cursor->chunk_capacity);
+
+    if (cursor->outcome_node_ids == NULL ||
+        cursor->income_node_ids == NULL ||
+        cursor->connection_types == NULL ||
+        cursor->weights_unnormalized == NULL ||
+        cursor->weights == NULL)
+        DESTROY_AND_EXIT(destroy_genes_cursor, cursor, RETURN_NULL_ON_ERR);
+
+    return cursor;
+
+}
+
+/*
+
+Decode the next chunk into the buffers of the cursor and return the number of
+decoded genes. Returns 0 when all the genes were already decoded.
+
+ */
+uint32_t next_genes_chunk(genes_cursor_t * const cursor) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    const genome_length_t genes_left =
+        cursor->genome->length - cursor->position;
+
+    cursor->chunk_start = cursor->position;
+    cursor->chunk_size =
+        genes_left < cursor->chunk_capacity
+            ? genes_left : cursor->chunk_capacity;
+
+    if (cursor->chunk_size == 0) return 0;
+
+    decode_genes(
+        cursor->pool,
+        point_gene_in_genome_by_index(
+            cursor->genome, cursor->position, cursor->pool),
+        cursor->chunk_size,
+        cursor->outcome_node_ids,
+        cursor->income_node_ids,
+        cursor->connection_types,
+        cursor->weights_unnormalized,
+        cursor->weights);
+
+    cursor->position += cursor->chunk_size;
+
+    return cursor->chunk_size;
+
+}
+
+/*
+
+Move the cursor, so the next chunk starts from gene `position`.
+
+ */
+void seek_genes_cursor(
+    genes_cursor_t * const cursor, const genome_length_t position
+) {
+
+    #ifndef SKIP_CHECK_BOUNDS
+    if (position > cursor->genome->length) {
+        ERROR_LEVEL = ERR_OUT_OF_BOUNDS;
+        return;
+    }
+    #endif
+
+    ERROR_LEVEL = ERR_OK;
+
+    cursor->position = position;
+    cursor->chunk_size = 0;
+
+}
+
+void destroy_genes_cursor(genes_cursor_t * const cursor) {
+    FREE_NOT_NULL(cursor->outcome_node_ids);
+    FREE_NOT_NULL(cursor->income_node_ids);
+    FREE_NOT_NULL(cursor->connection_types);
+    FREE_NOT_NULL(cursor->weights_unnormalized);
+    FREE_NOT_NULL(cursor->weights);
+    free(cursor);
+}
+
+/*
+
+Encode array of genes with encode_genes. Node ids are given relative to the
+ranges of their connection types, as get_gene_by_pointer returns them.
+
+ */
+gene_byte_t * genes_to_byte_array(
+    gene_t ** const genes, pool_t * const pool, uint64_t length
+) {
+
+    DECLARE_MALLOC_ARRAY(
+        gene_byte_t, array, length * pool->gene_bytes_size + 1,
+        RETURN_NULL_ON_ERR);
+
+    gene_node_id_t outcome_node_ids[ENCODE_GENES_BLOCK_SIZE],
+                   income_node_ids[ENCODE_GENES_BLOCK_SIZE];
+    gene_connection_flag_t connection_types[ENCODE_GENES_BLOCK_SIZE];
+    gene_edge_weight_unnormalized_t weights[ENCODE_GENES_BLOCK_SIZE];
+
+    for (uint64_t start = 0; start < length; start += ENCODE_GENES_BLOCK_SIZE) {
+
+        const uint32_t chunk =
+            length - start < ENCODE_GENES_BLOCK_SIZE
+            ? length - start : ENCODE_GENES_BLOCK_SIZE;
+
+        for (uint32_t index = 0; index < chunk; index++) {
+            const gene_t * const gene = genes[start + index];
+            outcome_node_ids[index] = gene->outcome_node_id;
+            income_node_ids[index] = gene->income_node_id;
+            connection_types[index] = gene->connection_type;
+            weights[index] = gene->weight_unnormalized;
+        }
+
+        encode_genes(
+            pool, array + start * pool->gene_bytes_size, chunk,
+            outcome_node_ids, income_node_ids, connection_types, weights, NULL);
+
+        if (ERROR_LEVEL != ERR_OK) {
+            free(array);
+            return NULL;
+        }
 
     }
 
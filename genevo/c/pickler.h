@@ -12,6 +12,8 @@ little slower on little-endian platform because of byte swappings.
 #include <stdint.h>
 #include <string.h>
 #include <stddef.h>
+#include <stdbool.h>
+#include <float.h>
 
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -26,10 +28,18 @@ little slower on little-endian platform because of byte swappings.
 #include "types.h"
 #include "bit_manipulations.h"
 #include "memory.h"
+#include "parallel.h"
+#include "instrumentation.h"
 
 // Even the empty pool file should be at least 256 bits long.
 #define POOL_FILE_MIN_SAFE_BIT_SIZE 256
 
+// save_pool starts writeback of the pool file every time this number of bytes
+// were written into it.
+#ifndef POOL_FLUSH_THRESHOLD_BYTES
+#   define POOL_FLUSH_THRESHOLD_BYTES (64 << 20)
+#endif
+
 typedef uint8_t file_control_byte_t;
 
 #define POOL_INITIAL_BYTE           (file_control_byte_t)0xAB
@@ -127,6 +137,15 @@ typedef struct pool_file_preamble_s {
     file_control_byte_t        metadata_initial_byte;
 } __attribute__((packed, aligned(1))) pool_file_preamble_t;
 
+#define POOL_DESCRIPTION_BYTE_SIZE(_POOL)                                      \
+    (sizeof(pool_file_preamble_t) + (_POOL)->metadata_byte_size +              \
+     sizeof(POOL_META_TERMINAL_BYTE))
+
+// Start of the pool dump, offsets in error contexts are counted from it
+#define POOL_DUMP_START(_POOL)                                                 \
+    ((byte_t *)(_POOL)->first_genome_start_position -                          \
+     POOL_DESCRIPTION_BYTE_SIZE(_POOL))
+
 
 void copy_bitslots_to_uint64(
     const byte_t * const slots, uint64_t * const number,
@@ -185,10 +204,253 @@ gene_t * get_gene_by_pointer(const gene_byte_t * const, const pool_t * const);
 */
 void free_gene(gene_t *);
 
+/*
+
+Decodes `genes_number` consecutive genes into separate arrays (one per member
+of gene_t), so they can be viewed as vectors without creating a gene_t for
+every gene. Node ids and connection types are the same as those given by
+get_gene_by_pointer. Any of the arrays may be NULL, in which case that member
+is not decoded.
+
+ */
+/* @function decode_genes
+ * @return void
+ * @argument pool*
+ * @argument uint8*
+ * @argument uint64
+ * @argument uint64*
+ * @argument uint64*
+ * @argument uint8*
+ * @argument int64*
+ * @argument double*
+ */
+void decode_genes(
+    const pool_t * const,
+    const gene_byte_t * const genes, const uint64_t genes_number,
+    gene_node_id_t * const outcome_node_ids,
+    gene_node_id_t * const income_node_ids,
+    gene_connection_flag_t * const connection_types,
+    gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    gene_edge_weight * const weights);
+
+/*
+
+Same as decode_genes, but normalized weights are written as floats, which
+halves the memory taken by them. Weights are exactly as precise as with
+decode_genes if float_weights_are_lossless returns true for the pool.
+
+ */
+/* @function decode_genes_float
+ * @return void
+ * @argument pool*
+ * @argument uint8*
+ * @argument uint64
+ * @argument uint64*
+ * @argument uint64*
+ * @argument uint8*
+ * @argument int64*
+ * @argument float*
+ */
+void decode_genes_float(
+    const pool_t * const,
+    const gene_byte_t * const genes, const uint64_t genes_number,
+    gene_node_id_t * const outcome_node_ids,
+    gene_node_id_t * const income_node_ids,
+    gene_connection_flag_t * const connection_types,
+    gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    gene_edge_weight_float * const weights);
+
+/* @function float_weights_are_lossless
+ * @return uint8
+ * @argument pool*
+ */
+bool float_weights_are_lossless(const pool_t * const);
+
+// Genes packed by encode_genes at once
+#ifndef ENCODE_GENES_BLOCK_SIZE
+#   define ENCODE_GENES_BLOCK_SIZE 256
+#endif
+
+/*
+
+Encodes `genes_number` genes from separate arrays into `genes`, the opposite
+of decode_genes. Node ids are relative to the ranges given by
+`connection_types`; if it is NULL, ids are written as they are. Weights are
+taken from `weights_unnormalized`, or from `weights` if it is NULL.
+
+Genes are packed in blocks into machine words by a vectorized kernel (AVX2 if
+the processor supports it) and stored with a loop specialized for every gene
+size up to 8 bytes. Wider genes are packed one by one. Bytes after the last
+gene are never touched, so genes can be written straight into the file
+mapping of the pool (see encode_genome_genes).
+
+ */
+/* @function encode_genes
+ * @return void
+ * @argument pool*
+ * @argument uint8*
+ * @argument uint64
+ * @argument uint64*
+ * @argument uint64*
+ * @argument uint8*
+ * @argument int64*
+ * @argument double*
+ */
+void encode_genes(
+    const pool_t * const,
+    gene_byte_t * const genes, const uint64_t genes_number,
+    const gene_node_id_t * const outcome_node_ids,
+    const gene_node_id_t * const income_node_ids,
+    const gene_connection_flag_t * const connection_types,
+    const gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    const gene_edge_weight * const weights);
+
+/* @function encode_genome_genes
+ * @return void
+ * @argument pool*
+ * @argument genome*
+ * @argument uint32
+ * @argument uint64
+ * @argument uint64*
+ * @argument uint64*
+ * @argument uint8*
+ * @argument int64*
+ * @argument double*
+ */
+void encode_genome_genes(
+    pool_t * const, genome_t * const,
+    const genome_length_t first_gene, const uint64_t genes_number,
+    const gene_node_id_t * const outcome_node_ids,
+    const gene_node_id_t * const income_node_ids,
+    const gene_connection_flag_t * const connection_types,
+    const gene_edge_weight_unnormalized_t * const weights_unnormalized,
+    const gene_edge_weight * const weights);
+
+/*
+
+Returns the distance in bytes between genes of the neighboring genomes if all
+the genomes have the same length and lie in memory with the same step (e.g.
+genomes of a pool file with metadata and residue of the same sizes). Such genes
+form a dense block, which can be viewed as one three-dimensional array.
+Returns 0 otherwise.
+
+ */
+/* @function get_genes_stride
+ * @return uint64
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ */
+uint64_t get_genes_stride(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number);
+
+#ifndef GENES_CURSOR_DEFAULT_CHUNK
+#   define GENES_CURSOR_DEFAULT_CHUNK 4096
+#endif
+
+/*
+
+Cursor decodes genes of the genome by chunks of at most `chunk_capacity` genes
+into the same buffers (see decode_genes), so iterating over a genome of any
+length takes constant memory. Buffers are overwritten by every
+next_genes_chunk.
+
+ */
+/* @typedef genes_cursor_p
+ * @from_type genes_cursor*
+ */
+/* @struct genes_cursor
+ * @member pool* pool
+ * @member genome* genome
+ * @member uint32 position
+ * @member uint32 chunk_capacity
+ * @member uint32 chunk_start
+ * @member uint32 chunk_size
+ * @member uint64* outcome_node_ids
+ * @member uint64* income_node_ids
+ * @member uint8* connection_types
+ * @member int64* weights_unnormalized
+ * @member double* weights
+ */
+typedef struct genes_cursor_s {
+    const pool_t                     *pool;
+    const genome_t                   *genome;
+    // index of the first gene of the next chunk
+    genome_length_t                   position;
+    uint32_t                          chunk_capacity;
+    // index of the first gene of the current chunk
+    genome_length_t                   chunk_start;
+    uint32_t                          chunk_size;
+    gene_node_id_t                   *outcome_node_ids;
+    gene_node_id_t                   *income_node_ids;
+    gene_connection_flag_t           *connection_types;
+    gene_edge_weight_unnormalized_t  *weights_unnormalized;
+    gene_edge_weight                 *weights;
+} genes_cursor_t;
+
+/* @function create_genes_cursor
+ * @return genes_cursor*
+ * @argument pool*
+ * @argument genome*
+ * @argument uint32
+ */
+genes_cursor_t * create_genes_cursor(
+    const pool_t * const, const genome_t * const,
+    const uint32_t chunk_capacity);
+
+/* @function next_genes_chunk
+ * @return uint32
+ * @argument genes_cursor*
+ */
+uint32_t next_genes_chunk(genes_cursor_t * const);
+
+/* @function seek_genes_cursor
+ * @return void
+ * @argument genes_cursor*
+ * @argument uint32
+ */
+void seek_genes_cursor(genes_cursor_t * const, const genome_length_t position);
+
+/* @function destroy_genes_cursor
+ * @return void
+ * @argument genes_cursor*
+ */
+void destroy_genes_cursor(genes_cursor_t * const);
+
+size_t get_pool_file_size(const pool_t * const, genome_t ** const);
+
 void open_file_for_pool(
     const char *address, pool_t * const, genome_t ** const);
 void close_file_for_pool(pool_t * const pool);
 
+/* @function pool_mark_dirty
+ * @return void
+ * @argument pool*
+ * @argument uint8*
+ * @argument size
+ */
+void pool_mark_dirty(
+    pool_t * const, const void * const start, const size_t size);
+
+/* @enum pool_flush_mode
+ * @type uint8
+ * @member POOL_FLUSH_ASYNC (1 << 0)
+ * @member POOL_FLUSH_SYNC  (1 << 1)
+ */
+typedef enum pool_flush_mode_e {
+    POOL_FLUSH_ASYNC = (uint8_t)(1 << 0),
+    POOL_FLUSH_SYNC  = (uint8_t)(1 << 1)
+} pool_flush_mode_t;
+
+/* @function pool_flush
+ * @return void
+ * @argument pool*
+ * @argument pool_flush_mode
+ */
+void pool_flush(pool_t * const, const pool_flush_mode_t);
+
 /* @flags save_pool_flag
  * @type uint8
  * @flag POOL_COPY_DATA                (1 << 0)
@@ -196,6 +458,7 @@ void close_file_for_pool(pool_t * const pool);
  * @flag POOL_ASSIGN_GENOME_POINTERS   (1 << 2)
  * @flag POOL_ASSIGN_METADATA_POINTERS (1 << 3)
  * @flag POOL_REWRITE_DESCRIPTION      (1 << 4)
+ * @flag POOL_COPY_DIRTY_DATA          (1 << 5)
  */
 typedef uint8_t save_pool_flag_t;
 #define POOL_COPY_DATA                (save_pool_flag_t)(1 << 0)
@@ -203,6 +466,8 @@ typedef uint8_t save_pool_flag_t;
 #define POOL_ASSIGN_GENOME_POINTERS   (save_pool_flag_t)(1 << 2)
 #define POOL_ASSIGN_METADATA_POINTERS (save_pool_flag_t)(1 << 3)
 #define POOL_REWRITE_DESCRIPTION      (save_pool_flag_t)(1 << 4)
+// Same as POOL_COPY_DATA, but only genomes with GENOME_DIRTY flag are copied.
+#define POOL_COPY_DIRTY_DATA          (save_pool_flag_t)(1 << 5)
 
 /* @function save_pool
  * @return void
@@ -212,12 +477,18 @@ typedef uint8_t save_pool_flag_t;
  */
 void save_pool(pool_t * const, genome_t ** const, save_pool_flag_t flags);
 
+void save_pool_to_memory(
+    pool_t * const, genome_t ** const, save_pool_flag_t flags,
+    void * const destination);
+
 /* @function read_pool
  * @return pool*
  * @argument char*
  */
 pool_t * read_pool(const char *address);
 
+pool_t * read_pool_from_memory(void * const data, const size_t size);
+
 /* @function write_pool
  * @return void
  * @argument char*
@@ -253,6 +524,10 @@ void free_genes_byte_array(gene_byte_t * const);
  */
 genome_t * read_next_genome(pool_t * const);
 
+genome_t * parse_genome(
+    const pool_t * const, void * const start, void ** const next,
+    err_status_t * const status);
+
 /* @function reset_genome_cursor
  * @return void
  * @argument pool*
@@ -266,6 +541,13 @@ void reset_genome_cursor(pool_t * const);
  */
 genome_t ** read_genomes(pool_t * const);
 
+/* @function read_genomes_parallel
+ * @return genome**
+ * @argument pool*
+ * @argument uint16
+ */
+genome_t ** read_genomes_parallel(pool_t * const, const uint16_t threads_number);
+
 /* @function free_genomes_ptrs
  * @return void
  * @argument genome**
@@ -8,6 +8,7 @@ contain any methods.
 #pragma once
 
 #include <stdint.h>
+#include <stddef.h>
 
 #include "files.h"
 
@@ -63,6 +64,9 @@ This number can be increased with maximizing the number of bits.
 
  */
 
+/* @typedef byte
+ * @from_type uint8
+ */
 typedef uint8_t byte_t;
 
 /* @typedef gene_byte
@@ -76,6 +80,8 @@ typedef uint8_t gene_byte_t;
 typedef uint64_t gene_node_id_t;
 typedef int64_t  gene_edge_weight_unnormalized_t;
 typedef double   gene_edge_weight;
+// weight decoded by decode_genes_float
+typedef float    gene_edge_weight_float;
 
 /* @struct gene
  * @member uint64 outcome_node_id
@@ -96,6 +102,16 @@ typedef struct gene_s {
     gene_edge_weight                 weight;
 } gene_t;
 
+/* @flags genome_flag
+ * @type uint8
+ * @flag GENOME_DIRTY (1 << 0)
+ */
+// GENOME_DIRTY means that data of the genome differs from its copy in the pool
+// file, so it should be written by the next save_pool with
+// POOL_COPY_DIRTY_DATA.
+typedef uint8_t genome_flag_t;
+#define GENOME_DIRTY (genome_flag_t)(1 << 0)
+
 typedef uint32_t genome_length_t;
 typedef uint16_t genome_metadata_size_t;
 typedef uint16_t genome_residue_size_t;
@@ -113,6 +129,7 @@ typedef uint16_t genome_residue_size_t;
  * @member uint8* genes
  * @member uint16 residue_size_bits
  * @member uint8* residue
+ * @member genome_flag flags
  */
 typedef struct genome_s {
     genome_length_t          length;
@@ -121,6 +138,7 @@ typedef struct genome_s {
     gene_byte_t             *genes;
     genome_residue_size_t    residue_size_bits;
     byte_t                  *residue;
+    genome_flag_t            flags;
 } genome_t;
 
 // 'pl' means 'pool'
@@ -131,6 +149,62 @@ typedef uint8_t    pool_gene_node_id_part_t;
 typedef uint8_t    pool_gene_weight_part_t;
 typedef uint8_t    pool_gene_byte_size_t;
 
+// Maximum number of separate ranges the tracker keeps. Once it's exceeded, the
+// new range is merged with the nearest one. The annotation of
+// pool_dirty_ranges repeats it.
+#define POOL_DIRTY_RANGES_CAPACITY 32
+
+/* @struct pool_dirty_range
+ * @member size start
+ * @member size end
+ */
+typedef struct pool_dirty_range_s {
+    // offsets from the start of the file mapping, `end` is exclusive
+    size_t start;
+    size_t end;
+} pool_dirty_range_t;
+
+/* @struct pool_dirty_ranges
+ * @member uint32 number
+ * @member uint64 unflushed_bytes
+ * @member pool_dirty_range[32] ranges
+ */
+typedef struct pool_dirty_ranges_s {
+    uint32_t            number;
+    uint64_t            unflushed_bytes;
+    pool_dirty_range_t  ranges[POOL_DIRTY_RANGES_CAPACITY];
+} pool_dirty_ranges_t;
+
+/* @struct pool_checksum_entry
+ * @member uint64 offset
+ * @member uint64 byte_size
+ * @member uint32 checksum
+ */
+typedef struct pool_checksum_entry_s {
+    // offset of the genome from the start of the pool dump
+    uint64_t  offset;
+    uint64_t  byte_size;
+    uint32_t  checksum;
+} pool_checksum_entry_t;
+
+/* @struct pool_checksums
+ * @member byte* base
+ * @member uint64 organisms_number
+ * @member uint32 description_checksum
+ * @member pool_checksum_entry* entries
+ * @member uint8* verified
+ */
+typedef struct pool_checksums_s {
+    // start of the pool dump the offsets are relative to
+    const byte_t           *base;
+    uint64_t                organisms_number;
+    uint32_t                description_checksum;
+    // sorted by offset
+    pool_checksum_entry_t  *entries;
+    // non-zero if the genome was already verified
+    uint8_t                *verified;
+} pool_checksums_t;
+
 /* @typedef pool_p
  * @from_type pool*
  */
@@ -146,6 +220,8 @@ typedef uint8_t    pool_gene_byte_size_t;
  * @member file_map file_mapping
  * @member uint8* first_genome_start_position
  * @member uint8* cursor
+ * @member pool_dirty_ranges* dirty_ranges
+ * @member pool_checksums* checksums
  */
 typedef struct pool_s {
     pool_organisms_num_t      organisms_number;
@@ -160,6 +236,10 @@ typedef struct pool_s {
     void                     *first_genome_start_position;
     // Position of the byte after POOL_META_TERMINAL_BYTE
     void                     *cursor;
+    // Parts of the writable file mapping which were not flushed yet
+    pool_dirty_ranges_t      *dirty_ranges;
+    // Checksums of genomes verified on access (see checksum.h), may be NULL
+    pool_checksums_t         *checksums;
 } pool_t;
 
 /* @typedef population_p
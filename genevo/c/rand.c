@@ -34,6 +34,7 @@ void set_xorshift128p_seed(uint32_t new_seed) {
 }
 
 uint64_t xorshift128p() {
+    PROBE_RANDOM_DRAW();
     uint64_t t = xorshift128p_rand_state.seed.x[0];
     uint64_t const s = xorshift128p_rand_state.seed.x[1];
     xorshift128p_rand_state.seed.x[0] = s;
@@ -45,6 +46,7 @@ uint64_t xorshift128p() {
 }
 
 uint32_t xorshift128p32() {
+    PROBE_RANDOM_DRAW();
     uint64_t t = xorshift128p_rand_state.seed.x[0];
     uint64_t const s = xorshift128p_rand_state.seed.x[1];
     xorshift128p_rand_state.seed.x[0] = s;
@@ -87,8 +89,45 @@ void set_lcg_seed(uint32_t new_seed) {
 }
 
 uint32_t lcg_rand() {
+    PROBE_RANDOM_DRAW();
     lcg_rand_state.seed = 214013 * lcg_rand_state.seed + 2531011;
-    return (lcg_rand_state.seed >> 16) & 0x7FFF;
+    return (lcg_rand_state.seed >> 16) & LCG_RAND_MAX;
+}
+
+/*
+
+Copy states of xorshift128p, LCG and Mersenne twister into `states`.
+
+ */
+void save_rng_states(rng_states_t * const states) {
+
+    states->xorshift128p[0] = xorshift128p_rand_state.seed.x[0];
+    states->xorshift128p[1] = xorshift128p_rand_state.seed.x[1];
+    states->lcg = lcg_rand_state.seed;
+
+    int mersenne_index;
+    mersenne_get_state(states->mersenne, &mersenne_index);
+    states->mersenne_index = mersenne_index;
+
+}
+
+/*
+
+Does the opposite to save_rng_states. All the generators are considered to be
+seeded after this call.
+
+ */
+void restore_rng_states(const rng_states_t * const states) {
+
+    xorshift128p_rand_state.seed.x[0] = states->xorshift128p[0];
+    xorshift128p_rand_state.seed.x[1] = states->xorshift128p[1];
+    xorshift128p_seed_initialized = true;
+
+    lcg_rand_state.seed = states->lcg;
+    lcg_seed_initialized = true;
+
+    mersenne_set_state(states->mersenne, states->mersenne_index);
+
 }
 
 /*
@@ -140,3 +179,77 @@ void fill_with_randomness(
     *(uint8_t *)destination = (uint8_t)next_urandom64() << (8 - bits);
 
 }
+
+/*
+
+Streams of xorshift128p
+===============================
+The state of a stream is made of the seed and the index of the stream by
+SplitMix64, which turns close inputs into unrelated states.
+
+*/
+
+#define SPLITMIX64_GAMMA 0x9E3779B97F4A7C15ULL
+
+static inline uint64_t splitmix64_mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void seed_xorshift128p_stream(
+    xorshift128p_stream_t * const stream,
+    const uint64_t seed, const uint64_t index
+) {
+
+    const uint64_t state = seed ^ splitmix64_mix(index);
+
+    stream->x[0] = splitmix64_mix(state + SPLITMIX64_GAMMA);
+    stream->x[1] = splitmix64_mix(state + SPLITMIX64_GAMMA * 2);
+
+    // xorshift128p never leaves the zero state
+    if (stream->x[0] == 0 && stream->x[1] == 0) stream->x[0] = 1;
+
+}
+
+#undef SPLITMIX64_GAMMA
+
+uint64_t next_xorshift128p_stream(xorshift128p_stream_t * const stream) {
+    PROBE_RANDOM_DRAW();
+    uint64_t t = stream->x[0];
+    uint64_t const s = stream->x[1];
+    stream->x[0] = s;
+    t ^= t << 23;       // a
+    t ^= t >> 18;       // b
+    t ^= s ^ (s >> 5);  // c
+    stream->x[1] = t;
+    return t + s;
+}
+
+void fill_with_stream_randomness(
+    xorshift128p_stream_t * const stream,
+    uint8_t * destination, uint32_t bytes, const uint8_t bits) {
+
+    // the state is copied, otherwise every store into the destination could
+    // change it, and the compiler would reload it for every number
+    xorshift128p_stream_t state = *stream;
+
+    for (; bytes >= 8; destination += 8, bytes -= 8) {
+        const uint64_t number = next_xorshift128p_stream(&state);
+        memcpy(destination, &number, 8);
+    }
+
+    // the rest of whole bytes is taken from one number
+    if (bytes > 0) {
+        const uint64_t number = next_xorshift128p_stream(&state);
+        memcpy(destination, &number, bytes);
+        destination += bytes;
+    }
+
+    *stream = state;
+
+    // partially fill one left byte
+    if (!bits) return;
+    *destination = (uint8_t)next_xorshift128p_stream(stream) << (8 - bits);
+
+}
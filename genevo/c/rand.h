@@ -4,10 +4,12 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 #include <math.h>
 
 #include "bit_manipulations.h"
 #include "mersenne.h"
+#include "instrumentation.h"
 
 // xorshift128p generator
 
@@ -30,18 +32,21 @@ uint32_t xorshift128p32() __attribute__((pure));
 #define MAP_RANGE_TO_RANGE(_X, _A1, _B1, _A2, _B2) \
     (((_X) - (_A1)) * ((_B2) - (_A2)) / ((_B1) - (_A1)) + (_A2))
 
+// Integer *_in_range generators return values from the half-open range [_A, _B)
+
 #define next_urandom64_in_range(_A, _B) ({                                     \
     double _A_ = (_A);                                                         \
     double _B_ = (_B);                                                         \
     double _R  = next_urandom32();                                             \
-    (uint64_t)roundl(MAP_RANGE_TO_RANGE(_R, 0, (double)MAX_FOR_32, _A, _B));   \
+    (uint64_t)floorl(                                                         \
+        MAP_RANGE_TO_RANGE(_R, 0, (double)MAX_FOR_32 + 1, _A_, _B_));          \
 })
 
 #define next_double_urandom64_in_range(_A, _B) ({                              \
     double _A_ = (_A);                                                         \
     double _B_ = (_B);                                                         \
     double _R  = next_urandom32();                                             \
-    MAP_RANGE_TO_RANGE(_R, 0, (double)MAX_FOR_32, _A, _B);                     \
+    MAP_RANGE_TO_RANGE(_R, 0, (double)MAX_FOR_32, _A_, _B_);                   \
 })
 
 // linear congruent generator
@@ -54,20 +59,24 @@ void set_lcg_seed(uint32_t);
 
 uint32_t lcg_rand() __attribute__((pure));
 
+// lcg_rand returns 15 bits only
+#define LCG_RAND_MAX 0x7FFF
+
 #define next_fast_random lcg_rand
 
 #define next_fast_random_in_range(_A, _B) ({                                   \
     double _A_ = (_A);                                                         \
     double _B_ = (_B);                                                         \
     double _R  = next_fast_random();                                           \
-    (uint32_t)roundl(MAP_RANGE_TO_RANGE(_R, 0, (double)MAX_FOR_32, _A, _B));   \
+    (uint32_t)floorl(                                                         \
+        MAP_RANGE_TO_RANGE(_R, 0, (double)LCG_RAND_MAX + 1, _A_, _B_));        \
 })
 
 #define next_double_fast_random_in_range(_A, _B) ({                            \
     double _A_ = (_A);                                                         \
     double _B_ = (_B);                                                         \
     double _R  = next_fast_random();                                           \
-    MAP_RANGE_TO_RANGE(_R, 0, (double)MAX_FOR_32, _A, _B);                     \
+    MAP_RANGE_TO_RANGE(_R, 0, (double)LCG_RAND_MAX, _A_, _B_);                 \
 })
 
 // Mersenne twister
@@ -80,16 +89,72 @@ extern bool mersenne_seed_initialized;
     double _A_ = (_A);                                                         \
     double _B_ = (_B);                                                         \
     double _R = mersenne_genrand64_int64() % MAX_FOR_32;                       \
-    (uint64_t)roundl(MAP_RANGE_TO_RANGE(_R, 0, (double)MAX_FOR_32, _A, _B));   \
+    (uint64_t)floorl(                                                         \
+        MAP_RANGE_TO_RANGE(_R, 0, (double)MAX_FOR_32 + 1, _A_, _B_));          \
 })
 
 #define next_double_mersenne_random64_in_range(_A, _B) ({                      \
     double _A_ = (_A);                                                         \
     double _B_ = (_B);                                                         \
     double _R = mersenne_genrand64_int64() % MAX_FOR_32;                       \
-    MAP_RANGE_TO_RANGE(_R, 0, (double)MAX_FOR_32, _A, _B);                     \
+    MAP_RANGE_TO_RANGE(_R, 0, (double)MAX_FOR_32, _A_, _B_);                   \
+})
+
+// States of all the generators
+
+/*
+
+Snapshot of every generator used across the library. It can be saved before
+some long computation and restored later, so the same random sequences will be
+produced again (see checkpoint.h).
+
+ */
+typedef struct rng_states_s {
+    uint64_t           xorshift128p[2];
+    uint32_t           lcg;
+    int32_t            mersenne_index;
+    unsigned long long mersenne[MERSENNE_STATE_SIZE];
+} rng_states_t;
+
+void save_rng_states(rng_states_t * const);
+void restore_rng_states(const rng_states_t * const);
+
+// Streams of xorshift128p
+
+/*
+
+Private state of xorshift128p. Every thread draws numbers from its own stream,
+so threads never touch the shared state of xorshift128p and never wait for
+each other. Streams made by seed_xorshift128p_stream from the same seed and
+different indices are independent, and the numbers depend only on the seed and
+the index, not on the thread drawing them.
+
+ */
+typedef struct xorshift128p_stream_s {
+    uint64_t x[2];
+} xorshift128p_stream_t;
+
+void seed_xorshift128p_stream(
+    xorshift128p_stream_t * const, const uint64_t seed, const uint64_t index);
+
+uint64_t next_xorshift128p_stream(xorshift128p_stream_t * const);
+
+// Number of range [0; 1) drawn from `_STREAM`
+#define next_double_stream_random(_STREAM)                                     \
+    ((next_xorshift128p_stream(_STREAM) >> 11) * (1.0 / 9007199254740992.0))
+
+// Same as next_urandom64_in_range, but the number is drawn from `_STREAM`
+#define next_stream_random64_in_range(_STREAM, _A, _B) ({                      \
+    double _A_ = (_A);                                                         \
+    double _B_ = (_B);                                                         \
+    (uint64_t)floorl(_A_ + next_double_stream_random(_STREAM) * (_B_ - _A_));  \
 })
 
+// Same as fill_with_randomness, but numbers are drawn from `stream`
+void fill_with_stream_randomness(
+    xorshift128p_stream_t * const stream,
+    uint8_t *destination, uint32_t bytes, const uint8_t bits);
+
 // ...other functions
 
 #define fill_bytes_with_randomness(_DESTINATION, _BYTES)                       \
@@ -0,0 +1,457 @@
+/*
+
+This module contains methods for writing and reading sharded pools.
+
+ */
+
+#include "shards.h"
+
+/*
+
+Return newly allocated address of the shard. Relative `shard_address` of
+`shard_address_size` bytes is resolved from the directory of the manifest.
+
+ */
+char * resolve_shard_address(
+    const char *manifest_address,
+    const char *shard_address, const size_t shard_address_size
+) {
+
+    const char * const slash = strrchr(manifest_address, '/');
+    const size_t directory_size =
+        shard_address_size > 0 && shard_address[0] != '/' && slash != NULL
+            ? (size_t)(slash - manifest_address) + 1
+            : 0;
+
+    DECLARE_MALLOC_ARRAY(
+        char, address, directory_size + shard_address_size + 1,
+        RETURN_NULL_ON_ERR);
+
+    memcpy(address, manifest_address, directory_size);
+    memcpy(address + directory_size, shard_address, shard_address_size);
+    address[directory_size + shard_address_size] = '\0';
+
+    return address;
+
+}
+
+/*
+
+Write the manifest of `shards_number` shards. `sample` gives the description
+of the pool (organisms number is summed from `organisms_numbers`). Shard files
+themselves are not touched, so they can be written separately by their own
+processes with write_pool.
+
+ */
+void write_pool_manifest(
+    const char *address, const pool_t * const sample,
+    const uint32_t shards_number, char ** const shard_addresses,
+    const pool_organisms_num_t * const organisms_numbers
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (shards_number == 0) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
+
+    size_t file_size =
+        sizeof(pool_manifest_file_preamble_t) +
+        sizeof(POOL_MANIFEST_TERMINAL_BYTE);
+
+    for (uint32_t shard_i = 0; shard_i < shards_number; shard_i++) {
+        const size_t address_size = strlen(shard_addresses[shard_i]);
+        if (address_size == 0 || address_size > UINT16_MAX) {
+            ERROR_LEVEL = ERR_WRONG_PARAMS;
+            return;
+        }
+        file_size += sizeof(pool_manifest_file_shard_t) + address_size;
+    }
+
+    // open_file maps one byte less than it writes into the stretched file
+    file_map_t * const mapping =
+        open_file(address, OPEN_MODE_WRITE, file_size - 1);
+    if (ERROR_LEVEL == ERR_OK) resize_file(mapping, file_size);
+    if (ERROR_LEVEL != ERR_OK) {
+        const err_status_t status = ERROR_LEVEL;
+        if (mapping != NULL) close_file(mapping);
+        ERROR_LEVEL = status;
+        return;
+    }
+
+    pool_manifest_file_preamble_t * const preamble = mapping->data;
+    preamble->initial_byte = POOL_MANIFEST_INITIAL_BYTE;
+    preamble->version = POOL_MANIFEST_FORMAT_VERSION;
+    COPY_MEMBER_HTON(input_neurons_number,  sample, preamble);
+    COPY_MEMBER_HTON(output_neurons_number, sample, preamble);
+    COPY_MEMBER     (node_id_part_bit_size, sample, preamble);
+    COPY_MEMBER     (weight_part_bit_size,  sample, preamble);
+    preamble->shards_number = HTON(shards_number);
+    preamble->table_byte = POOL_MANIFEST_TABLE_BYTE;
+
+    byte_t *writer = (byte_t *)(preamble + 1);
+    pool_organisms_num_t first_organism = 0;
+
+    for (uint32_t shard_i = 0; shard_i < shards_number; shard_i++) {
+
+        const uint16_t address_size = strlen(shard_addresses[shard_i]);
+
+        pool_manifest_file_shard_t * const record = (void *)writer;
+        record->first_organism = HTON(first_organism);
+        record->organisms_number = HTON(organisms_numbers[shard_i]);
+        record->address_byte_size = HTON(address_size);
+        writer += sizeof(pool_manifest_file_shard_t);
+
+        memcpy(writer, shard_addresses[shard_i], address_size);
+        writer += address_size;
+
+        first_organism += organisms_numbers[shard_i];
+
+    }
+
+    preamble->organisms_number = HTON(first_organism);
+    *writer = POOL_MANIFEST_TERMINAL_BYTE;
+
+    close_file(mapping);
+
+}
+
+/*
+
+Split the population into `shards_number` contiguous ranges of nearly the same
+size, write every range into its own pool file and write the manifest at
+`address`. If `shard_addresses` is NULL, shards are placed next to the
+manifest and named `<address>.<shard index>`.
+
+ */
+void write_sharded_pool(
+    const char *address, pool_t * const pool, genome_t ** const genomes,
+    const uint32_t shards_number, char ** const shard_addresses
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (shards_number == 0 || shards_number > pool->organisms_number) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
+
+    char ** const addresses = calloc(shards_number, sizeof(char *));
+    pool_organisms_num_t * const organisms_numbers =
+        malloc(sizeof(pool_organisms_num_t) * shards_number);
+
+    #define SHARDS_FAIL(_ERR) {                                                \
+        const err_status_t _STATUS_ = (_ERR);                                  \
+        if (shard_addresses == NULL && addresses != NULL)                      \
+            for (uint32_t _I_ = 0; _I_ < shards_number; _I_++)                 \
+                FREE_NOT_NULL(addresses[_I_]);                                 \
+        FREE_NOT_NULL(addresses);                                              \
+        FREE_NOT_NULL(organisms_numbers);                                      \
+        ERROR_LEVEL = _STATUS_;                                                \
+        return; }
+
+    if (addresses == NULL || organisms_numbers == NULL)
+        SHARDS_FAIL(ERR_CANNOT_MALLOC);
+
+    const char * const slash = strrchr(address, '/');
+    const char * const manifest_name = slash != NULL ? slash + 1 : address;
+
+    pool_organisms_num_t first_organism = 0;
+
+    for (uint32_t shard_i = 0; shard_i < shards_number; shard_i++) {
+
+        organisms_numbers[shard_i] =
+            pool->organisms_number / shards_number +
+            (shard_i < pool->organisms_number % shards_number ? 1 : 0);
+
+        char *shard_path;
+
+        if (shard_addresses != NULL) {
+            addresses[shard_i] = shard_addresses[shard_i];
+            shard_path = resolve_shard_address(
+                address, addresses[shard_i], strlen(addresses[shard_i]));
+        } else {
+            // stored address is relative to the manifest
+            const int name_size =
+                snprintf(NULL, 0, "%s.%u", manifest_name, shard_i);
+            addresses[shard_i] = malloc(name_size + 1);
+            if (addresses[shard_i] == NULL) SHARDS_FAIL(ERR_CANNOT_MALLOC);
+            snprintf(
+                addresses[shard_i], name_size + 1,
+                "%s.%u", manifest_name, shard_i);
+            shard_path = resolve_shard_address(
+                address, addresses[shard_i], name_size);
+        }
+
+        if (shard_path == NULL) SHARDS_FAIL(ERR_CANNOT_MALLOC);
+
+        // the shard is the same pool limited to its range of organisms
+        pool_t shard = *pool;
+        shard.organisms_number = organisms_numbers[shard_i];
+        shard.file_mapping = NULL;
+        shard.dirty_ranges = NULL;
+        shard.checksums = NULL;
+
+        write_pool(shard_path, &shard, genomes + first_organism);
+        free(shard_path);
+        if (ERROR_LEVEL != ERR_OK) SHARDS_FAIL(ERROR_LEVEL);
+
+        first_organism += organisms_numbers[shard_i];
+
+    }
+
+    write_pool_manifest(
+        address, pool, shards_number, addresses, organisms_numbers);
+
+    // frees everything keeping ERROR_LEVEL of write_pool_manifest
+    SHARDS_FAIL(ERROR_LEVEL);
+
+    #undef SHARDS_FAIL
+
+}
+
+#define MANIFEST_FAIL_CONDITION(_CONDITION, _ERR_CONST)                        \
+    if (_CONDITION) {                                                          \
+        close_file(mapping); close_sharded_pool(sharded);                      \
+        ERROR_LEVEL = (_ERR_CONST);                                            \
+        return NULL; }
+
+/*
+
+Read the manifest. Shards are not opened until open_pool_shard is called.
+
+ */
+sharded_pool_t * open_sharded_pool(const char *address) {
+
+    file_map_t * const mapping = open_file(address, OPEN_MODE_READ, 0);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    sharded_pool_t * const sharded = calloc(1, sizeof(sharded_pool_t));
+    if (sharded == NULL) {
+        close_file(mapping);
+        RAISE_MALLOC_ERR(RETURN_NULL_ON_ERR);
+    }
+
+    MANIFEST_FAIL_CONDITION(
+        mapping->size <
+            sizeof(pool_manifest_file_preamble_t) +
+            sizeof(POOL_MANIFEST_TERMINAL_BYTE),
+        ERR_MANIFEST_CORRUPT_START);
+
+    const pool_manifest_file_preamble_t * const preamble = mapping->data;
+
+    MANIFEST_FAIL_CONDITION(
+        preamble->initial_byte != POOL_MANIFEST_INITIAL_BYTE,
+        ERR_MANIFEST_CORRUPT_START);
+
+    MANIFEST_FAIL_CONDITION(
+        preamble->version != POOL_MANIFEST_FORMAT_VERSION,
+        ERR_MANIFEST_WRONG_VERSION);
+
+    MANIFEST_FAIL_CONDITION(
+        preamble->table_byte != POOL_MANIFEST_TABLE_BYTE,
+        ERR_MANIFEST_CORRUPT_TABLE);
+
+    COPY_MEMBER_NTOH(organisms_number,      preamble, sharded);
+    COPY_MEMBER_NTOH(input_neurons_number,  preamble, sharded);
+    COPY_MEMBER_NTOH(output_neurons_number, preamble, sharded);
+    COPY_MEMBER     (node_id_part_bit_size, preamble, sharded);
+    COPY_MEMBER     (weight_part_bit_size,  preamble, sharded);
+
+    const uint32_t shards_number = NTOH(preamble->shards_number);
+    const byte_t * const end =
+        (byte_t *)mapping->data + mapping->size -
+        sizeof(POOL_MANIFEST_TERMINAL_BYTE);
+
+    MANIFEST_FAIL_CONDITION(
+        shards_number == 0 ||
+        shards_number >
+            (size_t)(end - (byte_t *)(preamble + 1)) /
+            sizeof(pool_manifest_file_shard_t),
+        ERR_MANIFEST_CORRUPT_TABLE);
+
+    sharded->shards = calloc(shards_number, sizeof(pool_shard_t));
+    MANIFEST_FAIL_CONDITION(sharded->shards == NULL, ERR_CANNOT_MALLOC);
+    sharded->shards_number = shards_number;
+
+    const byte_t *reader = (byte_t *)(preamble + 1);
+    pool_organisms_num_t next_organism = 0;
+
+    for (uint32_t shard_i = 0; shard_i < shards_number; shard_i++) {
+
+        MANIFEST_FAIL_CONDITION(
+            (size_t)(end - reader) < sizeof(pool_manifest_file_shard_t),
+            ERR_MANIFEST_CORRUPT_TABLE);
+
+        const pool_manifest_file_shard_t * const record = (void *)reader;
+        pool_shard_t * const shard = &sharded->shards[shard_i];
+        COPY_MEMBER_NTOH(first_organism,   record, shard);
+        COPY_MEMBER_NTOH(organisms_number, record, shard);
+        const uint16_t address_size = NTOH(record->address_byte_size);
+        reader += sizeof(pool_manifest_file_shard_t);
+
+        MANIFEST_FAIL_CONDITION(
+            shard->first_organism != next_organism ||
+            address_size == 0 ||
+            (size_t)(end - reader) < address_size,
+            ERR_MANIFEST_CORRUPT_TABLE);
+
+        shard->address =
+            resolve_shard_address(address, (const char *)reader, address_size);
+        MANIFEST_FAIL_CONDITION(shard->address == NULL, ERR_CANNOT_MALLOC);
+        reader += address_size;
+
+        next_organism += shard->organisms_number;
+
+    }
+
+    MANIFEST_FAIL_CONDITION(
+        reader != end ||
+        *end != POOL_MANIFEST_TERMINAL_BYTE ||
+        next_organism != sharded->organisms_number,
+        ERR_MANIFEST_CORRUPT_TABLE);
+
+    close_file(mapping);
+
+    return sharded;
+
+}
+
+#undef MANIFEST_FAIL_CONDITION
+
+/*
+
+Open the shard for reading if it was not opened yet. The shard is checked to
+match its description in the manifest.
+
+ */
+pool_t * open_pool_shard(
+    sharded_pool_t * const sharded, const uint32_t shard_index
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (shard_index >= sharded->shards_number) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return NULL;
+    }
+
+    pool_shard_t * const shard = &sharded->shards[shard_index];
+    if (shard->pool != NULL) return shard->pool;
+
+    pool_t * const pool = read_pool(shard->address);
+    if (ERROR_LEVEL != ERR_OK) return NULL;
+
+    if (
+        pool->organisms_number != shard->organisms_number ||
+        pool->input_neurons_number != sharded->input_neurons_number ||
+        pool->output_neurons_number != sharded->output_neurons_number ||
+        pool->node_id_part_bit_size != sharded->node_id_part_bit_size ||
+        pool->weight_part_bit_size != sharded->weight_part_bit_size
+    ) {
+        close_pool(pool);
+        ERROR_LEVEL = ERR_SHARD_MISMATCH;
+        return NULL;
+    }
+
+    shard->pool = pool;
+
+    return pool;
+
+}
+
+/*
+
+Return index of the shard holding organism with given index.
+
+ */
+uint32_t find_pool_shard(
+    const sharded_pool_t * const sharded,
+    const pool_organisms_num_t organism_index
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (organism_index >= sharded->organisms_number) {
+        ERROR_LEVEL = ERR_SHARD_NO_ORGANISM;
+        return 0;
+    }
+
+    // last shard with first_organism <= organism_index
+    uint32_t low = 0, high = sharded->shards_number;
+    while (high - low > 1) {
+        const uint32_t middle = low + (high - low) / 2;
+        if (sharded->shards[middle].first_organism <= organism_index)
+            low = middle;
+        else
+            high = middle;
+    }
+
+    return low;
+
+}
+
+/*
+
+Open all the shards and return genomes of the whole pool, same as read_genomes
+does for a single pool. Genomes point into mappings of the shards, so they are
+valid until the sharded pool is closed. Every shard is parsed by
+read_genomes_parallel with `threads_number` threads.
+
+ */
+genome_t ** read_sharded_genomes(
+    sharded_pool_t * const sharded, const uint16_t threads_number
+) {
+
+    // an empty pool still gets a vector, since NULL means an error here
+    DECLARE_MALLOC_LINKS_ARRAY(
+        genome_t, genomes,
+        (sharded->organisms_number > 0 ? sharded->organisms_number : 1),
+        RETURN_NULL_ON_ERR);
+
+    for (uint32_t shard_i = 0; shard_i < sharded->shards_number; shard_i++) {
+
+        const pool_shard_t * const shard = &sharded->shards[shard_i];
+        pool_t * const pool = open_pool_shard(sharded, shard_i);
+
+        genome_t ** const shard_genomes =
+            pool != NULL ? read_genomes_parallel(pool, threads_number) : NULL;
+
+        if (shard_genomes == NULL) {
+            const err_status_t status = ERROR_LEVEL;
+            for (
+                pool_organisms_num_t genome_i = 0;
+                genome_i < shard->first_organism;
+                genome_i++
+            )
+                free(genomes[genome_i]);
+            free(genomes);
+            ERROR_LEVEL = status;
+            return NULL;
+        }
+
+        memcpy(
+            genomes + shard->first_organism, shard_genomes,
+            sizeof(genome_t *) * shard->organisms_number);
+        free_genomes_ptrs(shard_genomes);
+
+    }
+
+    return genomes;
+
+}
+
+void close_sharded_pool(sharded_pool_t * const sharded) {
+
+    if (sharded->shards != NULL)
+        for (uint32_t shard_i = 0; shard_i < sharded->shards_number; shard_i++) {
+            pool_shard_t * const shard = &sharded->shards[shard_i];
+            FREE_NOT_NULL(shard->address);
+            if (shard->pool != NULL) close_pool(shard->pool);
+        }
+
+    FREE_NOT_NULL(sharded->shards);
+    free(sharded);
+
+}
@@ -0,0 +1,176 @@
+/*
+
+This module contains methods for pools split across several files. A small
+manifest file lists the shards, and every shard is a valid pool file
+(pickler.h) holding a contiguous range of organisms. Shards can be read and
+written by different processes at the same time and placed on different
+disks.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "pool.h"
+#include "error.h"
+#include "files.h"
+#include "types.h"
+#include "memory.h"
+#include "pickler.h"
+
+#define POOL_MANIFEST_FORMAT_VERSION     (uint8_t)1
+
+#define POOL_MANIFEST_INITIAL_BYTE       (file_control_byte_t)0xB8
+#define POOL_MANIFEST_TABLE_BYTE         (file_control_byte_t)0xB9
+#define POOL_MANIFEST_TERMINAL_BYTE      (file_control_byte_t)0xBA
+
+/*
+
+Structure of the manifest file is the following (network byte order is used
+for all the numbers):
+
+Content                               Size (bits)  Note
+----------                            ----------   ----------
+POOL_MANIFEST_INITIAL_BYTE            8
+[format version]                      8
+[number of organisms]                 64           In all the shards
+[number of input neurons]             64
+[number of output neurons]            64
+[bit size of node id part]            8
+[bit size of weight part]             8
+[number of shards = S]                32
+POOL_MANIFEST_TABLE_BYTE              8
+[shards]                              ...          S times
+POOL_MANIFEST_TERMINAL_BYTE           8
+
+Every shard is:
+
+[index of the first organism]         64
+[number of organisms]                 64
+[size of the address = ASB]           16
+[address of the shard file]           ASb          Without terminating zero
+
+Relative addresses are resolved from the directory of the manifest, so the
+manifest can be moved together with its shards.
+
+ */
+
+typedef struct pool_manifest_file_preamble_s {
+    file_control_byte_t       initial_byte;
+    uint8_t                   version;
+    pool_organisms_num_t      organisms_number;
+    pool_neurons_num_t        input_neurons_number;
+    pool_neurons_num_t        output_neurons_number;
+    pool_gene_node_id_part_t  node_id_part_bit_size;
+    pool_gene_weight_part_t   weight_part_bit_size;
+    uint32_t                  shards_number;
+    file_control_byte_t       table_byte;
+} __attribute__((packed, aligned(1))) pool_manifest_file_preamble_t;
+
+typedef struct pool_manifest_file_shard_s {
+    pool_organisms_num_t      first_organism;
+    pool_organisms_num_t      organisms_number;
+    uint16_t                  address_byte_size;
+} __attribute__((packed, aligned(1))) pool_manifest_file_shard_t;
+
+/* @struct pool_shard
+ * @member char* address
+ * @member uint64 first_organism
+ * @member uint64 organisms_number
+ * @member pool* pool
+ */
+typedef struct pool_shard_s {
+    // Resolved address of the shard file
+    char                     *address;
+    pool_organisms_num_t      first_organism;
+    pool_organisms_num_t      organisms_number;
+    // NULL until the shard is opened with open_pool_shard
+    pool_t                   *pool;
+} pool_shard_t;
+
+/* @typedef sharded_pool_p
+ * @from_type sharded_pool*
+ */
+/* @struct sharded_pool
+ * @member uint64 organisms_number
+ * @member uint64 input_neurons_number
+ * @member uint64 output_neurons_number
+ * @member uint8 node_id_part_bit_size
+ * @member uint8 weight_part_bit_size
+ * @member uint32 shards_number
+ * @member pool_shard* shards
+ */
+typedef struct sharded_pool_s {
+    pool_organisms_num_t      organisms_number;
+    pool_neurons_num_t        input_neurons_number;
+    pool_neurons_num_t        output_neurons_number;
+    pool_gene_node_id_part_t  node_id_part_bit_size;
+    pool_gene_weight_part_t   weight_part_bit_size;
+    uint32_t                  shards_number;
+    pool_shard_t             *shards;
+} sharded_pool_t;
+
+/* @function write_pool_manifest
+ * @return void
+ * @argument char*
+ * @argument pool*
+ * @argument uint32
+ * @argument char**
+ * @argument uint64*
+ */
+void write_pool_manifest(
+    const char *address, const pool_t * const sample,
+    const uint32_t shards_number, char ** const shard_addresses,
+    const pool_organisms_num_t * const organisms_numbers);
+
+/* @function write_sharded_pool
+ * @return void
+ * @argument char*
+ * @argument pool*
+ * @argument genome**
+ * @argument uint32
+ * @argument char**
+ */
+void write_sharded_pool(
+    const char *address, pool_t * const, genome_t ** const,
+    const uint32_t shards_number, char ** const shard_addresses);
+
+/* @function open_sharded_pool
+ * @return sharded_pool*
+ * @argument char*
+ */
+sharded_pool_t * open_sharded_pool(const char *address);
+
+/* @function open_pool_shard
+ * @return pool*
+ * @argument sharded_pool*
+ * @argument uint32
+ */
+pool_t * open_pool_shard(sharded_pool_t * const, const uint32_t shard_index);
+
+/* @function find_pool_shard
+ * @return uint32
+ * @argument sharded_pool*
+ * @argument uint64
+ */
+uint32_t find_pool_shard(
+    const sharded_pool_t * const, const pool_organisms_num_t organism_index);
+
+/* @function read_sharded_genomes
+ * @return genome**
+ * @argument sharded_pool*
+ * @argument uint16
+ */
+genome_t ** read_sharded_genomes(
+    sharded_pool_t * const, const uint16_t threads_number);
+
+/* @function close_sharded_pool
+ * @return void
+ * @argument sharded_pool*
+ */
+void close_sharded_pool(sharded_pool_t * const);
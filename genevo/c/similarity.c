@@ -0,0 +1,424 @@
+/*
+
+This module contains MinHash signatures of genomes and the LSH index over
+them.
+
+ */
+
+#include "similarity.h"
+
+#define MIX_64(_X) ({                                                          \
+    uint64_t _Z_ = (_X);                                                       \
+    _Z_ = (_Z_ ^ (_Z_ >> 30)) * 0xBF58476D1CE4E5B9ULL;                         \
+    _Z_ = (_Z_ ^ (_Z_ >> 27)) * 0x94D049BB133111EBULL;                         \
+    _Z_ ^ (_Z_ >> 31);                                                         \
+})
+
+#define MINHASH_SEED_STEP 0x9E3779B97F4A7C15ULL
+
+/*
+
+Signature item `i` is the minimum of hash function `i` over all the edges.
+Hash functions are made of the hash of the edge mixed with different seeds.
+Edge is defined by its nodes (with their types), so the weight is ignored.
+
+ */
+void minhash_genome(
+    const pool_t * const pool, const genome_t * const genome,
+    const uint32_t signature_size, uint64_t * const signature
+) {
+
+    gene_node_id_t outcome_node_ids[MINHASH_CHUNK_SIZE],
+                   income_node_ids[MINHASH_CHUNK_SIZE];
+    gene_connection_flag_t connection_types[MINHASH_CHUNK_SIZE];
+
+    for (uint32_t item = 0; item < signature_size; item++)
+        signature[item] = MINHASH_EMPTY;
+
+    for (
+        genome_length_t chunk_start = 0;
+        chunk_start < genome->length;
+        chunk_start += MINHASH_CHUNK_SIZE
+    ) {
+
+        const genome_length_t chunk_size =
+            genome->length - chunk_start < MINHASH_CHUNK_SIZE
+                ? genome->length - chunk_start : MINHASH_CHUNK_SIZE;
+
+        decode_genes(
+            pool,
+            genome->genes + (size_t)chunk_start * pool->gene_bytes_size,
+            chunk_size,
+            outcome_node_ids, income_node_ids, connection_types,
+            NULL, NULL);
+
+        for (genome_length_t gene_i = 0; gene_i < chunk_size; gene_i++) {
+
+            const uint64_t edge = MIX_64(
+                MIX_64(outcome_node_ids[gene_i] ^
+                       (uint64_t)connection_types[gene_i] << 56) ^
+                income_node_ids[gene_i]);
+
+            for (uint32_t item = 0; item < signature_size; item++) {
+                const uint64_t hash =
+                    MIX_64(edge + MINHASH_SEED_STEP * (item + 1));
+                if (hash < signature[item]) signature[item] = hash;
+            }
+
+        }
+
+    }
+
+}
+
+typedef struct minhash_job_s {
+    const pool_t      *pool;
+    genome_t * const  *genomes;
+    uint32_t           signature_size;
+    uint64_t          *signatures;
+} minhash_job_t;
+
+void minhash_population_body(
+    void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+    const minhash_job_t * const job = job_void;
+
+    for (uint64_t genome_i = start; genome_i < end; genome_i++)
+        minhash_genome(
+            job->pool, job->genomes[genome_i], job->signature_size,
+            job->signatures + genome_i * job->signature_size);
+
+}
+
+/*
+
+Write signatures of all the genomes one after another into `signatures`
+(organisms_number x signature_size items).
+
+ */
+void minhash_population(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint32_t signature_size, uint64_t * const signatures,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (pool->node_id_part_bit_size > 64) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
+
+    minhash_job_t job = {
+        .pool = pool,
+        .genomes = genomes,
+        .signature_size = signature_size,
+        .signatures = signatures
+    };
+
+    parallel_for(
+        organisms_number, threads_number,
+        minhash_population_body, &job);
+
+}
+
+int compare_lsh_entries(const void *a_void, const void *b_void) {
+
+    const lsh_entry_t * const a = a_void, * const b = b_void;
+
+    if (a->band_hash != b->band_hash)
+        return a->band_hash < b->band_hash ? -1 : 1;
+    return (a->organism > b->organism) - (a->organism < b->organism);
+
+}
+
+void build_lsh_bands_body(
+    void * const index_void, const uint64_t start, const uint64_t end
+) {
+
+    lsh_index_t * const index = index_void;
+    const uint64_t n = index->organisms_number;
+
+    for (uint64_t band = start; band < end; band++) {
+
+        lsh_entry_t * const entries = index->entries + band * n;
+
+        for (uint64_t organism = 0; organism < n; organism++) {
+            const uint64_t band_hash = hash_bytes(
+                band,
+                (const byte_t *)(
+                    index->signatures + organism * index->signature_size +
+                    band * index->rows_number),
+                sizeof(uint64_t) * index->rows_number);
+            index->band_hashes[organism * index->bands_number + band] =
+                band_hash;
+            entries[organism].band_hash = band_hash;
+            entries[organism].organism = organism;
+        }
+
+        qsort(entries, n, sizeof(lsh_entry_t), compare_lsh_entries);
+
+    }
+
+}
+
+/*
+
+Build the index of `bands_number` bands over signatures of `signature_size`
+items. More rows in a band (fewer bands) make the index find only the most
+similar genomes.
+
+ */
+lsh_index_t * build_lsh_index(
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint32_t signature_size, const uint32_t bands_number,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (bands_number == 0 || signature_size < bands_number) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return NULL;
+    }
+
+    DECLARE_CONST_MALLOC_OBJECT(lsh_index_t, index, RETURN_NULL_ON_ERR);
+
+    index->signature_size = signature_size;
+    index->bands_number = bands_number;
+    index->rows_number = signature_size / bands_number;
+    index->organisms_number = organisms_number;
+
+    index->signatures = malloc(
+        sizeof(uint64_t) * organisms_number * signature_size);
+    index->band_hashes = malloc(
+        sizeof(uint64_t) * organisms_number * bands_number);
+    index->entries = malloc(
+        sizeof(lsh_entry_t) * organisms_number * bands_number);
+
+    // arrays of an empty population may be NULL
+    if (organisms_number > 0 &&
+        (index->signatures == NULL ||
+         index->band_hashes == NULL ||
+         index->entries == NULL))
+        DESTROY_AND_EXIT(destroy_lsh_index, index, RETURN_NULL_ON_ERR);
+
+    minhash_population(
+        pool, genomes, organisms_number, signature_size, index->signatures,
+        threads_number);
+    if (ERROR_LEVEL != ERR_OK) {
+        destroy_lsh_index(index);
+        return NULL;
+    }
+
+    parallel_for(
+        bands_number, threads_number,
+        build_lsh_bands_body, index);
+
+    return index;
+
+}
+
+/*
+
+Estimate of the Jaccard index of edge sets of organisms `a` and `b`.
+
+ */
+double minhash_similarity(
+    const lsh_index_t * const index, const uint64_t a, const uint64_t b
+) {
+
+    const uint64_t * const signature_a =
+        index->signatures + a * index->signature_size;
+    const uint64_t * const signature_b =
+        index->signatures + b * index->signature_size;
+
+    uint32_t equal_items = 0;
+    for (uint32_t item = 0; item < index->signature_size; item++)
+        equal_items += signature_a[item] == signature_b[item];
+
+    return (double)equal_items / index->signature_size;
+
+}
+
+/*
+
+Index of the first entry of the bucket with `band_hash` in the sorted band.
+
+ */
+uint64_t find_lsh_bucket(
+    const lsh_entry_t * const entries, const uint64_t entries_number,
+    const uint64_t band_hash
+) {
+
+    uint64_t low = 0, high = entries_number;
+
+    while (low < high) {
+        const uint64_t middle = low + (high - low) / 2;
+        if (entries[middle].band_hash < band_hash) low = middle + 1;
+        else high = middle;
+    }
+
+    return low;
+
+}
+
+int compare_organisms(const void *a_void, const void *b_void) {
+    const uint64_t a = *(const uint64_t *)a_void,
+                   b = *(const uint64_t *)b_void;
+    return (a > b) - (a < b);
+}
+
+/*
+
+Find organisms sharing at least one bucket with `organism`. At most `capacity`
+of them are written into `candidates` in ascending order, and the number of
+all the candidates is returned, so the call can be repeated with a bigger
+array.
+
+ */
+uint64_t lsh_query(
+    const lsh_index_t * const index, const uint64_t organism,
+    uint64_t * const candidates, const uint64_t capacity
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    const uint64_t n = index->organisms_number;
+
+    #ifndef SKIP_CHECK_BOUNDS
+    if (organism >= n) {
+        ERROR_LEVEL = ERR_OUT_OF_BOUNDS;
+        return 0;
+    }
+    #endif
+
+    uint64_t found_number = 0, found_capacity = 16;
+    uint64_t *found = malloc(sizeof(uint64_t) * found_capacity);
+    if (found == NULL) RAISE_MALLOC_ERR(RETURN_ZERO_ON_ERR);
+
+    for (uint32_t band = 0; band < index->bands_number; band++) {
+
+        const lsh_entry_t * const entries = index->entries + band * n;
+        const uint64_t band_hash =
+            index->band_hashes[organism * index->bands_number + band];
+
+        for (
+            uint64_t entry_i = find_lsh_bucket(entries, n, band_hash);
+            entry_i < n && entries[entry_i].band_hash == band_hash;
+            entry_i++
+        ) {
+
+            if (entries[entry_i].organism == organism) continue;
+
+            if (found_number == found_capacity) {
+                found_capacity *= 2;
+                uint64_t * const grown =
+                    realloc(found, sizeof(uint64_t) * found_capacity);
+                if (grown == NULL) {
+                    free(found);
+                    RAISE_MALLOC_ERR(RETURN_ZERO_ON_ERR);
+                }
+                found = grown;
+            }
+
+            found[found_number++] = entries[entry_i].organism;
+
+        }
+
+    }
+
+    qsort(found, found_number, sizeof(uint64_t), compare_organisms);
+
+    uint64_t unique_number = 0;
+    for (uint64_t found_i = 0; found_i < found_number; found_i++) {
+        if (found_i > 0 && found[found_i] == found[found_i - 1]) continue;
+        if (unique_number < capacity)
+            candidates[unique_number] = found[found_i];
+        unique_number++;
+    }
+
+    free(found);
+
+    return unique_number;
+
+}
+
+/*
+
+Find all the pairs of organisms sharing a bucket whose estimated similarity is
+at least `threshold`. Every pair is reported once as two items of `pairs`
+(the smaller index goes first). At most `capacity` pairs are written, and the
+number of all the found pairs is returned.
+
+ */
+uint64_t lsh_similar_pairs(
+    const lsh_index_t * const index, const double threshold,
+    uint64_t * const pairs, const uint64_t capacity
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    const uint64_t n = index->organisms_number;
+    uint64_t pairs_number = 0;
+
+    for (uint32_t band = 0; band < index->bands_number; band++) {
+
+        const lsh_entry_t * const entries = index->entries + band * n;
+
+        for (uint64_t bucket_start = 0, bucket_end; bucket_start < n;
+             bucket_start = bucket_end) {
+
+            bucket_end = bucket_start + 1;
+            while (bucket_end < n &&
+                   entries[bucket_end].band_hash ==
+                   entries[bucket_start].band_hash)
+                bucket_end++;
+
+            for (uint64_t first = bucket_start; first < bucket_end; first++)
+                for (uint64_t second = first + 1; second < bucket_end; second++) {
+
+                    const uint64_t a = entries[first].organism,
+                                   b = entries[second].organism;
+
+                    // the pair was already met in one of previous bands
+                    bool met_before = false;
+                    for (uint32_t previous = 0; previous < band; previous++)
+                        if (index->band_hashes[a * index->bands_number + previous] ==
+                            index->band_hashes[b * index->bands_number + previous]) {
+                            met_before = true;
+                            break;
+                        }
+
+                    if (met_before ||
+                        minhash_similarity(index, a, b) < threshold)
+                        continue;
+
+                    if (pairs_number < capacity) {
+                        // entries of a bucket are sorted by organism
+                        pairs[pairs_number * 2] = a;
+                        pairs[pairs_number * 2 + 1] = b;
+                    }
+                    pairs_number++;
+
+                }
+
+        }
+
+    }
+
+    return pairs_number;
+
+}
+
+void destroy_lsh_index(lsh_index_t * const index) {
+    FREE_NOT_NULL(index->signatures);
+    FREE_NOT_NULL(index->band_hashes);
+    FREE_NOT_NULL(index->entries);
+    free(index);
+}
@@ -0,0 +1,146 @@
+/*
+
+This module contains search of structurally similar genomes. Every genome is
+seen as the set of its edges (outcome node, income node), weights are
+ignored. Similarity of two genomes is the Jaccard index of their edge sets,
+which is estimated with MinHash signatures: share of equal items of two
+signatures is the unbiased estimate of the index.
+
+Signatures are split into bands, and genomes whose bands are equal fall into
+the same bucket of the LSH index (locality-sensitive hashing). Only genomes
+sharing a bucket are compared, so similar genomes are found without
+comparing all the pairs. With `b` bands of `r` rows two genomes with
+similarity `s` become candidates with probability 1 - (1 - s^r)^b.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "pool.h"
+#include "error.h"
+#include "memory.h"
+#include "pickler.h"
+#include "parallel.h"
+#include "duplicates.h"
+
+// Number of genes decoded at once while the signature is computed
+#ifndef MINHASH_CHUNK_SIZE
+#   define MINHASH_CHUNK_SIZE 1024
+#endif
+
+// Signature of the genome without genes
+#define MINHASH_EMPTY UINT64_MAX
+
+typedef struct lsh_entry_s {
+    uint64_t  band_hash;
+    uint64_t  organism;
+} lsh_entry_t;
+
+/* @typedef lsh_index_p
+ * @from_type lsh_index*
+ */
+/* @struct lsh_index
+ * @member uint32 signature_size
+ * @member uint32 bands_number
+ * @member uint32 rows_number
+ * @member uint64 organisms_number
+ * @member uint64* signatures
+ */
+typedef struct lsh_index_s {
+    uint32_t      signature_size;
+    uint32_t      bands_number;
+    // signature_size / bands_number, rest of the signature is not banded
+    uint32_t      rows_number;
+    uint64_t      organisms_number;
+    // organisms_number x signature_size
+    uint64_t     *signatures;
+    // organisms_number x bands_number
+    uint64_t     *band_hashes;
+    // bands_number x organisms_number, every band is sorted by hash
+    lsh_entry_t  *entries;
+} lsh_index_t;
+
+/* @function minhash_genome
+ * @return void
+ * @argument pool*
+ * @argument genome*
+ * @argument uint32
+ * @argument uint64*
+ */
+void minhash_genome(
+    const pool_t * const, const genome_t * const,
+    const uint32_t signature_size, uint64_t * const signature);
+
+/* @function minhash_population
+ * @return void
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint32
+ * @argument uint64*
+ * @argument uint16
+ */
+void minhash_population(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint32_t signature_size, uint64_t * const signatures,
+    const uint16_t threads_number);
+
+/* @function build_lsh_index
+ * @return lsh_index*
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint32
+ * @argument uint32
+ * @argument uint16
+ */
+lsh_index_t * build_lsh_index(
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint32_t signature_size, const uint32_t bands_number,
+    const uint16_t threads_number);
+
+/* @function minhash_similarity
+ * @return double
+ * @argument lsh_index*
+ * @argument uint64
+ * @argument uint64
+ */
+double minhash_similarity(
+    const lsh_index_t * const, const uint64_t a, const uint64_t b);
+
+/* @function lsh_query
+ * @return uint64
+ * @argument lsh_index*
+ * @argument uint64
+ * @argument uint64*
+ * @argument uint64
+ */
+uint64_t lsh_query(
+    const lsh_index_t * const, const uint64_t organism,
+    uint64_t * const candidates, const uint64_t capacity);
+
+/* @function lsh_similar_pairs
+ * @return uint64
+ * @argument lsh_index*
+ * @argument double
+ * @argument uint64*
+ * @argument uint64
+ */
+uint64_t lsh_similar_pairs(
+    const lsh_index_t * const, const double threshold,
+    uint64_t * const pairs, const uint64_t capacity);
+
+/* @function destroy_lsh_index
+ * @return void
+ * @argument lsh_index*
+ */
+void destroy_lsh_index(lsh_index_t * const);
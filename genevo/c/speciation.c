@@ -0,0 +1,786 @@
+/*
+
+This module contains speciation of the population and breeding inside species.
+
+ */
+
+#include "speciation.h"
+
+speciation_t * create_speciation(
+    const double compatibility_threshold, const uint32_t stagnation_limit
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (compatibility_threshold < 0 || compatibility_threshold > 1) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return NULL;
+    }
+
+    DECLARE_CONST_MALLOC_OBJECT(speciation_t, speciation, RETURN_NULL_ON_ERR);
+
+    speciation->compatibility_threshold = compatibility_threshold;
+    speciation->stagnation_limit = stagnation_limit;
+    speciation->species_number = 0;
+    speciation->species_capacity = 0;
+    speciation->next_species_id = 0;
+    speciation->species = NULL;
+    speciation->organisms_number = 0;
+    speciation->organisms_species = NULL;
+    speciation->members = NULL;
+    speciation->members_offsets = NULL;
+
+    return speciation;
+
+}
+
+void destroy_speciation(speciation_t * const speciation) {
+
+    for (uint32_t species_i = 0; species_i < speciation->species_number; species_i++)
+        FREE_NOT_NULL(speciation->species[species_i].representative);
+
+    FREE_NOT_NULL(speciation->species);
+    FREE_NOT_NULL(speciation->organisms_species);
+    FREE_NOT_NULL(speciation->members);
+    FREE_NOT_NULL(speciation->members_offsets);
+    free(speciation);
+
+}
+
+/*
+
+Share of different bits of two gene arrays. Genes of the longer array which
+have no pair are counted as different.
+
+ */
+double genes_compatibility_distance(
+    const pool_t * const pool,
+    const gene_byte_t * const a, const genome_length_t a_length,
+    const gene_byte_t * const b, const genome_length_t b_length
+) {
+
+    const genome_length_t common_length = a_length < b_length ? a_length : b_length;
+    const genome_length_t longer_length = a_length < b_length ? b_length : a_length;
+
+    if (longer_length == 0) return 0;
+
+    const uint64_t distance =
+        hamming_distance(a, b, (size_t)common_length * pool->gene_bytes_size) +
+        BYTES_TO_BITS(
+            (uint64_t)(longer_length - common_length) * pool->gene_bytes_size);
+
+    return (double)distance /
+        BYTES_TO_BITS((uint64_t)longer_length * pool->gene_bytes_size);
+
+}
+
+double compatibility_distance(
+    const pool_t * const pool, const genome_t * const a, const genome_t * const b
+) {
+    return genes_compatibility_distance(
+        pool, a->genes, a->length, b->genes, b->length);
+}
+
+/*
+
+Replace the representative of the species with a copy of genes of `genome`.
+
+ */
+void set_species_representative(
+    species_t * const species, const genome_t * const genome,
+    const pool_gene_byte_size_t gene_bytes_size
+) {
+
+    const size_t genes_size = (size_t)genome->length * gene_bytes_size;
+
+    gene_byte_t * const representative =
+        realloc(species->representative, genes_size + 1);
+    if (representative == NULL) RAISE_MALLOC_ERR(RETURN_VOID_ON_ERR);
+
+    memcpy(representative, genome->genes, genes_size);
+    species->representative = representative;
+    species->representative_length = genome->length;
+
+}
+
+void add_species(
+    speciation_t * const speciation, const genome_t * const genome,
+    const pool_gene_byte_size_t gene_bytes_size
+) {
+
+    if (speciation->species_number == speciation->species_capacity) {
+        const uint32_t new_capacity =
+            speciation->species_capacity ? speciation->species_capacity * 2 : 16;
+        species_t * const species = realloc(
+            speciation->species, sizeof(species_t) * new_capacity);
+        if (species == NULL) RAISE_MALLOC_ERR(RETURN_VOID_ON_ERR);
+        speciation->species = species;
+        speciation->species_capacity = new_capacity;
+    }
+
+    species_t * const species = &speciation->species[speciation->species_number];
+
+    species->id = speciation->next_species_id;
+    species->representative = NULL;
+    species->representative_length = 0;
+    species->members_number = 0;
+    species->mean_fitness = 0;
+    species->best_fitness = -INFINITY;
+    species->stagnation = 0;
+    species->offspring_number = 0;
+
+    set_species_representative(species, genome, gene_bytes_size);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    speciation->species_number++;
+    speciation->next_species_id++;
+
+}
+
+/*
+
+Index of the first species among [first_species; last_species) whose
+representative is compatible with `genome`, or SPECIES_NONE.
+
+ */
+uint32_t find_compatible_species(
+    const speciation_t * const speciation, const pool_t * const pool,
+    const genome_t * const genome,
+    const uint32_t first_species, const uint32_t last_species
+) {
+
+    for (uint32_t species_i = first_species; species_i < last_species; species_i++) {
+
+        const species_t * const species = &speciation->species[species_i];
+
+        if (genes_compatibility_distance(
+                pool, genome->genes, genome->length,
+                species->representative, species->representative_length
+            ) <= speciation->compatibility_threshold)
+            return species_i;
+
+    }
+
+    return SPECIES_NONE;
+
+}
+
+typedef struct speciation_job_s {
+    speciation_t       *speciation;
+    const pool_t       *pool;
+    genome_t * const   *genomes;
+    uint32_t            species_number;
+} speciation_job_t;
+
+void speciate_population_body(
+    void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+    const speciation_job_t * const job = job_void;
+
+    for (uint64_t genome_i = start; genome_i < end; genome_i++)
+        job->speciation->organisms_species[genome_i] = find_compatible_species(
+            job->speciation, job->pool, job->genomes[genome_i],
+            0, job->species_number);
+
+}
+
+/*
+
+Assign every organism to the first species whose representative is closer than
+the compatibility threshold. Organisms fitting none of existing species found
+new ones. Species left without members are removed, and every other species
+picks a random member as the representative for the next call.
+
+Organisms are compared with existing species in parallel, so only the
+organisms founding new species are handled by one thread.
+
+If the call fails, organisms are left without species: organisms_number is
+reset to 0, so getters return nothing until the next successful call.
+
+ */
+void speciate_population(
+    speciation_t * const speciation,
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    #define FAIL_SPECIATION { speciation->organisms_number = 0; return; }
+
+    if (organisms_number != speciation->organisms_number) {
+
+        // realloc of 0 bytes frees the array and returns NULL
+        uint32_t * const organisms_species = realloc(
+            speciation->organisms_species,
+            sizeof(uint32_t) * organisms_number);
+        if (organisms_species == NULL && organisms_number > 0)
+            RAISE_MALLOC_ERR(FAIL_SPECIATION);
+        speciation->organisms_species = organisms_species;
+
+        pool_organisms_num_t * const members = realloc(
+            speciation->members,
+            sizeof(pool_organisms_num_t) * organisms_number);
+        if (members == NULL && organisms_number > 0)
+            RAISE_MALLOC_ERR(FAIL_SPECIATION);
+        speciation->members = members;
+
+        speciation->organisms_number = organisms_number;
+
+    }
+
+    const uint32_t old_species_number = speciation->species_number;
+
+    speciation_job_t job = {
+        .speciation = speciation,
+        .pool = pool,
+        .genomes = genomes,
+        .species_number = old_species_number
+    };
+
+    parallel_for(
+        organisms_number, threads_number,
+        speciate_population_body, &job);
+
+    // only species founded by this call are left to check
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    ) {
+
+        if (speciation->organisms_species[genome_i] != SPECIES_NONE) continue;
+
+        uint32_t species_i = find_compatible_species(
+            speciation, pool, genomes[genome_i],
+            old_species_number, speciation->species_number);
+
+        if (species_i == SPECIES_NONE) {
+            species_i = speciation->species_number;
+            add_species(speciation, genomes[genome_i], pool->gene_bytes_size);
+            if (ERROR_LEVEL != ERR_OK) FAIL_SPECIATION;
+        }
+
+        speciation->organisms_species[genome_i] = species_i;
+
+    }
+
+    for (uint32_t species_i = 0; species_i < speciation->species_number; species_i++)
+        speciation->species[species_i].members_number = 0;
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    )
+        speciation->species[speciation->organisms_species[genome_i]]
+            .members_number++;
+
+    // remove extinct species, `remap` maps old indices to new ones
+    // there are no species only if there are no organisms
+    uint32_t * const remap = malloc(sizeof(uint32_t) * speciation->species_number);
+    if (remap == NULL && speciation->species_number > 0)
+        RAISE_MALLOC_ERR(FAIL_SPECIATION);
+
+    uint32_t alive_number = 0;
+    for (uint32_t species_i = 0; species_i < speciation->species_number; species_i++) {
+
+        if (speciation->species[species_i].members_number == 0) {
+            FREE_NOT_NULL(speciation->species[species_i].representative);
+            remap[species_i] = SPECIES_NONE;
+            continue;
+        }
+
+        speciation->species[alive_number] = speciation->species[species_i];
+        remap[species_i] = alive_number++;
+
+    }
+
+    speciation->species_number = alive_number;
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    )
+        speciation->organisms_species[genome_i] =
+            remap[speciation->organisms_species[genome_i]];
+
+    free(remap);
+
+    // group organisms by species
+    pool_organisms_num_t * const members_offsets = realloc(
+        speciation->members_offsets,
+        sizeof(pool_organisms_num_t) * (alive_number + 1));
+    if (members_offsets == NULL) RAISE_MALLOC_ERR(FAIL_SPECIATION);
+    speciation->members_offsets = members_offsets;
+
+    members_offsets[0] = 0;
+    for (uint32_t species_i = 0; species_i < alive_number; species_i++)
+        members_offsets[species_i + 1] =
+            members_offsets[species_i] +
+            speciation->species[species_i].members_number;
+
+    for (uint32_t species_i = 0; species_i < alive_number; species_i++)
+        speciation->species[species_i].members_number = 0;
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < organisms_number;
+        genome_i++
+    ) {
+        species_t * const species =
+            &speciation->species[speciation->organisms_species[genome_i]];
+        speciation->members[
+            members_offsets[speciation->organisms_species[genome_i]] +
+            species->members_number++] = genome_i;
+    }
+
+    ENSURE_MERSENNE_RND_SEED_IS_SET;
+
+    for (uint32_t species_i = 0; species_i < alive_number; species_i++) {
+
+        const pool_organisms_num_t member = speciation->members[
+            members_offsets[species_i] + next_mersenne_random64_in_range(
+                0, speciation->species[species_i].members_number)];
+
+        set_species_representative(
+            &speciation->species[species_i], genomes[member],
+            pool->gene_bytes_size);
+        if (ERROR_LEVEL != ERR_OK) FAIL_SPECIATION;
+
+    }
+
+    #undef FAIL_SPECIATION
+
+}
+
+/*
+
+Split `offspring_number` children between species of the last
+speciate_population call proportionally to the mean fitness of their members
+(fitness is shifted so the worst organism has zero). Species which have not
+improved their best fitness for `stagnation_limit` generations get nothing,
+unless they own the best organism. Should be called once per generation, since
+it counts stagnation.
+
+ */
+void allocate_offspring(
+    speciation_t * const speciation, const double * const fitness,
+    const pool_organisms_num_t offspring_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    const uint32_t species_number = speciation->species_number;
+
+    // speciate_population has failed or was not called yet
+    if (species_number == 0 || speciation->organisms_number == 0) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
+
+    double worst_fitness = INFINITY, best_fitness = -INFINITY;
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < speciation->organisms_number;
+        genome_i++
+    ) {
+        if (fitness[genome_i] < worst_fitness) worst_fitness = fitness[genome_i];
+        if (fitness[genome_i] > best_fitness) best_fitness = fitness[genome_i];
+    }
+
+    DECLARE_MALLOC_ARRAY(double, shares, species_number, RETURN_VOID_ON_ERR);
+
+    double shares_sum = 0;
+
+    for (uint32_t species_i = 0; species_i < species_number; species_i++) {
+
+        species_t * const species = &speciation->species[species_i];
+
+        double fitness_sum = 0, species_best = -INFINITY;
+        for (
+            pool_organisms_num_t member_i = speciation->members_offsets[species_i];
+            member_i < speciation->members_offsets[species_i + 1];
+            member_i++
+        ) {
+            const double member_fitness = fitness[speciation->members[member_i]];
+            fitness_sum += member_fitness;
+            if (member_fitness > species_best) species_best = member_fitness;
+        }
+
+        species->mean_fitness = fitness_sum / species->members_number;
+
+        if (species_best > species->best_fitness) {
+            species->best_fitness = species_best;
+            species->stagnation = 0;
+        } else species->stagnation++;
+
+        const bool stagnant =
+            speciation->stagnation_limit != 0 &&
+            species->stagnation >= speciation->stagnation_limit &&
+            species_best < best_fitness;
+
+        shares[species_i] = stagnant ? 0 : species->mean_fitness - worst_fitness;
+        shares_sum += shares[species_i];
+
+    }
+
+    // all the organisms are equally fit, so species get children by size
+    if (shares_sum == 0)
+        for (uint32_t species_i = 0; species_i < species_number; species_i++) {
+            shares[species_i] = speciation->species[species_i].members_number;
+            shares_sum += shares[species_i];
+        }
+
+    // whole quotas first, then the rest goes to the biggest remainders
+    pool_organisms_num_t allocated_number = 0;
+    for (uint32_t species_i = 0; species_i < species_number; species_i++) {
+        const double quota = shares[species_i] / shares_sum * offspring_number;
+        speciation->species[species_i].offspring_number = (pool_organisms_num_t)quota;
+        shares[species_i] = quota - floor(quota);
+        allocated_number += speciation->species[species_i].offspring_number;
+    }
+
+    while (allocated_number < offspring_number) {
+
+        uint32_t biggest_i = 0;
+        for (uint32_t species_i = 1; species_i < species_number; species_i++)
+            if (shares[species_i] > shares[biggest_i]) biggest_i = species_i;
+
+        speciation->species[biggest_i].offspring_number++;
+        shares[biggest_i] = -1;
+        allocated_number++;
+
+    }
+
+    free(shares);
+
+}
+
+typedef struct species_ranking_job_s {
+    const speciation_t  *speciation;
+    const double        *fitness;
+    ranked_genome_t     *ranking;
+} species_ranking_job_t;
+
+void rank_species_members_body(
+    void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+    const species_ranking_job_t * const job = job_void;
+    const pool_organisms_num_t * const offsets = job->speciation->members_offsets;
+
+    for (uint64_t species_i = start; species_i < end; species_i++) {
+
+        for (
+            pool_organisms_num_t member_i = offsets[species_i];
+            member_i < offsets[species_i + 1];
+            member_i++
+        ) {
+            const pool_organisms_num_t genome_i = job->speciation->members[member_i];
+            job->ranking[member_i].fitness = job->fitness[genome_i];
+            job->ranking[member_i].index = genome_i;
+        }
+
+        qsort(
+            job->ranking + offsets[species_i],
+            offsets[species_i + 1] - offsets[species_i],
+            sizeof(ranked_genome_t), compare_ranked_genomes);
+
+    }
+
+}
+
+typedef struct species_breeding_job_s {
+    const speciation_t          *speciation;
+    const pool_t                *pool;
+    genome_t * const            *genomes_parents;
+    genome_t * const            *genomes_children;
+    const ranked_genome_t       *ranking;
+    const genome_t             **survivors;
+    const pool_organisms_num_t  *children_offsets;
+    double                       survival_rate;
+    replication_type_t           replication_type;
+    blend_coefficient_t          blend_coefficient;
+    mutation_probability_t       change_genes_prob;
+    gene_mutation_mode_t         mutation_mode;
+    mutation_probability_t       flip_bits_prob;
+    uint64_t                     seed;
+} species_breeding_job_t;
+
+/*
+
+Copy genes and residue of `survivor` into every child. Children must have the
+same length and residue size as the survivor.
+
+ */
+void clone_survivor(
+    const genome_t * const survivor,
+    genome_t * const * const children,
+    const pool_organisms_num_t children_number,
+    const pool_gene_byte_size_t gene_bytes_size
+) {
+
+    const size_t residue_size = BITS_TO_BYTES(survivor->residue_size_bits);
+
+    for (
+        pool_organisms_num_t child_i = 0;
+        child_i < children_number;
+        child_i++
+    ) {
+
+        genome_t * const child = children[child_i];
+
+        if (child->length != survivor->length ||
+            child->residue_size_bits != survivor->residue_size_bits) {
+            ERROR_LEVEL = ERR_WRONG_PARAMS;
+            return;
+        }
+
+        child->flags |= GENOME_DIRTY;
+
+        memcpy(
+            child->genes, survivor->genes,
+            (size_t)survivor->length * gene_bytes_size);
+
+        if (residue_size > 0)
+            memcpy(child->residue, survivor->residue, residue_size);
+
+    }
+
+}
+
+/*
+
+Breed children of species [start; end). Species `i` writes its children from
+`children_offsets[i]` and draws its numbers from stream `i` of the seed, so the
+children do not depend on the number of threads.
+
+ */
+void breed_species_body(
+    void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+    const species_breeding_job_t * const job = job_void;
+    const speciation_t * const speciation = job->speciation;
+    const pool_gene_byte_size_t gene_bytes_size = job->pool->gene_bytes_size;
+
+    for (uint64_t species_i = start; species_i < end; species_i++) {
+
+        const species_t * const species = &speciation->species[species_i];
+        const pool_organisms_num_t children_number = species->offspring_number;
+
+        if (children_number == 0) continue;
+
+        pool_organisms_num_t survivors_number =
+            (pool_organisms_num_t)ceil(species->members_number * job->survival_rate);
+        if (survivors_number == 0) survivors_number = 1;
+
+        // survivors of a species take the place of its members
+        const genome_t ** const survivors =
+            job->survivors + speciation->members_offsets[species_i];
+
+        for (
+            pool_organisms_num_t survivor_i = 0;
+            survivor_i < survivors_number;
+            survivor_i++
+        )
+            survivors[survivor_i] = job->genomes_parents[
+                job->ranking[speciation->members_offsets[species_i] + survivor_i]
+                    .index];
+
+        genome_t * const * const children =
+            job->genomes_children + job->children_offsets[species_i];
+
+        xorshift128p_stream_t stream;
+        seed_xorshift128p_stream(&stream, job->seed, species_i);
+
+        if (survivors_number > 1)
+            crossover_genomes_combinations_from_stream(
+                survivors_number, children_number,
+                survivors_number < job->replication_type
+                    ? survivors_number : job->replication_type,
+                job->blend_coefficient, survivors, children,
+                gene_bytes_size, NULL, NULL, &stream);
+        else
+            clone_survivor(
+                survivors[0], children, children_number, gene_bytes_size);
+
+        if (ERROR_LEVEL != ERR_OK) return;
+
+        for (
+            pool_organisms_num_t child_i = 0;
+            child_i < children_number;
+            child_i++
+        )
+            mutate_child_from_stream(
+                children[child_i], gene_bytes_size,
+                job->change_genes_prob, job->mutation_mode,
+                job->flip_bits_prob, &stream);
+
+    }
+
+}
+
+/*
+
+Produce the next generation of `genomes_parents` in `genomes_children` (both of
+`organisms_number` genomes). Parents are split into species, every species gets
+its number of children (see allocate_offspring) and breeds them from its
+`survival_rate` fittest members. Species with a single survivor clone it, so
+its children should have the same length and residue size, otherwise
+ERR_WRONG_PARAMS is raised. The number of parents of a child is cut to the
+number of survivors. Children are mutated like in pairing_season.
+
+Members of species are ranked and species are bred in parallel. Every species
+draws its numbers from its own xorshift128p_stream_t, so the result depends
+only on the state of xorshift128p before the call, not on `threads_number`.
+
+ */
+void speciation_generation(
+    speciation_t * const speciation,
+    const pool_t * const pool,
+    genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_organisms_num_t organisms_number,
+    const double * const fitness,
+    const double survival_rate,
+    const replication_type_t replication_type,
+    const blend_coefficient_t blend_coefficient,
+    const mutation_probability_t change_genes_prob,
+    const gene_mutation_mode_t mutation_mode,
+    const mutation_probability_t flip_bits_prob,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (organisms_number == 0 || replication_type < 2 ||
+        survival_rate <= 0 || survival_rate > 1) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
+
+    speciate_population(
+        speciation, pool, genomes_parents, organisms_number, threads_number);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    allocate_offspring(speciation, fitness, organisms_number);
+    if (ERROR_LEVEL != ERR_OK) return;
+
+    const uint32_t species_number = speciation->species_number;
+
+    DECLARE_MALLOC_ARRAY(
+        ranked_genome_t, ranking, organisms_number, RETURN_VOID_ON_ERR);
+
+    species_ranking_job_t job = {
+        .speciation = speciation,
+        .fitness = fitness,
+        .ranking = ranking
+    };
+
+    parallel_for(
+        species_number, threads_number,
+        rank_species_members_body, &job);
+
+    DECLARE_MALLOC_LINKS_ARRAY(
+        const genome_t, survivors, organisms_number,
+        free(ranking); RETURN_VOID_ON_ERR);
+
+    // species are not empty, so there is at least one of them
+    DECLARE_MALLOC_ARRAY(
+        pool_organisms_num_t, children_offsets, species_number,
+        free(survivors); free(ranking); RETURN_VOID_ON_ERR);
+
+    children_offsets[0] = 0;
+    for (uint32_t species_i = 1; species_i < species_number; species_i++)
+        children_offsets[species_i] =
+            children_offsets[species_i - 1] +
+            speciation->species[species_i - 1].offspring_number;
+
+    #ifndef SKIP_XORSHIFT128P_RND_SEED_CHECK
+        ENSURE_XORSHIFT128P_RND_SEED_IS_SET;
+    #endif
+
+    species_breeding_job_t breeding_job = {
+        .speciation = speciation,
+        .pool = pool,
+        .genomes_parents = genomes_parents,
+        .genomes_children = genomes_children,
+        .ranking = ranking,
+        .survivors = survivors,
+        .children_offsets = children_offsets,
+        .survival_rate = survival_rate,
+        .replication_type = replication_type,
+        .blend_coefficient = blend_coefficient,
+        .change_genes_prob = change_genes_prob,
+        .mutation_mode = mutation_mode,
+        .flip_bits_prob = flip_bits_prob,
+        .seed = next_urandom64()
+    };
+
+    parallel_for(
+        species_number, threads_number,
+        breed_species_body, &breeding_job);
+
+    free(children_offsets);
+    free(survivors);
+    free(ranking);
+
+}
+
+/*
+
+Write id of the species of every organism of the last speciate_population call
+into `ids`. Organisms without species get SPECIES_NONE.
+
+ */
+void get_organisms_species(
+    const speciation_t * const speciation, species_id_t * const ids
+) {
+
+    for (
+        pool_organisms_num_t genome_i = 0;
+        genome_i < speciation->organisms_number;
+        genome_i++
+    ) {
+        const uint32_t species_i = speciation->organisms_species[genome_i];
+        ids[genome_i] = species_i != SPECIES_NONE
+            ? speciation->species[species_i].id
+            : SPECIES_NONE;
+    }
+
+}
+
+/*
+
+Write properties of every species into arrays of `species_number` items. Any
+of them may be NULL.
+
+ */
+void get_species_statistics(
+    const speciation_t * const speciation,
+    species_id_t * const ids,
+    pool_organisms_num_t * const members_numbers,
+    pool_organisms_num_t * const offspring_numbers,
+    double * const mean_fitness
+) {
+
+    for (uint32_t species_i = 0; species_i < speciation->species_number; species_i++) {
+
+        const species_t * const species = &speciation->species[species_i];
+
+        if (ids != NULL) ids[species_i] = species->id;
+        if (members_numbers != NULL)
+            members_numbers[species_i] = species->members_number;
+        if (offspring_numbers != NULL)
+            offspring_numbers[species_i] = species->offspring_number;
+        if (mean_fitness != NULL) mean_fitness[species_i] = species->mean_fitness;
+
+    }
+
+}
@@ -0,0 +1,183 @@
+/*
+
+This module contains speciation of the population. Organisms are split into
+species by the compatibility distance (share of different bits of the gene
+bytes, see diversity.h) to the representative of every species. Species and
+their representatives live across generations in speciation_t, so a driver
+just calls speciation_generation instead of pairing_season.
+
+Every species gets the number of children proportional to the mean fitness of
+its members, and children are bred only from the fittest members of the same
+species. New structures thereby compete inside their own species until they are
+tuned, instead of being outbred by the whole population at once.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "pool.h"
+#include "error.h"
+#include "memory.h"
+#include "rand.h"
+#include "mutations.h"
+#include "diversity.h"
+#include "parallel.h"
+#include "batch.h"
+
+typedef uint32_t species_id_t;
+
+// Organism is not assigned to any of the species yet
+#define SPECIES_NONE UINT32_MAX
+
+typedef struct species_s {
+    species_id_t      id;
+    // copy of the genes of one of the members of the previous generation
+    gene_byte_t      *representative;
+    genome_length_t   representative_length;
+    pool_organisms_num_t members_number;
+    double            mean_fitness;
+    double            best_fitness;
+    // generations passed since best_fitness was improved
+    uint32_t          stagnation;
+    pool_organisms_num_t offspring_number;
+} species_t;
+
+/* @typedef speciation_p
+ * @from_type speciation*
+ */
+/* @struct speciation
+ * @member double compatibility_threshold
+ * @member uint32 stagnation_limit
+ * @member uint32 species_number
+ * @member uint32 species_capacity
+ * @member uint32 next_species_id
+ * @member void* species
+ * @member uint64 organisms_number
+ * @member uint32* organisms_species
+ * @member uint64* members
+ * @member uint64* members_offsets
+ */
+typedef struct speciation_s {
+    // maximum share of different bits of the organism and the representative
+    double                 compatibility_threshold;
+    // species not improving for this number of generations get no children,
+    // 0 means no limit
+    uint32_t               stagnation_limit;
+    uint32_t               species_number;
+    uint32_t               species_capacity;
+    species_id_t           next_species_id;
+    species_t             *species;
+    pool_organisms_num_t   organisms_number;
+    // index of the species (in `species`) of every organism
+    uint32_t              *organisms_species;
+    // organisms grouped by species, species `i` owns items
+    // [members_offsets[i]; members_offsets[i + 1])
+    pool_organisms_num_t  *members;
+    pool_organisms_num_t  *members_offsets;
+} speciation_t;
+
+/* @function create_speciation
+ * @return speciation*
+ * @argument double
+ * @argument uint32
+ */
+speciation_t * create_speciation(
+    const double compatibility_threshold, const uint32_t stagnation_limit);
+
+/* @function destroy_speciation
+ * @return void
+ * @argument speciation*
+ */
+void destroy_speciation(speciation_t * const);
+
+/* @function compatibility_distance
+ * @return double
+ * @argument pool*
+ * @argument genome*
+ * @argument genome*
+ */
+double compatibility_distance(
+    const pool_t * const, const genome_t * const, const genome_t * const);
+
+/* @function speciate_population
+ * @return void
+ * @argument speciation*
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint16
+ */
+void speciate_population(
+    speciation_t * const,
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint16_t threads_number);
+
+/* @function allocate_offspring
+ * @return void
+ * @argument speciation*
+ * @argument double*
+ * @argument uint64
+ */
+void allocate_offspring(
+    speciation_t * const, const double * const fitness,
+    const pool_organisms_num_t offspring_number);
+
+/* @function speciation_generation
+ * @return void
+ * @argument speciation*
+ * @argument pool*
+ * @argument genome**
+ * @argument genome**
+ * @argument uint64
+ * @argument double*
+ * @argument double
+ * @argument uint8
+ * @argument double
+ * @argument double
+ * @argument gene_mutation_mode
+ * @argument double
+ * @argument uint16
+ */
+void speciation_generation(
+    speciation_t * const,
+    const pool_t * const,
+    genome_t * const * const genomes_parents,
+    genome_t * const * const genomes_children,
+    const pool_organisms_num_t organisms_number,
+    const double * const fitness,
+    const double survival_rate,
+    const replication_type_t, const blend_coefficient_t,
+    const mutation_probability_t change_genes_prob, const gene_mutation_mode_t,
+    const mutation_probability_t flip_bits_prob,
+    const uint16_t threads_number);
+
+/* @function get_organisms_species
+ * @return void
+ * @argument speciation*
+ * @argument uint32*
+ */
+void get_organisms_species(
+    const speciation_t * const, species_id_t * const ids);
+
+/* @function get_species_statistics
+ * @return void
+ * @argument speciation*
+ * @argument uint32*
+ * @argument uint64*
+ * @argument uint64*
+ * @argument double*
+ */
+void get_species_statistics(
+    const speciation_t * const,
+    species_id_t * const ids,
+    pool_organisms_num_t * const members_numbers,
+    pool_organisms_num_t * const offspring_numbers,
+    double * const mean_fitness);
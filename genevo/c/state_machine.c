@@ -155,8 +155,27 @@ void state_machine_uniform_distribution(state_machine_t *machine) {
 
 }
 
+static inline void machine_take_transition(
+	state_machine_t * const machine, const state_probability_t random_value
+) {
+
+	const uint32_t state_i = machine->current_state;
+	for(uint32_t state_j = 0; state_j < machine->states_number; state_j++) {
+
+		if (random_value <= machine->cdf_transitions[state_i][state_j].value) {
+			machine->prev_state = machine->current_state;
+			machine->current_state = machine->cdf_transitions[state_i][state_j].x;
+			return;
+		}
+
+	}
+
+}
+
 void machine_next_state(state_machine_t * const machine) {
 
+	PROBE_SCOPE(PROBE_MACHINE_NEXT_STATE);
+
 	#if   STATE_MACHINE_RANDOMNESS_MODE == STATE_MACHINE_XORSHIFT_RANDOM
 	state_probability_t random_value = next_double_urandom64_in_range(0, 1);
 	#elif STATE_MACHINE_RANDOMNESS_MODE == STATE_MACHINE_FAST_RANDOM
@@ -165,15 +184,21 @@ void machine_next_state(state_machine_t * const machine) {
 	state_probability_t random_value = mersenne_genrand64_real2();
 	#endif
 
-	const uint32_t state_i = machine->current_state;
-	for(uint32_t state_j = 0; state_j < machine->states_number; state_j++) {
+	machine_take_transition(machine, random_value);
 
-		if (random_value <= machine->cdf_transitions[state_i][state_j].value) {
-			machine->prev_state = machine->current_state;
-			machine->current_state = machine->cdf_transitions[state_i][state_j].x;
-			return;
-		}
+}
+
+void machine_next_state_from_stream(
+	state_machine_t * const machine, xorshift128p_stream_t * const stream
+) {
 
+	if (stream == NULL) {
+		machine_next_state(machine);
+		return;
 	}
 
+	PROBE_SCOPE(PROBE_MACHINE_NEXT_STATE);
+
+	machine_take_transition(machine, next_double_stream_random(stream));
+
 }
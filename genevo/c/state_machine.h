@@ -82,3 +82,8 @@ void state_machine_uniform_distribution(state_machine_t *);
  * @argument state_machine*
  */
 void machine_next_state(state_machine_t * const machine);
+
+// Same as machine_next_state, but the random number is drawn from `stream`.
+// NULL means the generator of STATE_MACHINE_RANDOMNESS_MODE.
+void machine_next_state_from_stream(
+    state_machine_t * const machine, xorshift128p_stream_t * const stream);
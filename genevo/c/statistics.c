@@ -0,0 +1,404 @@
+/*
+
+This module contains the collector of population statistics.
+
+ */
+
+#include "statistics.h"
+
+#define NODE_TYPE_BY_FLAGS(_FLAGS, _DIRECTION)                                 \
+    ((_FLAGS) & GENE_ ## _DIRECTION ## _IS_INPUT ? NODE_TYPE_INPUT :           \
+     (_FLAGS) & GENE_ ## _DIRECTION ## _IS_OUTPUT ? NODE_TYPE_OUTPUT :         \
+     NODE_TYPE_INTERMEDIATE)
+
+population_statistics_t * create_population_statistics(
+    const pool_t * const pool
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    DECLARE_CONST_MALLOC_OBJECT(
+        population_statistics_t, statistics, RETURN_NULL_ON_ERR);
+
+    statistics->gene_bits_size = BYTES_TO_BITS(pool->gene_bytes_size);
+    statistics->degrees_number = STATISTICS_DEGREES_NUMBER;
+
+    statistics->connection_types =
+        calloc(NODE_TYPES_NUMBER * NODE_TYPES_NUMBER, sizeof(uint64_t));
+    statistics->out_degrees =
+        calloc(STATISTICS_DEGREES_NUMBER, sizeof(uint64_t));
+    statistics->in_degrees =
+        calloc(STATISTICS_DEGREES_NUMBER, sizeof(uint64_t));
+    statistics->bit_frequencies =
+        calloc(statistics->gene_bits_size + 1, sizeof(double));
+    statistics->bit_entropies =
+        calloc(statistics->gene_bits_size + 1, sizeof(double));
+
+    if (statistics->connection_types == NULL ||
+        statistics->out_degrees == NULL ||
+        statistics->in_degrees == NULL ||
+        statistics->bit_frequencies == NULL ||
+        statistics->bit_entropies == NULL)
+        DESTROY_AND_EXIT(
+            destroy_population_statistics, statistics, RETURN_NULL_ON_ERR);
+
+    return statistics;
+
+}
+
+void destroy_population_statistics(
+    population_statistics_t * const statistics
+) {
+    FREE_NOT_NULL(statistics->connection_types);
+    FREE_NOT_NULL(statistics->out_degrees);
+    FREE_NOT_NULL(statistics->in_degrees);
+    FREE_NOT_NULL(statistics->bit_frequencies);
+    FREE_NOT_NULL(statistics->bit_entropies);
+    free(statistics);
+}
+
+/*
+
+Sums gathered by one thread. They are added to the job when the thread is
+done.
+
+ */
+typedef struct statistics_accumulator_s {
+    uint64_t         genes_number;
+    genome_length_t  length_min;
+    genome_length_t  length_max;
+    double           length_sum;
+    double           length_squares_sum;
+    double           weight_min;
+    double           weight_max;
+    double           weight_sum;
+    double           weight_squares_sum;
+    uint64_t         connection_types[NODE_TYPES_NUMBER * NODE_TYPES_NUMBER];
+    uint64_t         out_degrees[STATISTICS_DEGREES_NUMBER];
+    uint64_t         in_degrees[STATISTICS_DEGREES_NUMBER];
+    // gene_bytes_size x 256, number of genes having the value of the byte
+    uint64_t        *byte_values;
+} statistics_accumulator_t;
+
+typedef struct statistics_job_s {
+    const pool_t              *pool;
+    genome_t * const          *genomes;
+    statistics_accumulator_t   total;
+    pthread_mutex_t            lock;
+    bool                       failed;
+} statistics_job_t;
+
+void init_statistics_accumulator(statistics_accumulator_t * const accumulator) {
+
+    accumulator->genes_number = 0;
+    accumulator->length_min = UINT32_MAX;
+    accumulator->length_max = 0;
+    accumulator->length_sum = 0;
+    accumulator->length_squares_sum = 0;
+    accumulator->weight_min = INFINITY;
+    accumulator->weight_max = -INFINITY;
+    accumulator->weight_sum = 0;
+    accumulator->weight_squares_sum = 0;
+    memset(accumulator->connection_types, 0, sizeof(accumulator->connection_types));
+    memset(accumulator->out_degrees, 0, sizeof(accumulator->out_degrees));
+    memset(accumulator->in_degrees, 0, sizeof(accumulator->in_degrees));
+
+}
+
+void merge_statistics_accumulators(
+    statistics_accumulator_t * const total,
+    const statistics_accumulator_t * const part,
+    const pool_gene_byte_size_t gene_bytes_size
+) {
+
+    total->genes_number += part->genes_number;
+    if (part->length_min < total->length_min)
+        total->length_min = part->length_min;
+    if (part->length_max > total->length_max)
+        total->length_max = part->length_max;
+    total->length_sum += part->length_sum;
+    total->length_squares_sum += part->length_squares_sum;
+    if (part->weight_min < total->weight_min)
+        total->weight_min = part->weight_min;
+    if (part->weight_max > total->weight_max)
+        total->weight_max = part->weight_max;
+    total->weight_sum += part->weight_sum;
+    total->weight_squares_sum += part->weight_squares_sum;
+
+    for (uint8_t type = 0; type < NODE_TYPES_NUMBER * NODE_TYPES_NUMBER; type++)
+        total->connection_types[type] += part->connection_types[type];
+
+    for (uint32_t degree = 0; degree < STATISTICS_DEGREES_NUMBER; degree++) {
+        total->out_degrees[degree] += part->out_degrees[degree];
+        total->in_degrees[degree] += part->in_degrees[degree];
+    }
+
+    for (uint32_t value_i = 0; value_i < (uint32_t)gene_bytes_size * 256; value_i++)
+        total->byte_values[value_i] += part->byte_values[value_i];
+
+}
+
+/*
+
+Node of a genome. Ids of nodes are counted from the start of the range of
+their type, so the type is a part of the key.
+
+ */
+typedef struct node_key_s {
+    gene_node_id_t  id;
+    uint8_t         type;
+} node_key_t;
+
+int compare_node_keys(const void *a_void, const void *b_void) {
+
+    const node_key_t * const a = a_void, * const b = b_void;
+
+    if (a->type != b->type) return a->type < b->type ? -1 : 1;
+    return (a->id > b->id) - (a->id < b->id);
+
+}
+
+/*
+
+Sort `keys` and add the number of repeats of every key into `degrees`.
+
+ */
+void count_node_degrees(
+    node_key_t * const keys, const genome_length_t keys_number,
+    uint64_t * const degrees
+) {
+
+    qsort(keys, keys_number, sizeof(node_key_t), compare_node_keys);
+
+    for (genome_length_t run_start = 0, run_end; run_start < keys_number;
+         run_start = run_end) {
+
+        run_end = run_start + 1;
+        while (run_end < keys_number &&
+               keys[run_end].id == keys[run_start].id &&
+               keys[run_end].type == keys[run_start].type)
+            run_end++;
+
+        const genome_length_t degree = run_end - run_start;
+        degrees[degree < STATISTICS_DEGREES_NUMBER
+            ? degree : STATISTICS_DEGREES_NUMBER - 1]++;
+
+    }
+
+}
+
+void collect_statistics_body(
+    void * const job_void, const uint64_t start, const uint64_t end
+) {
+
+    statistics_job_t * const job = job_void;
+    const pool_t * const pool = job->pool;
+
+    gene_node_id_t outcome_node_ids[STATISTICS_CHUNK_SIZE],
+                   income_node_ids[STATISTICS_CHUNK_SIZE];
+    gene_connection_flag_t connection_types[STATISTICS_CHUNK_SIZE];
+    gene_edge_weight weights[STATISTICS_CHUNK_SIZE];
+
+    statistics_accumulator_t part;
+    init_statistics_accumulator(&part);
+    part.byte_values = calloc((size_t)pool->gene_bytes_size * 256, sizeof(uint64_t));
+
+    // nodes of the current genome, grown for the longest genome
+    genome_length_t keys_capacity = 0;
+    node_key_t *outcome_keys = NULL, *income_keys = NULL;
+
+    bool failed = part.byte_values == NULL;
+
+    for (uint64_t genome_i = start; genome_i < end && !failed; genome_i++) {
+
+        const genome_t * const genome = job->genomes[genome_i];
+
+        if (genome->length > keys_capacity) {
+            FREE_NOT_NULL(outcome_keys);
+            FREE_NOT_NULL(income_keys);
+            keys_capacity = genome->length;
+            outcome_keys = malloc(sizeof(node_key_t) * keys_capacity);
+            income_keys = malloc(sizeof(node_key_t) * keys_capacity);
+            if (outcome_keys == NULL || income_keys == NULL) {
+                failed = true;
+                break;
+            }
+        }
+
+        if (genome->length < part.length_min) part.length_min = genome->length;
+        if (genome->length > part.length_max) part.length_max = genome->length;
+        part.length_sum += genome->length;
+        part.length_squares_sum += (double)genome->length * genome->length;
+        part.genes_number += genome->length;
+
+        const gene_byte_t * const genes = genome->genes;
+        for (uint64_t byte_i = 0;
+             byte_i < (uint64_t)genome->length * pool->gene_bytes_size;
+             byte_i++)
+            part.byte_values[(byte_i % pool->gene_bytes_size) * 256 + genes[byte_i]]++;
+
+        for (
+            genome_length_t chunk_start = 0;
+            chunk_start < genome->length;
+            chunk_start += STATISTICS_CHUNK_SIZE
+        ) {
+
+            const genome_length_t chunk_size =
+                genome->length - chunk_start < STATISTICS_CHUNK_SIZE
+                    ? genome->length - chunk_start : STATISTICS_CHUNK_SIZE;
+
+            decode_genes(
+                pool,
+                genes + (size_t)chunk_start * pool->gene_bytes_size,
+                chunk_size,
+                outcome_node_ids, income_node_ids, connection_types,
+                NULL, weights);
+
+            for (genome_length_t gene_i = 0; gene_i < chunk_size; gene_i++) {
+
+                const double weight = weights[gene_i];
+                if (weight < part.weight_min) part.weight_min = weight;
+                if (weight > part.weight_max) part.weight_max = weight;
+                part.weight_sum += weight;
+                part.weight_squares_sum += weight * weight;
+
+                const uint8_t outcome_type =
+                    NODE_TYPE_BY_FLAGS(connection_types[gene_i], OUTCOME);
+                const uint8_t income_type =
+                    NODE_TYPE_BY_FLAGS(connection_types[gene_i], INCOME);
+
+                part.connection_types[
+                    outcome_type * NODE_TYPES_NUMBER + income_type]++;
+
+                outcome_keys[chunk_start + gene_i].id = outcome_node_ids[gene_i];
+                outcome_keys[chunk_start + gene_i].type = outcome_type;
+                income_keys[chunk_start + gene_i].id = income_node_ids[gene_i];
+                income_keys[chunk_start + gene_i].type = income_type;
+
+            }
+
+        }
+
+        count_node_degrees(outcome_keys, genome->length, part.out_degrees);
+        count_node_degrees(income_keys, genome->length, part.in_degrees);
+
+    }
+
+    FREE_NOT_NULL(outcome_keys);
+    FREE_NOT_NULL(income_keys);
+
+    pthread_mutex_lock(&job->lock);
+    if (failed) job->failed = true;
+    else merge_statistics_accumulators(&job->total, &part, pool->gene_bytes_size);
+    pthread_mutex_unlock(&job->lock);
+
+    FREE_NOT_NULL(part.byte_values);
+
+}
+
+/*
+
+Gather statistics of `organisms_number` genomes into `statistics` with
+`threads_number` threads (0 means the number of CPUs). Every thread sums its
+range of genomes on its own, and the sums are added together in the end, so
+threads never wait for each other while the genes are read.
+
+Degrees are counted for nodes having at least one connection in the genome.
+
+ */
+void collect_population_statistics(
+    population_statistics_t * const statistics,
+    const pool_t * const pool,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint16_t threads_number
+) {
+
+    ERROR_LEVEL = ERR_OK;
+
+    if (pool->node_id_part_bit_size > 64 || pool->weight_part_bit_size > 64 ||
+        statistics->gene_bits_size != BYTES_TO_BITS(pool->gene_bytes_size)) {
+        ERROR_LEVEL = ERR_WRONG_PARAMS;
+        return;
+    }
+
+    statistics_job_t job = {
+        .pool = pool,
+        .genomes = genomes,
+        .failed = false
+    };
+
+    init_statistics_accumulator(&job.total);
+    job.total.byte_values =
+        calloc((size_t)pool->gene_bytes_size * 256, sizeof(uint64_t));
+    if (job.total.byte_values == NULL) RAISE_MALLOC_ERR(RETURN_VOID_ON_ERR);
+
+    pthread_mutex_init(&job.lock, NULL);
+
+    parallel_for(
+        organisms_number, threads_number,
+        collect_statistics_body, &job);
+
+    pthread_mutex_destroy(&job.lock);
+
+    if (job.failed) {
+        free(job.total.byte_values);
+        RAISE_MALLOC_ERR(RETURN_VOID_ON_ERR);
+    }
+
+    const statistics_accumulator_t * const total = &job.total;
+
+    statistics->organisms_number = organisms_number;
+    statistics->genes_number = total->genes_number;
+
+    #define MEAN_AND_DEVIATION(_SUM, _SQUARES_SUM, _NUMBER, _MEAN, _DEVIATION) \
+    {                                                                          \
+        _MEAN = (_NUMBER) > 0 ? (_SUM) / (_NUMBER) : 0;                        \
+        const double _VARIANCE_ = (_NUMBER) > 0                                \
+            ? (_SQUARES_SUM) / (_NUMBER) - (_MEAN) * (_MEAN) : 0;              \
+        _DEVIATION = _VARIANCE_ > 0 ? sqrt(_VARIANCE_) : 0;                    \
+    }
+
+    statistics->length_min = organisms_number > 0 ? total->length_min : 0;
+    statistics->length_max = total->length_max;
+    MEAN_AND_DEVIATION(
+        total->length_sum, total->length_squares_sum, (double)organisms_number,
+        statistics->length_mean, statistics->length_deviation);
+
+    statistics->weight_min = total->genes_number > 0 ? total->weight_min : 0;
+    statistics->weight_max = total->genes_number > 0 ? total->weight_max : 0;
+    MEAN_AND_DEVIATION(
+        total->weight_sum, total->weight_squares_sum,
+        (double)total->genes_number,
+        statistics->weight_mean, statistics->weight_deviation);
+
+    #undef MEAN_AND_DEVIATION
+
+    memcpy(
+        statistics->connection_types, total->connection_types,
+        sizeof(total->connection_types));
+    memcpy(statistics->out_degrees, total->out_degrees, sizeof(total->out_degrees));
+    memcpy(statistics->in_degrees, total->in_degrees, sizeof(total->in_degrees));
+
+    for (uint32_t bit = 0; bit < statistics->gene_bits_size; bit++) {
+
+        const uint64_t * const values = total->byte_values + (bit / 8) * 256;
+        const uint8_t mask = 0x80 >> (bit % 8);
+
+        uint64_t ones_number = 0;
+        for (uint32_t value = 0; value < 256; value++)
+            if (value & mask) ones_number += values[value];
+
+        const double frequency = total->genes_number > 0
+            ? (double)ones_number / total->genes_number : 0;
+
+        statistics->bit_frequencies[bit] = frequency;
+        statistics->bit_entropies[bit] = binary_entropy(frequency);
+
+    }
+
+    free(job.total.byte_values);
+
+}
+
+#undef NODE_TYPE_BY_FLAGS
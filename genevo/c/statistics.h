@@ -0,0 +1,119 @@
+/*
+
+This module contains the collector of population statistics: lengths of
+genomes, weights and types of connections, degrees of nodes and frequencies of
+bits of genes. All of them are gathered in one pass over the genes by several
+threads, so monitoring of a generation doesn't need to decode the population
+in Python.
+
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include <pthread.h>
+
+#include "pool.h"
+#include "error.h"
+#include "memory.h"
+#include "pickler.h"
+#include "parallel.h"
+#include "alleles.h"
+
+// Number of genes decoded at once by every thread
+#ifndef STATISTICS_CHUNK_SIZE
+#   define STATISTICS_CHUNK_SIZE 1024
+#endif
+
+// Size of histograms of node degrees. The last item counts nodes with this or
+// bigger degree.
+#ifndef STATISTICS_DEGREES_NUMBER
+#   define STATISTICS_DEGREES_NUMBER 64
+#endif
+
+// Node types used as indices of `connection_types`
+#define NODE_TYPE_INPUT         0
+#define NODE_TYPE_INTERMEDIATE  1
+#define NODE_TYPE_OUTPUT        2
+#define NODE_TYPES_NUMBER       3
+
+/* @typedef population_statistics_p
+ * @from_type population_statistics*
+ */
+/* @struct population_statistics
+ * @member uint64 organisms_number
+ * @member uint64 genes_number
+ * @member uint32 length_min
+ * @member uint32 length_max
+ * @member double length_mean
+ * @member double length_deviation
+ * @member double weight_min
+ * @member double weight_max
+ * @member double weight_mean
+ * @member double weight_deviation
+ * @member uint64* connection_types
+ * @member uint32 degrees_number
+ * @member uint64* out_degrees
+ * @member uint64* in_degrees
+ * @member uint32 gene_bits_size
+ * @member double* bit_frequencies
+ * @member double* bit_entropies
+ */
+typedef struct population_statistics_s {
+    pool_organisms_num_t   organisms_number;
+    uint64_t               genes_number;
+    genome_length_t        length_min;
+    genome_length_t        length_max;
+    double                 length_mean;
+    double                 length_deviation;
+    double                 weight_min;
+    double                 weight_max;
+    double                 weight_mean;
+    double                 weight_deviation;
+    // NODE_TYPES_NUMBER x NODE_TYPES_NUMBER genes by types of the outcome
+    // (rows) and income (columns) nodes
+    uint64_t              *connection_types;
+    // STATISTICS_DEGREES_NUMBER, size of both histograms of degrees
+    uint32_t               degrees_number;
+    // number of nodes of all the genomes by number of their outcoming
+    // (incoming) connections
+    uint64_t              *out_degrees;
+    uint64_t              *in_degrees;
+    // gene_bits_size items, share of genes having the bit set and binary
+    // entropy of the bit (bits go from the most significant one)
+    uint32_t               gene_bits_size;
+    double                *bit_frequencies;
+    double                *bit_entropies;
+} population_statistics_t;
+
+/* @function create_population_statistics
+ * @return population_statistics*
+ * @argument pool*
+ */
+population_statistics_t * create_population_statistics(const pool_t * const);
+
+/* @function destroy_population_statistics
+ * @return void
+ * @argument population_statistics*
+ */
+void destroy_population_statistics(population_statistics_t * const);
+
+/* @function collect_population_statistics
+ * @return void
+ * @argument population_statistics*
+ * @argument pool*
+ * @argument genome**
+ * @argument uint64
+ * @argument uint16
+ */
+void collect_population_statistics(
+    population_statistics_t * const,
+    const pool_t * const,
+    genome_t * const * const genomes,
+    const pool_organisms_num_t organisms_number,
+    const uint16_t threads_number);
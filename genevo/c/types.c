@@ -2,12 +2,20 @@
 
 uint64_t ntohll(const uint64_t net) {
 
-	return ((uint64_t)ntohll(net) << 32) + ntohll(net >> 32);
+	#ifdef IS_LITTLE_ENDIAN
+	return bswap_64(net);
+	#else
+	return net;
+	#endif
 
 }
 
 uint64_t htonll(const uint64_t host) {
 
-	return ((uint64_t)htonll(host) << 32) + htonll(host >> 32);
+	#ifdef IS_LITTLE_ENDIAN
+	return bswap_64(host);
+	#else
+	return host;
+	#endif
 
 }
@@ -30,3 +30,19 @@ uint64_t htonll(const uint64_t);
     uint16_t: ntohs,                           \
     uint32_t: ntohl,                           \
     uint64_t: ntohll)(_VARIABLE)
+
+#define sizeof_member(type, member) sizeof(((type *)0)->member)
+
+#define COPY_MEMBER(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST)                     \
+    { _STRUCT_DIST -> _MEMB_NAME = _STRUCT_SRC -> _MEMB_NAME; }
+
+#define COPY_MEMBER_WITH_SWAP(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST, _DIRECTION)\
+    {                                                                          \
+        _STRUCT_DIST -> _MEMB_NAME = _DIRECTION(_STRUCT_SRC -> _MEMB_NAME);    \
+    }
+
+#define COPY_MEMBER_HTON(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST)                \
+    COPY_MEMBER_WITH_SWAP(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST, HTON)
+
+#define COPY_MEMBER_NTOH(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST)                \
+    COPY_MEMBER_WITH_SWAP(_MEMB_NAME, _STRUCT_SRC, _STRUCT_DIST, NTOH)
@@ -44,45 +44,3 @@ class _IterableContainer(metaclass=abc.ABCMeta):
         else:
             return self._iteration_function(key)
 
-
-class _LazyIterableContainer(_IterableContainer, metaclass=abc.ABCMeta):
-    """Container for iterable, which items was not computed yet.
-    """
-
-    def __init__(self):
-        super().__init__()
-        self._iter_caching_on = True
-        self._iter_cache = dict()
-
-    @property
-    def iter_caching_on(self):
-        return self._iter_caching_on
-
-    @iter_caching_on.setter
-    def iter_caching_on(self, value: bool):
-
-        if not isinstance(value, bool):
-            raise TypeError
-
-        self._iter_caching_on = value
-
-        self._iteration_function = (
-            self._get_from_cache
-            if self._iter_caching_on
-            else self._get_by_index
-        )
-
-    @abc.abstractmethod
-    def _get_by_index_cached(self, index: int):
-        pass
-
-    def _reset_iter_cache(self):
-        self._iter_cache = dict()
-
-    def _ensure_index_inited(self, index: int):
-        if index not in self._iter_cache:
-            self._iter_cache[index] = self._get_by_index_cached(index)
-
-    def _get_from_cache(self, index):
-        self._ensure_index_inited(index)
-        return self._iter_cache[index]
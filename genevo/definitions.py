@@ -10,6 +10,8 @@ c_char_p = ctypes.c_char_p
 c_uint8_p = ctypes.POINTER(c_uint8)  # equal to c_char_p
 
 
+# Functions of the library are called through ctypes, which releases the GIL
+# for the time of every call. Prefer functions of batch.py for big populations.
 libc = annotatec.Loader(
     library="genevo/c/bin/genevo.so",
     sources=[
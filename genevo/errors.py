@@ -4,6 +4,10 @@ import ctypes
 from . import definitions
 
 
+# Value of unknown members of error_context (see error.h)
+ERROR_CONTEXT_UNKNOWN = 2 ** 64 - 1
+
+
 class GenevoError(Exception):
     """Base class for all exceptions.
     """
@@ -34,13 +38,57 @@ class GeneParsingError(FileParsingError):
     pass
 
 
+class CheckpointParsingError(FileParsingError):
+    pass
+
+
+class ArchiveParsingError(FileParsingError):
+    pass
+
+
+class CompressedPoolParsingError(FileParsingError):
+    pass
+
+
+class ShardedPoolParsingError(FileParsingError):
+    pass
+
+
+class MigrationError(GenevoError):
+    pass
+
+
 def get_error_level() -> ctypes.c_uint8:
-    """Returns ERROR_LEVEL variable of the .so.
+    """Returns ERROR_LEVEL variable of the .so. It is thread-local, so the
+    status of the last call made by the current thread is returned.
 
     Returns:
         ctypes.c_uint8; Value of the ERROR_LEVEL.
     """
-    return definitions.libc.ERROR_LEVEL.value
+    return definitions.libc.get_error_level()
+
+
+def get_error_context() -> typing.Optional[typing.Dict[str, typing.Any]]:
+    """Returns the place where the last error of the current thread happened.
+
+    Returns:
+        optional dict; Items "function", "genome_index" and "byte_offset" (the
+            last two are None if unknown). None is returned if the error was
+            raised without the context.
+    """
+    context = definitions.libc.error_context()
+
+    if not definitions.libc.get_error_context(ctypes.byref(context)):
+        return None
+
+    def known(value):
+        return None if value == ERROR_CONTEXT_UNKNOWN else value
+
+    return {
+        "function": context.function.decode("utf-8"),
+        "genome_index": known(context.genome_index),
+        "byte_offset": known(context.byte_offset)
+    }
 
 
 def check_errors(raise_immediately: bool = True) -> typing.Optional[Exception]:
@@ -82,6 +130,21 @@ def check_errors(raise_immediately: bool = True) -> typing.Optional[Exception]:
     elif 0x31 <= error_level_value <= 0x3f:
         error = GeneParsingError
 
+    elif 0x51 <= error_level_value <= 0x5f:
+        error = CheckpointParsingError
+
+    elif 0x61 <= error_level_value <= 0x6f:
+        error = ArchiveParsingError
+
+    elif 0x71 <= error_level_value <= 0x7f:
+        error = CompressedPoolParsingError
+
+    elif 0x81 <= error_level_value <= 0x8f:
+        error = ShardedPoolParsingError
+
+    elif 0x91 <= error_level_value <= 0x9f:
+        error = MigrationError
+
     elif error_level_value == 0xe0:
         error = StopIteration
 
@@ -91,8 +154,18 @@ def check_errors(raise_immediately: bool = True) -> typing.Optional[Exception]:
     else:
         error = LibcError
 
-    error_instance = error(
-        definitions.libc.get_err_string(error_level).decode("utf-8"))
+    message = definitions.libc.get_err_string(error_level).decode("utf-8")
+
+    context = get_error_context()
+    if context is not None:
+        message += " (in {}{}{})".format(
+            context["function"],
+            "" if context["genome_index"] is None
+            else ", genome {}".format(context["genome_index"]),
+            "" if context["byte_offset"] is None
+            else ", byte {}".format(context["byte_offset"]))
+
+    error_instance = error(message)
 
     if raise_immediately:
         raise error_instance
@@ -0,0 +1,49 @@
+"""This module contains access to counters and timers of hot functions of the
+C library (see instrumentation.h). They are collected only if the library was
+built with `make INSTRUMENTATION=1`, otherwise all the counters are zeros.
+"""
+
+import typing
+
+from . import definitions
+
+
+def enabled() -> bool:
+    """Returns True if the library was built with the instrumentation.
+    """
+    return bool(definitions.libc.instrumentation_enabled())
+
+
+def snapshot() -> typing.Dict[str, typing.Dict[str, float]]:
+    """Returns counters of every probe gathered by all the threads since the
+    last reset.
+
+    Returns:
+        dict of dicts; Keys are names of the probed functions, values have
+            items "calls", "bytes", "random_draws", "ticks" and "seconds".
+    """
+    probes_number = definitions.libc.get_probes_number()
+    counters = (definitions.libc.probe_counters * probes_number)()
+
+    definitions.libc.snapshot_probes(counters)
+
+    ticks_per_second = (
+        definitions.libc.instrumentation_ticks_per_second()
+        if enabled() else 1)
+
+    return {
+        definitions.libc.get_probe_name(probe).decode(): {
+            "calls": counters[probe].calls,
+            "bytes": counters[probe].bytes,
+            "random_draws": counters[probe].random_draws,
+            "ticks": counters[probe].ticks,
+            "seconds": counters[probe].ticks / ticks_per_second
+        }
+        for probe in range(probes_number)
+    }
+
+
+def reset():
+    """Starts counting from zero.
+    """
+    definitions.libc.reset_probes()
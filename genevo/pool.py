@@ -3,10 +3,13 @@ import enum
 import math
 import typing
 
+import numpy
+
 from . import definitions
 from . import errors
 from . import containers
 from . import bits
+from . import arrays
 
 
 class NodeConnectionType(enum.Enum):
@@ -165,6 +168,29 @@ class Gene(_HasStructBackend):
             gene_bytes=None
         )
 
+    @classmethod
+    def from_decoded(
+        cls, pool: "GenePool", decoded: arrays.DecodedGenes
+    ) -> typing.Iterator["Gene"]:
+        """Create instances for every gene in arrays given by
+        arrays.decode_genes or Genome.iter_chunks.
+        """
+        for (
+            outcome_node_id, income_node_id, connection_type,
+            weight_unnormalized, weight
+        ) in zip(*(array.tolist() for array in decoded)):
+            yield cls(
+                pool=pool,
+                outcome_node_id=outcome_node_id,
+                outcome_node_type=NodeConnectionType(
+                    connection_type & _OUTCOME_CONNECTION_TYPE_BITMASK),
+                income_node_id=income_node_id,
+                income_node_type=NodeConnectionType(
+                    (connection_type & _INCOME_CONNECTION_TYPE_BITMASK) << 3),
+                weight_unnormalized=weight_unnormalized,
+                weight=weight
+            )
+
     @property
     def pool(self):
         return self._pool
@@ -231,7 +257,7 @@ class GenomeResidue(bits._BitField):
         )
 
 
-class Genome(containers._LazyIterableContainer, _HasStructBackend):
+class Genome(containers._IterableContainer, _HasStructBackend):
     def __init__(
         self,
         pool: "GenePool",
@@ -262,7 +288,6 @@ class Genome(containers._LazyIterableContainer, _HasStructBackend):
         self._pool = pool
 
         if genome_struct_ref:
-            self.iter_caching_on = True
             residue_size = genome_struct_ref.contents.residue_size_bits
             if residue_size == 0:
                 self._residue = None
@@ -273,7 +298,6 @@ class Genome(containers._LazyIterableContainer, _HasStructBackend):
                     copy_bytes=False
                 )
         else:
-            self.iter_caching_on = False
             self._residue = genes_residue
 
         self._genes = genes
@@ -294,10 +318,45 @@ class Genome(containers._LazyIterableContainer, _HasStructBackend):
             self._residue.to_dynamic_array()
         ))
 
-    def _get_by_index_cached(self, index: int) -> Gene:
-        struct_ref = definitions.libc.get_gene_in_genome_by_index(
-            self.struct_ref, index, self.pool.struct_ref)
-        return Gene.from_struct(pool=self.pool, struct_ref=struct_ref)
+    def iter_chunks(
+        self, chunk_capacity: int = 0
+    ) -> typing.Iterator[arrays.DecodedGenes]:
+        """Decodes genes by chunks of at most `chunk_capacity` genes (0 means
+        GENES_CURSOR_DEFAULT_CHUNK) with the native cursor.
+
+        Every chunk is a view of the same buffers of the cursor, which are
+        overwritten by the next chunk, so copy the arrays you want to keep.
+        """
+        cursor = definitions.libc.create_genes_cursor(
+            self.pool.struct_ref, self.struct_ref, chunk_capacity)
+        errors.check_errors()
+
+        try:
+            struct = cursor.contents
+            while definitions.libc.next_genes_chunk(cursor):
+                errors.check_errors()
+                shape = (struct.chunk_size, )
+                yield arrays.DecodedGenes(*(
+                    numpy.ctypeslib.as_array(buffer, shape=shape)
+                    for buffer in (
+                        struct.outcome_node_ids,
+                        struct.income_node_ids,
+                        struct.connection_types,
+                        struct.weights_unnormalized,
+                        struct.weights
+                    )
+                ))
+        finally:
+            definitions.libc.destroy_genes_cursor(cursor)
+
+    def __iter__(self) -> typing.Iterator[Gene]:
+        if not self._struct_ref:
+            return iter(self.genes)
+        return (
+            gene
+            for chunk in self.iter_chunks()
+            for gene in Gene.from_decoded(self.pool, chunk)
+        )
 
     @property
     def pool(self):
@@ -326,6 +385,20 @@ class Genome(containers._LazyIterableContainer, _HasStructBackend):
     def residue_bit_size(self):
         return self._residue.bit_length
 
+    @property
+    def genes_array(self) -> "arrays.numpy.ndarray":
+        """Read-only NumPy view of gene bytes with the shape
+        (length, gene_bytes_size). See arrays.genome_genes.
+        """
+        return arrays.genome_genes(self)
+
+    @property
+    def decoded_genes(self) -> arrays.DecodedGenes:
+        """All the genes decoded into NumPy arrays. Weights are float32 if it
+        does not lose precision (see arrays.weight_dtype).
+        """
+        return arrays.decode_genes(self.pool, self.genes_array)
+
     @classmethod
     def from_struct(
         cls,
@@ -353,7 +426,12 @@ class Genome(containers._LazyIterableContainer, _HasStructBackend):
             return None
 
     def _get_by_index(self, index: int) -> Gene:
-        return self.genes[index]
+        if not self._struct_ref:
+            return self.genes[index]
+        struct_ref = definitions.libc.get_gene_in_genome_by_index(
+            self.struct_ref, index, self.pool.struct_ref)
+        errors.check_errors()
+        return Gene.from_struct(pool=self.pool, struct_ref=struct_ref)
 
     @property
     # def genes(self) -> list[Gene]:  # For Python3.10
@@ -607,18 +685,25 @@ class GenePool(containers._IterableContainer, _HasStructBackend):
 
     @property
     def gene_bits_size(self) -> int:
-        raise NotImplementedError
+        return self._node_id_part_bit_size * 2 + self._weight_part_bit_size
 
     @property
     def gene_bytes_size(self) -> int:
-        raise NotImplementedError
+        return math.ceil(self.gene_bits_size / 8)
+
+    @property
+    def genes_array(self) -> "arrays.numpy.ndarray":
+        """Read-only NumPy view of gene bytes of all the genomes with the shape
+        (organisms_number, length, gene_bytes_size). See arrays.pool_genes.
+        """
+        return arrays.pool_genes(self)
 
     @property
     def _weight_normalization_coeff(self) -> int:
         """A coefficient, which satisfies the following condition:
         > weight_unnormalized / COEFF = weight.
         """
-        return bits._max_for_bit(self.gene_bits_size)
+        return bits._max_for_bit(self.weight_part_bit_size)
 
     def __len__(self) -> int:
         if self._struct_ref: